@@ -0,0 +1,60 @@
+#include "Arena.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+Arena::~Arena()
+{
+  for (Destructor *destructor = destructors; destructor != nullptr; destructor = destructor->next)
+  {
+    destructor->destroy(destructor->object);
+  }
+  for (char *block : blocks)
+  {
+    free(block);
+  }
+}
+
+/**
+ * Ouvre un nouveau bloc lorsque le bloc courant est plein, deux fois plus
+ * grand que le précédent (dans la limite de maxBlockSize). Un objet plus
+ * grand qu'un bloc obtient un bloc à lui, sans abandonner le bloc courant.
+ * @param size La taille demandée, en octets
+ * @param alignment L'alignement demandé
+ * @return L'adresse réservée
+ */
+void *Arena::allocateSlow(size_t size, size_t alignment)
+{
+  size_t needed = size + alignment;
+  if (needed > blockSize / 4 && cursor != nullptr)
+  {
+    char *block = static_cast<char *>(malloc(needed));
+    if (block == nullptr)
+    {
+      throw bad_alloc();
+    }
+    blocks.push_back(block);
+    reserved += needed;
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(block) + alignment - 1) & ~(alignment - 1);
+    return reinterpret_cast<void *>(aligned);
+  }
+
+  size_t length = max(blockSize, needed);
+  char *block = static_cast<char *>(malloc(length));
+  if (block == nullptr)
+  {
+    throw bad_alloc();
+  }
+  blocks.push_back(block);
+  reserved += length;
+  blockSize = min(2 * blockSize, maxBlockSize);
+  cursor = block;
+  limit = block + length;
+  return allocate(size, alignment);
+}
+
+void Arena::registerDestructor(void *object, void (*destroy)(void *))
+{
+  destructors = new (allocate(sizeof(Destructor), alignof(Destructor)))
+      Destructor{destroy, object, destructors};
+}
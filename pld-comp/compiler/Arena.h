@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// ========== Classe Arena ==========
+// Allocateur par incrément de pointeur : les objets sont placés les uns à la
+// suite des autres dans de grands blocs, et tous libérés en une fois avec
+// l'arène. Les destructeurs non triviaux sont enregistrés et exécutés (dans
+// l'ordre inverse de création) à la destruction de l'arène. La taille des
+// blocs double à chaque nouveau bloc, jusqu'à maxBlockSize : une petite
+// arène reste petite, une grande fait peu d'allocations.
+class Arena
+{
+public:
+  explicit Arena(size_t blockSize = 64 * 1024, size_t maxBlockSize = 0)
+      : blockSize(blockSize), maxBlockSize(max(blockSize, maxBlockSize)) {}
+  ~Arena();
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  // Réserve size octets alignés sur alignment (puissance de 2)
+  inline void *allocate(size_t size, size_t alignment)
+  {
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(alignment - 1);
+    if (cursor == nullptr || aligned + size > reinterpret_cast<uintptr_t>(limit))
+    {
+      return allocateSlow(size, alignment);
+    }
+    cursor = reinterpret_cast<char *>(aligned + size);
+    return reinterpret_cast<void *>(aligned);
+  }
+
+  // Construit un objet dans l'arène
+  template <class T, class... Args>
+  T *make(Args &&...args)
+  {
+    T *object = new (allocate(sizeof(T), alignof(T))) T(forward<Args>(args)...);
+    if constexpr (!is_trivially_destructible_v<T>)
+    {
+      registerDestructor(object, [](void *p) { static_cast<T *>(p)->~T(); });
+    }
+    return object;
+  }
+
+  // Copie count éléments (sans destructeur) dans l'arène
+  template <class T>
+  T *copy(const T *items, size_t count)
+  {
+    static_assert(is_trivially_copyable_v<T> && is_trivially_destructible_v<T>,
+                  "Arena::copy attend des éléments triviaux");
+    if (count == 0)
+    {
+      return nullptr;
+    }
+    T *result = static_cast<T *>(allocate(sizeof(T) * count, alignof(T)));
+    for (size_t i = 0; i < count; i++)
+    {
+      result[i] = items[i];
+    }
+    return result;
+  }
+
+  // Nombre d'octets réservés auprès du système
+  inline size_t bytesReserved() const { return reserved; }
+
+private:
+  // Destructeur à exécuter, chaîné dans l'arène elle-même
+  struct Destructor
+  {
+    void (*destroy)(void *);
+    void *object;
+    Destructor *next;
+  };
+
+  size_t blockSize;    // Taille du prochain bloc
+  size_t maxBlockSize;
+  char *cursor = nullptr; // Prochain octet libre du bloc courant
+  char *limit = nullptr;  // Fin du bloc courant
+  vector<char *> blocks;
+  Destructor *destructors = nullptr;
+  size_t reserved = 0;
+
+  void *allocateSlow(size_t size, size_t alignment);
+  void registerDestructor(void *object, void (*destroy)(void *));
+};
+
+// ========== Classe ArenaAllocator ==========
+// Allocateur standard qui réserve dans une arène (ex : allocate_shared) :
+// deallocate ne fait rien, la mémoire n'est rendue qu'avec l'arène, qui doit
+// donc survivre à tous les objets ainsi alloués
+template <class T>
+class ArenaAllocator
+{
+public:
+  typedef T value_type;
+
+  explicit ArenaAllocator(Arena &arena) : arena(&arena) {}
+  template <class U>
+  ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+  inline T *allocate(size_t count)
+  {
+    return static_cast<T *>(arena->allocate(sizeof(T) * count, alignof(T)));
+  }
+  inline void deallocate(T *, size_t) {}
+
+  template <class U>
+  inline bool operator==(const ArenaAllocator<U> &other) const { return arena == other.arena; }
+  template <class U>
+  inline bool operator!=(const ArenaAllocator<U> &other) const { return arena != other.arena; }
+
+private:
+  template <class U>
+  friend class ArenaAllocator;
+
+  Arena *arena;
+};
+
+// ========== Classe ArenaArray ==========
+// Tableau de taille fixe dont les éléments sont dans une arène
+template <class T>
+class ArenaArray
+{
+public:
+  ArenaArray() = default;
+  ArenaArray(Arena &arena, const vector<T> &items)
+      : items(arena.copy(items.data(), items.size())), count(items.size()) {}
+
+  inline T *begin() const { return items; }
+  inline T *end() const { return items + count; }
+  inline size_t size() const { return count; }
+  inline bool empty() const { return count == 0; }
+  inline T &operator[](size_t i) const { return items[i]; }
+
+private:
+  T *items = nullptr;
+  uint32_t count = 0;
+};
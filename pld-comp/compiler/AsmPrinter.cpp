@@ -0,0 +1,69 @@
+#include "AsmPrinter.h"
+
+/**
+ * Affiche une fonction complète : déclaration globale, label d'entrée,
+ * puis chaque bloc avec son label éventuel
+ * @param function La fonction machine à afficher
+ */
+void AsmPrinter::printFunction(const MachineFunction &function)
+{
+#ifdef __APPLE__
+  o << ".globl _" << function.name << "\n"; // Déclare la fonction comme globale (MacOS)
+  o << "_" << function.name << " : \n";
+#else
+  o << ".globl " << function.name << "\n"; // Déclare la fonction comme globale (Linux/Windows)
+  o << function.name << " : \n";
+#endif
+
+  for (const MachineBasicBlock &block : function.blocks)
+  {
+    if (!block.label.empty())
+    {
+      o << block.label << ":\n";
+    }
+    for (const MachineInstr &instruction : block.instructions)
+    {
+      printInstruction(instruction);
+    }
+  }
+
+#ifndef __APPLE__
+  o << ".size " << function.name << ", .-" << function.name << "\n";
+#endif
+}
+
+/**
+ * Affiche une instruction sous la forme "mnémonique op1, op2"
+ */
+void AsmPrinter::printInstruction(const MachineInstr &instruction)
+{
+  o << getMnemonic(instruction.opcode);
+  for (size_t i = 0; i < instruction.operands.size(); i++)
+  {
+    o << (i == 0 ? " " : ", ");
+    printOperand(instruction.operands[i]);
+  }
+  o << "\n";
+}
+
+/**
+ * Affiche un opérande en syntaxe AT&T
+ */
+void AsmPrinter::printOperand(const MOperand &operand)
+{
+  switch (operand.kind)
+  {
+  case MOperand::Reg:
+    o << "%" << getRegisterName(operand.reg, operand.width);
+    break;
+  case MOperand::Imm:
+    o << "$" << operand.value;
+    break;
+  case MOperand::Mem:
+    o << operand.value << "(%" << getRegisterName(operand.reg, 64) << ")";
+    break;
+  case MOperand::Label:
+    o << operand.label;
+    break;
+  }
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "AsmWriter.h"
+#include "MachineIR.h"
+
+using namespace std;
+
+// ========== Classe AsmPrinter ==========
+// Écrit le code machine d'une fonction en assembleur texte (syntaxe AT&T)
+class AsmPrinter
+{
+public:
+  explicit AsmPrinter(AsmWriter &o) : o(o) {}
+
+  void printFunction(const MachineFunction &function); // En-tête, blocs et directive .size
+  void printInstruction(const MachineInstr &instruction);
+  void printOperand(const MOperand &operand);
+
+private:
+  AsmWriter &o;
+};
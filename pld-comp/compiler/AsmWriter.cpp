@@ -0,0 +1,82 @@
+#include "AsmWriter.h"
+
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+AsmWriter &AsmWriter::operator<<(const char *text)
+{
+  buffer.insert(buffer.end(), text, text + strlen(text));
+  return *this;
+}
+
+AsmWriter &AsmWriter::operator<<(const string &text)
+{
+  buffer.insert(buffer.end(), text.begin(), text.end());
+  return *this;
+}
+
+AsmWriter &AsmWriter::operator<<(char character)
+{
+  buffer.push_back(character);
+  return *this;
+}
+
+/**
+ * Ajoute un entier en décimal, converti sans flux ni allocation
+ */
+AsmWriter &AsmWriter::operator<<(long long value)
+{
+  char digits[24];
+  char *end = to_chars(digits, digits + sizeof(digits), value).ptr;
+  buffer.insert(buffer.end(), digits, end);
+  return *this;
+}
+
+void AsmWriter::append(const AsmWriter &other)
+{
+  buffer.insert(buffer.end(), other.buffer.begin(), other.buffer.end());
+}
+
+/**
+ * Écrit le tampon sur le descripteur fd. Un seul write suffit pour un
+ * fichier ; la boucle ne sert que pour les écritures partielles (tube plein)
+ * @return false en cas d'erreur d'écriture
+ */
+bool AsmWriter::writeTo(int fd) const
+{
+  const char *position = buffer.data();
+  size_t remaining = buffer.size();
+  while (remaining > 0)
+  {
+    ssize_t written = write(fd, position, remaining);
+    if (written < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      return false;
+    }
+    position += written;
+    remaining -= written;
+  }
+  return true;
+}
+
+/**
+ * Écrit le tampon dans le fichier path, créé ou tronqué
+ * @return false si le fichier ne peut pas être ouvert ou écrit
+ */
+bool AsmWriter::writeToFile(const string &path) const
+{
+  int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+  {
+    return false;
+  }
+  bool success = writeTo(fd);
+  return close(fd) == 0 && success;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// ========== Classe AsmWriter ==========
+// Tampon d'octets extensible dans lequel le code assembleur est formaté
+// sans passer par les flux C++ ; le contenu est écrit en une seule fois
+// (un appel système write) une fois la compilation terminée
+class AsmWriter
+{
+public:
+  // capacity : taille réservée d'avance (le tampon grandit au besoin)
+  explicit AsmWriter(size_t capacity = 1 << 16) { buffer.reserve(capacity); }
+
+  // Ajout de texte ou d'entiers à la fin du tampon
+  AsmWriter &operator<<(const char *text);
+  AsmWriter &operator<<(const string &text);
+  AsmWriter &operator<<(char character);
+  AsmWriter &operator<<(long long value);
+  inline AsmWriter &operator<<(int value) { return *this << (long long)value; }
+
+  // Ajoute le contenu d'un autre tampon
+  void append(const AsmWriter &other);
+
+  inline size_t size() const { return buffer.size(); }
+  inline const char *data() const { return buffer.data(); }
+
+  // Écrit tout le tampon sur un descripteur de fichier
+  bool writeTo(int fd) const;
+  // Écrit tout le tampon dans un fichier (créé ou tronqué)
+  bool writeToFile(const string &path) const;
+
+private:
+  vector<char> buffer;
+};
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Arena.h"
+#include "StringInterner.h"
+#include "Type.h"
+
+using namespace std;
+
+// ========== Arbre syntaxique abstrait ==========
+// Représentation compacte du programme, construite directement par
+// NativeParser ou une fois depuis l'arbre d'ANTLR (AstBuilder), puis lue par
+// la génération de l'IR (CodeGenVisitor).
+// Chaque nœud porte une étiquette (kind) et des informations déjà décodées :
+// opérateurs en énumérations, types en Type, identifiants internés. Tous les
+// nœuds sont alloués dans l'arène du Program et libérés avec lui.
+
+// Position d'un nœud dans le source (celle de son premier token)
+struct SourceLocation
+{
+  uint32_t line;
+  uint32_t column; // À partir de 1
+};
+
+// ========== Expressions ==========
+
+enum class ExprKind : uint8_t
+{
+  Constant,   // Littéral entier ou caractère
+  Variable,   // Lecture d'une variable
+  Unary,      // -e, ~e, !e, +e, ++e, --e
+  Binary,     // Opérateurs binaires, y compris && et ||
+  Call,       // Appel de fonction
+  PreIncDec,  // ++x, --x
+  PostIncDec, // x++, x--
+};
+
+enum class UnaryOperator : uint8_t
+{
+  Negate,     // -
+  BitNot,     // ~
+  LogicalNot, // !
+  Plus,       // +
+  Increment,  // ++ appliqué à une expression
+  Decrement,  // -- appliqué à une expression
+};
+
+enum class BinaryOperator : uint8_t
+{
+  Mul,
+  Div,
+  Mod,
+  Add,
+  Sub,
+  Less,
+  LessEqual,
+  Greater,
+  GreaterEqual,
+  Equal,
+  NotEqual,
+  BitAnd,
+  BitXor,
+  BitOr,
+  LogicalAnd,
+  LogicalOr,
+};
+
+struct Expr
+{
+  ExprKind kind;
+  SourceLocation location;
+};
+
+struct ConstantExpr : Expr
+{
+  Type type;         // INT (littéral entier) ou CHAR (littéral caractère)
+  Identifier value;  // Valeur telle que la charge ldconst ("42", "97" pour 'a')
+};
+
+struct VariableExpr : Expr
+{
+  Identifier name;
+};
+
+struct UnaryExpr : Expr
+{
+  UnaryOperator op;
+  Expr *operand;
+};
+
+struct BinaryExpr : Expr
+{
+  BinaryOperator op;
+  Expr *left;
+  Expr *right;
+};
+
+struct CallExpr : Expr
+{
+  Identifier callee;
+  ArenaArray<Expr *> arguments;
+};
+
+// ++x, --x, x++ et x-- (selon kind)
+struct IncDecExpr : Expr
+{
+  bool increment; // ++ (sinon --)
+  Identifier name;
+};
+
+// ========== Instructions ==========
+
+enum class StmtKind : uint8_t
+{
+  Declaration, // int a, b = e;
+  Assignment,  // x = e; x += e; ...
+  If,
+  While,
+  Block,
+  Expression, // e;
+  Return,
+};
+
+enum class AssignOperator : uint8_t
+{
+  Assign, // =
+  Add,    // +=
+  Sub,    // -=
+  Mul,    // *=
+  Div,    // /=
+};
+
+struct Stmt
+{
+  StmtKind kind;
+  SourceLocation location;
+};
+
+// Variable d'une déclaration, avec son initialisation éventuelle
+struct Declarator
+{
+  Identifier name;
+  SourceLocation location;
+  Expr *initializer; // nullptr : initialisée à 0
+};
+
+struct DeclarationStmt : Stmt
+{
+  Type type;
+  ArenaArray<Declarator> variables;
+};
+
+struct AssignmentStmt : Stmt
+{
+  AssignOperator op;
+  Identifier name;
+  Expr *value;
+};
+
+struct BlockStmt : Stmt
+{
+  ArenaArray<Stmt *> statements;
+};
+
+struct IfStmt : Stmt
+{
+  Expr *condition;
+  BlockStmt *thenBlock;
+  BlockStmt *elseBlock; // nullptr sans else
+};
+
+struct WhileStmt : Stmt
+{
+  Expr *condition;
+  BlockStmt *body;
+};
+
+struct ExpressionStmt : Stmt
+{
+  Expr *expr;
+};
+
+struct ReturnStmt : Stmt
+{
+  Expr *value; // nullptr pour "return;"
+};
+
+// ========== Fonctions et programme ==========
+
+struct ParameterDecl
+{
+  Type type;
+  Identifier name;
+};
+
+struct FunctionDecl
+{
+  Type returnType;
+  Identifier name;
+  ArenaArray<ParameterDecl> parameters;
+  BlockStmt *body;
+  ArenaArray<Identifier> callees; // Fonctions appelées, sans doublon
+  SourceLocation location;
+  uint32_t lastLine;
+  // Texte de la fonction dans le source : [sourceStart, sourceEnd)
+  size_t sourceStart;
+  size_t sourceEnd;
+};
+
+// Programme complet : possède l'arène de ses nœuds et ses chaînes internées
+struct Program
+{
+  Arena arena;
+  StringInterner strings;
+  vector<FunctionDecl *> functions; // Dans l'ordre du source
+
+  inline string_view spelling(Identifier id) const { return strings.spelling(id); }
+};
@@ -0,0 +1,384 @@
+#include "AstBuilder.h"
+
+#include <algorithm>
+#include <string>
+
+using namespace antlr4;
+
+// Type désigné par un token TYPE
+static Type typeOf(tree::TerminalNode *node)
+{
+  string text = node->getText();
+  if (text == "int")
+  {
+    return Type::INT;
+  }
+  return text == "char" ? Type::CHAR : Type::VOID;
+}
+
+// Opérateur et opérandes d'une expression binaire (false si ctx n'en est pas une)
+static bool binaryOperands(ifccParser::ExprContext *ctx, BinaryOperator &op,
+                           ifccParser::ExprContext *&left, ifccParser::ExprContext *&right)
+{
+  if (auto *multdiv = dynamic_cast<ifccParser::MultdivContext *>(ctx))
+  {
+    string spelling = multdiv->op->getText();
+    op = spelling == "*"   ? BinaryOperator::Mul
+         : spelling == "/" ? BinaryOperator::Div
+                           : BinaryOperator::Mod;
+  }
+  else if (auto *addsub = dynamic_cast<ifccParser::AddsubContext *>(ctx))
+  {
+    op = addsub->op->getText() == "+" ? BinaryOperator::Add : BinaryOperator::Sub;
+  }
+  else if (auto *cmp = dynamic_cast<ifccParser::CmpContext *>(ctx))
+  {
+    string spelling = cmp->op->getText();
+    op = spelling == "<"    ? BinaryOperator::Less
+         : spelling == "<=" ? BinaryOperator::LessEqual
+         : spelling == ">"  ? BinaryOperator::Greater
+                            : BinaryOperator::GreaterEqual;
+  }
+  else if (auto *eq = dynamic_cast<ifccParser::EqContext *>(ctx))
+  {
+    op = eq->op->getText() == "==" ? BinaryOperator::Equal : BinaryOperator::NotEqual;
+  }
+  else if (dynamic_cast<ifccParser::B_andContext *>(ctx) != nullptr)
+  {
+    op = BinaryOperator::BitAnd;
+  }
+  else if (dynamic_cast<ifccParser::B_xorContext *>(ctx) != nullptr)
+  {
+    op = BinaryOperator::BitXor;
+  }
+  else if (dynamic_cast<ifccParser::B_orContext *>(ctx) != nullptr)
+  {
+    op = BinaryOperator::BitOr;
+  }
+  else if (dynamic_cast<ifccParser::LogicalAndContext *>(ctx) != nullptr)
+  {
+    op = BinaryOperator::LogicalAnd;
+  }
+  else if (dynamic_cast<ifccParser::LogicalOrContext *>(ctx) != nullptr)
+  {
+    op = BinaryOperator::LogicalOr;
+  }
+  else
+  {
+    return false;
+  }
+  // Toutes ces alternatives ont la forme expr op expr
+  left = ctx->getRuleContext<ifccParser::ExprContext>(0);
+  right = ctx->getRuleContext<ifccParser::ExprContext>(1);
+  return true;
+}
+
+// Contenu d'une expression, sans ses parenthèses englobantes
+static ifccParser::ExprContext *withoutParentheses(ifccParser::ExprContext *ctx)
+{
+  while (auto *par = dynamic_cast<ifccParser::ParContext *>(ctx))
+  {
+    ctx = par->expr();
+  }
+  return ctx;
+}
+
+/**
+ * Construit l'arbre abstrait d'un programme.
+ * @param tree L'arbre d'ANTLR, sans erreur de syntaxe
+ * @return Le programme, qui ne dépend plus de l'arbre d'ANTLR ni du source
+ */
+unique_ptr<Program> AstBuilder::build(ifccParser::AxiomContext *tree)
+{
+  auto program = make_unique<Program>();
+  AstBuilder builder(*program);
+  for (ifccParser::FuncContext *function : tree->prog()->func())
+  {
+    program->functions.push_back(builder.function(function));
+  }
+  return program;
+}
+
+// Alloue un nœud dans l'arène, à la position du premier token de ctx
+template <class Node, class Kind>
+Node *AstBuilder::create(Kind kind, ParserRuleContext *ctx)
+{
+  Node *node = program.arena.make<Node>();
+  node->kind = kind;
+  node->location = {static_cast<uint32_t>(ctx->getStart()->getLine()),
+                    static_cast<uint32_t>(ctx->getStart()->getCharPositionInLine() + 1)};
+  return node;
+}
+
+Identifier AstBuilder::identifier(tree::TerminalNode *node)
+{
+  return program.strings.intern(node->getSymbol()->getText());
+}
+
+FunctionDecl *AstBuilder::function(ifccParser::FuncContext *ctx)
+{
+  FunctionDecl *function = program.arena.make<FunctionDecl>();
+  function->returnType = typeOf(ctx->TYPE(0));
+  function->name = identifier(ctx->ID(0));
+  vector<ParameterDecl> parameters;
+  for (size_t i = 1; i < ctx->ID().size(); i++)
+  {
+    parameters.push_back({typeOf(ctx->TYPE(i)), identifier(ctx->ID(i))});
+  }
+  function->parameters = ArenaArray<ParameterDecl>(program.arena, parameters);
+
+  callees.clear();
+  function->body = block(ctx->block());
+  function->callees = ArenaArray<Identifier>(program.arena, callees);
+
+  Token *start = ctx->getStart();
+  Token *stop = ctx->getStop();
+  function->location = {static_cast<uint32_t>(start->getLine()),
+                        static_cast<uint32_t>(start->getCharPositionInLine() + 1)};
+  function->lastLine = stop->getLine();
+  function->sourceStart = start->getStartIndex();
+  function->sourceEnd = stop->getStopIndex() + 1;
+  return function;
+}
+
+BlockStmt *AstBuilder::block(ifccParser::BlockContext *ctx)
+{
+  BlockStmt *block = create<BlockStmt>(StmtKind::Block, ctx);
+  vector<Stmt *> statements;
+  for (ifccParser::StmtContext *stmt : ctx->stmt())
+  {
+    statements.push_back(statement(stmt));
+  }
+  block->statements = ArenaArray<Stmt *>(program.arena, statements);
+  return block;
+}
+
+Stmt *AstBuilder::statement(ifccParser::StmtContext *ctx)
+{
+  if (auto *declarationCtx = ctx->var_decl_stmt())
+  {
+    return declaration(declarationCtx);
+  }
+  if (auto *assignmentCtx = ctx->var_assign_stmt())
+  {
+    return assignment(assignmentCtx);
+  }
+  if (auto *ifCtx = ctx->if_stmt())
+  {
+    return ifStatement(ifCtx);
+  }
+  if (auto *whileCtx = ctx->while_stmt())
+  {
+    return whileStatement(whileCtx);
+  }
+  if (auto *blockCtx = ctx->block())
+  {
+    return block(blockCtx);
+  }
+  if (auto *returnCtx = ctx->return_stmt())
+  {
+    return returnStatement(returnCtx);
+  }
+  ExpressionStmt *statement = create<ExpressionStmt>(StmtKind::Expression, ctx);
+  statement->expr = expression(ctx->expr());
+  return statement;
+}
+
+Stmt *AstBuilder::declaration(ifccParser::Var_decl_stmtContext *ctx)
+{
+  DeclarationStmt *declaration = create<DeclarationStmt>(StmtKind::Declaration, ctx);
+  declaration->type = typeOf(ctx->TYPE());
+  vector<Declarator> variables;
+  for (ifccParser::Var_decl_memberContext *member : ctx->var_decl_member())
+  {
+    Token *start = member->getStart();
+    variables.push_back({identifier(member->ID()),
+                         {static_cast<uint32_t>(start->getLine()),
+                          static_cast<uint32_t>(start->getCharPositionInLine() + 1)},
+                         member->expr() != nullptr ? expression(member->expr()) : nullptr});
+  }
+  declaration->variables = ArenaArray<Declarator>(program.arena, variables);
+  return declaration;
+}
+
+Stmt *AstBuilder::assignment(ifccParser::Var_assign_stmtContext *ctx)
+{
+  static const struct
+  {
+    const char *spelling;
+    AssignOperator op;
+  } operators[] = {{"=", AssignOperator::Assign}, {"+=", AssignOperator::Add},
+                   {"-=", AssignOperator::Sub},   {"*=", AssignOperator::Mul},
+                   {"/=", AssignOperator::Div}};
+
+  AssignmentStmt *assignment = create<AssignmentStmt>(StmtKind::Assignment, ctx);
+  assignment->name = identifier(ctx->ID());
+  // ID, opérateur, expression, ';'
+  string spelling = ctx->children[1]->getText();
+  for (const auto &candidate : operators)
+  {
+    if (spelling == candidate.spelling)
+    {
+      assignment->op = candidate.op;
+    }
+  }
+  assignment->value = expression(ctx->expr());
+  return assignment;
+}
+
+Stmt *AstBuilder::ifStatement(ifccParser::If_stmtContext *ctx)
+{
+  IfStmt *statement = create<IfStmt>(StmtKind::If, ctx);
+  if (auto *ifElse = dynamic_cast<ifccParser::If_elseContext *>(ctx))
+  {
+    statement->condition = expression(ifElse->expr());
+    statement->thenBlock = block(ifElse->if_block);
+    statement->elseBlock = block(ifElse->else_block);
+  }
+  else
+  {
+    auto *ifOnly = static_cast<ifccParser::IfContext *>(ctx);
+    statement->condition = expression(ifOnly->expr());
+    statement->thenBlock = block(ifOnly->block());
+    statement->elseBlock = nullptr;
+  }
+  return statement;
+}
+
+Stmt *AstBuilder::whileStatement(ifccParser::While_stmtContext *ctx)
+{
+  WhileStmt *statement = create<WhileStmt>(StmtKind::While, ctx);
+  statement->condition = expression(ctx->expr());
+  statement->body = block(ctx->block());
+  return statement;
+}
+
+Stmt *AstBuilder::returnStatement(ifccParser::Return_stmtContext *ctx)
+{
+  ReturnStmt *statement = create<ReturnStmt>(StmtKind::Return, ctx);
+  statement->value = ctx->expr() != nullptr ? expression(ctx->expr()) : nullptr;
+  return statement;
+}
+
+/**
+ * Construit une expression binaire sans récursion le long de ses opérandes
+ * gauches : la grammaire associe à gauche les chaînes comme a + b + ... + z,
+ * qui peuvent compter des milliers d'opérateurs. Les nœuds sont créés en
+ * descendant la branche gauche, puis les opérandes droits sont construits en
+ * la remontant, dans l'ordre du source.
+ * @param ctx Le contexte de l'expression, dont binaryOperands reconnaît la forme
+ * @return Le nœud construit
+ */
+Expr *AstBuilder::binary(ifccParser::ExprContext *ctx)
+{
+  // Nœuds de la branche gauche, de la racine vers la feuille, et le contexte
+  // de leur opérande droit
+  vector<pair<BinaryExpr *, ifccParser::ExprContext *>> spine;
+  BinaryOperator op;
+  ifccParser::ExprContext *left, *right;
+  while (binaryOperands(ctx, op, left, right))
+  {
+    BinaryExpr *expr = create<BinaryExpr>(ExprKind::Binary, ctx);
+    expr->op = op;
+    if (!spine.empty())
+    {
+      spine.back().first->left = expr;
+    }
+    spine.push_back({expr, right});
+    ctx = withoutParentheses(left);
+  }
+  spine.back().first->left = expression(ctx);
+  for (auto it = spine.rbegin(); it != spine.rend(); ++it)
+  {
+    it->first->right = expression(it->second);
+  }
+  return spine.front().first;
+}
+
+/**
+ * Construit une expression. Les parenthèses disparaissent : seul leur
+ * contenu est conservé, l'arbre en exprimant déjà le regroupement.
+ * @param ctx Le contexte de l'expression dans l'arbre d'ANTLR
+ * @return Le nœud construit
+ */
+Expr *AstBuilder::expression(ifccParser::ExprContext *ctx)
+{
+  if (auto *val = dynamic_cast<ifccParser::ValContext *>(ctx))
+  {
+    if (val->ID() != nullptr)
+    {
+      VariableExpr *expr = create<VariableExpr>(ExprKind::Variable, ctx);
+      expr->name = identifier(val->ID());
+      return expr;
+    }
+    ConstantExpr *expr = create<ConstantExpr>(ExprKind::Constant, ctx);
+    if (val->INTEGER_LITERAL() != nullptr)
+    {
+      expr->type = Type::INT;
+      expr->value = identifier(val->INTEGER_LITERAL());
+    }
+    else
+    {
+      // Code du caractère entre les apostrophes
+      expr->type = Type::CHAR;
+      string text = val->CHAR_LITERAL()->getText();
+      expr->value = program.strings.intern(to_string(static_cast<int>(text[1])));
+    }
+    return expr;
+  }
+  if (auto *par = dynamic_cast<ifccParser::ParContext *>(ctx))
+  {
+    return expression(withoutParentheses(par));
+  }
+  BinaryOperator op;
+  ifccParser::ExprContext *left, *right;
+  if (binaryOperands(ctx, op, left, right))
+  {
+    return binary(ctx);
+  }
+  if (auto *call = dynamic_cast<ifccParser::Func_callContext *>(ctx))
+  {
+    CallExpr *expr = create<CallExpr>(ExprKind::Call, ctx);
+    expr->callee = identifier(call->ID());
+    if (find(callees.begin(), callees.end(), expr->callee) == callees.end())
+    {
+      callees.push_back(expr->callee);
+    }
+    vector<Expr *> arguments;
+    for (ifccParser::ExprContext *argument : call->expr())
+    {
+      arguments.push_back(expression(argument));
+    }
+    expr->arguments = ArenaArray<Expr *>(program.arena, arguments);
+    return expr;
+  }
+  if (auto *unary = dynamic_cast<ifccParser::UnaryOpContext *>(ctx))
+  {
+    static const struct
+    {
+      const char *spelling;
+      UnaryOperator op;
+    } operators[] = {{"-", UnaryOperator::Negate},     {"~", UnaryOperator::BitNot},
+                     {"!", UnaryOperator::LogicalNot}, {"+", UnaryOperator::Plus},
+                     {"++", UnaryOperator::Increment}, {"--", UnaryOperator::Decrement}};
+    UnaryExpr *expr = create<UnaryExpr>(ExprKind::Unary, ctx);
+    string spelling = unary->op->getText();
+    for (const auto &candidate : operators)
+    {
+      if (spelling == candidate.spelling)
+      {
+        expr->op = candidate.op;
+      }
+    }
+    expr->operand = expression(unary->expr());
+    return expr;
+  }
+
+  // ++x / --x : opérateur puis ID ; x++ / x-- : ID puis opérateur
+  bool prefix = dynamic_cast<ifccParser::PreIncDecContext *>(ctx) != nullptr;
+  IncDecExpr *expr = create<IncDecExpr>(prefix ? ExprKind::PreIncDec : ExprKind::PostIncDec, ctx);
+  expr->increment = ctx->children[prefix ? 0 : 1]->getText() == "++";
+  expr->name = identifier(prefix ? static_cast<ifccParser::PreIncDecContext *>(ctx)->ID()
+                                 : static_cast<ifccParser::PostIncDecContext *>(ctx)->ID());
+  return expr;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "antlr4-runtime.h"
+#include "generated/ifccParser.h"
+#include "Ast.h"
+
+using namespace std;
+
+// ========== Classe AstBuilder ==========
+// Construit l'arbre abstrait (Ast.h) en un seul parcours de l'arbre d'ANTLR :
+// le texte des tokens n'est lu qu'ici (types, opérateurs, identifiants), et
+// l'arbre d'ANTLR peut être libéré dès la construction terminée
+class AstBuilder
+{
+public:
+  // Construit le programme d'un arbre syntaxiquement correct
+  static unique_ptr<Program> build(ifccParser::AxiomContext *tree);
+
+private:
+  explicit AstBuilder(Program &program) : program(program) {}
+
+  Program &program;
+  vector<Identifier> callees; // Fonctions appelées par la fonction en cours
+
+  template <class Node, class Kind>
+  Node *create(Kind kind, antlr4::ParserRuleContext *ctx);
+  Identifier identifier(antlr4::tree::TerminalNode *node);
+
+  FunctionDecl *function(ifccParser::FuncContext *ctx);
+  BlockStmt *block(ifccParser::BlockContext *ctx);
+  Stmt *statement(ifccParser::StmtContext *ctx);
+  Stmt *declaration(ifccParser::Var_decl_stmtContext *ctx);
+  Stmt *assignment(ifccParser::Var_assign_stmtContext *ctx);
+  Stmt *ifStatement(ifccParser::If_stmtContext *ctx);
+  Stmt *whileStatement(ifccParser::While_stmtContext *ctx);
+  Stmt *returnStatement(ifccParser::Return_stmtContext *ctx);
+  Expr *expression(ifccParser::ExprContext *ctx);
+  Expr *binary(ifccParser::ExprContext *ctx);
+};
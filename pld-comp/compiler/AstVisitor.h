@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Ast.h"
+
+// ========== Classe AstVisitor ==========
+// Parcours de l'arbre abstrait à répartition statique (CRTP) : la classe
+// dérivée Derived définit une méthode visitXxx par nature de nœud, que
+// visitExpression et visitStatement appellent directement selon l'étiquette
+// du nœud. Chaque visite retourne son résultat avec son vrai type
+// (ExprResult pour les expressions, StmtResult pour les instructions), sans
+// appel virtuel ni boîte de type antlrcpp::Any.
+template <class Derived, class ExprResult, class StmtResult = void>
+class AstVisitor
+{
+public:
+  ExprResult visitExpression(const Expr *expr)
+  {
+    switch (expr->kind)
+    {
+    case ExprKind::Constant:
+      return derived().visitConstant(static_cast<const ConstantExpr *>(expr));
+    case ExprKind::Variable:
+      return derived().visitVariable(static_cast<const VariableExpr *>(expr));
+    case ExprKind::Unary:
+      return derived().visitUnary(static_cast<const UnaryExpr *>(expr));
+    case ExprKind::Binary:
+      return derived().visitBinary(static_cast<const BinaryExpr *>(expr));
+    case ExprKind::Call:
+      return derived().visitCall(static_cast<const CallExpr *>(expr));
+    case ExprKind::PreIncDec:
+      return derived().visitPreIncDec(static_cast<const IncDecExpr *>(expr));
+    case ExprKind::PostIncDec:
+      return derived().visitPostIncDec(static_cast<const IncDecExpr *>(expr));
+    }
+    return ExprResult();
+  }
+
+  StmtResult visitStatement(const Stmt *stmt)
+  {
+    switch (stmt->kind)
+    {
+    case StmtKind::Declaration:
+      return derived().visitDeclaration(static_cast<const DeclarationStmt *>(stmt));
+    case StmtKind::Assignment:
+      return derived().visitAssignment(static_cast<const AssignmentStmt *>(stmt));
+    case StmtKind::If:
+      return derived().visitIf(static_cast<const IfStmt *>(stmt));
+    case StmtKind::While:
+      return derived().visitWhile(static_cast<const WhileStmt *>(stmt));
+    case StmtKind::Block:
+      return derived().visitBlock(static_cast<const BlockStmt *>(stmt));
+    case StmtKind::Expression:
+      return derived().visitExpressionStatement(static_cast<const ExpressionStmt *>(stmt));
+    case StmtKind::Return:
+      return derived().visitReturn(static_cast<const ReturnStmt *>(stmt));
+    }
+    return StmtResult();
+  }
+
+private:
+  inline Derived &derived() { return static_cast<Derived &>(*this); }
+};
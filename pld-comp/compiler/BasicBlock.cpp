@@ -19,39 +19,36 @@ BasicBlock::BasicBlock(CFG *cfg, string entry_label)
       exit_false(nullptr), visited(false) {}
 
 /**
- * Génère le code assembleur pour tout le bloc
- * @param o Le flux de sortie pour écrire le code
+ * Sélectionne les instructions machine pour tout le bloc, puis pour ses successeurs
+ * @param function La fonction machine dans laquelle ajouter le bloc
  */
-void BasicBlock::gen_asm(ostream &o)
+void BasicBlock::gen_asm(MachineFunction &function)
 {
   if (visited)
   {
     return; // Évite les boucles infinies
   }
   visited = true;
-  if (!label.empty())
+  MachineBasicBlock &mbb = function.addBlock(label); // Bloc machine portant le label du bloc
+  for (IRInstr *instruction : instructions)
   {
-    cout << label << ":\n"; // Affiche le label du bloc
-  }
-  for (auto &instruction : instructions)
-  {
-    instruction.genAsm(o, cfg); // Génère le code pour chaque instruction
+    instruction->selectInstructions(mbb, cfg); // Sélectionne les instructions de chaque instruction IR
   }
   if (exit_false != nullptr)
   {
-    o << "je " << exit_false->label << "\n"; // Saut conditionnel
+    mbb.emit(MOpcode::je, {MOperand::createLabel(exit_false->label)}); // Saut conditionnel
   }
   if (exit_true != nullptr && !exit_true->label.empty())
   {
-    o << "jmp " << exit_true->label << "\n"; // Saut inconditionnel
+    mbb.emit(MOpcode::jmp, {MOperand::createLabel(exit_true->label)}); // Saut inconditionnel
   }
   if (exit_true != nullptr)
   {
-    exit_true->gen_asm(o); // Génère le code pour le bloc suivant
+    exit_true->gen_asm(function); // Génère le code pour le bloc suivant
   }
   if (exit_false != nullptr)
   {
-    exit_false->gen_asm(o); // Génère le code pour le bloc suivant
+    exit_false->gen_asm(function); // Génère le code pour le bloc suivant
   }
 }
 
@@ -59,11 +56,12 @@ void BasicBlock::gen_asm(ostream &o)
  * Ajoute une instruction IR au bloc
  * @param operation L'opération à effectuer
  * @param type Le type de retour
- * @param parameters Les paramètres de l'instruction
+ * @param parameters Les paramètres de l'instruction (une opération binaire
+ *                   peut recevoir sa destination en troisième paramètre)
  * @return Le symbole résultat pour les instructions qui en produisent un
  */
 shared_ptr<Symbol> BasicBlock::add_IRInstr(IRInstr::Operation operation, Type type,
-                                                vector<Parameter> parameters)
+                                           ParameterList parameters)
 {
   switch (operation)
   {
@@ -75,6 +73,14 @@ shared_ptr<Symbol> BasicBlock::add_IRInstr(IRInstr::Operation operation, Type ty
   case IRInstr::b_and:
   case IRInstr::b_or:
   case IRInstr::b_xor:
+    if (parameters.size() == 3)
+    {
+      // Destination fournie par l'appelant (affectation composée x op= e)
+      shared_ptr<Symbol> destination = get<shared_ptr<Symbol>>(parameters[2]);
+      append(operation, type, move(parameters)); // Ajoute l'instruction au bloc
+      return destination; // Retourne la destination
+    }
+    [[fallthrough]];
   case IRInstr::lt:
   case IRInstr::leq:
   case IRInstr::gt:
@@ -89,7 +95,7 @@ shared_ptr<Symbol> BasicBlock::add_IRInstr(IRInstr::Operation operation, Type ty
   {
     shared_ptr<Symbol> symbole = cfg->create_new_tempvar(type); // Crée une variable temporaire
     parameters.push_back(symbole); // Ajoute la variable temporaire aux paramètres
-    instructions.emplace_back(this, operation, type, parameters); // Ajoute l'instruction au bloc
+    append(operation, type, move(parameters)); // Ajoute l'instruction au bloc
     return symbole; // Retourne la variable temporaire
     break;
   }
@@ -99,12 +105,12 @@ shared_ptr<Symbol> BasicBlock::add_IRInstr(IRInstr::Operation operation, Type ty
     {
       shared_ptr<Symbol> symbole = cfg->create_new_tempvar(type); // Crée une variable temporaire
       parameters.push_back(symbole); // Ajoute la variable temporaire aux paramètres
-      instructions.emplace_back(this, operation, type, parameters); // Ajoute l'instruction au bloc
+      append(operation, type, move(parameters)); // Ajoute l'instruction au bloc
       return symbole; // Retourne la variable temporaire
     }
     else
     {
-      instructions.emplace_back(this, operation, type, parameters); // Ajoute l'instruction au bloc
+      append(operation, type, move(parameters)); // Ajoute l'instruction au bloc
     }
     break;
   }
@@ -112,18 +118,23 @@ shared_ptr<Symbol> BasicBlock::add_IRInstr(IRInstr::Operation operation, Type ty
   case IRInstr::param:
   case IRInstr::var_assign:
   {
-    instructions.emplace_back(this, operation, type, parameters); // Ajoute l'instruction au bloc
+    append(operation, type, move(parameters)); // Ajoute l'instruction au bloc
     break;
   }
   case IRInstr::inc:
   case IRInstr::dec:
-    instructions.emplace_back(this, operation, type, parameters); // Ajoute l'instruction au bloc
-    return get<shared_ptr<Symbol>>(parameters[0]); // Retourne la variable modifiée
-    break;
+  {
+    shared_ptr<Symbol> variable = get<shared_ptr<Symbol>>(parameters[0]);
+    append(operation, type, move(parameters)); // Ajoute l'instruction au bloc
+    return variable; // Retourne la variable modifiée
+  }
 
   case IRInstr::param_decl:
-    instructions.emplace_back(this, operation, type, parameters); // Ajoute l'instruction au bloc
-    return get<shared_ptr<Symbol>>(parameters[0]); // Retourne la variable déclarée
+  {
+    shared_ptr<Symbol> variable = get<shared_ptr<Symbol>>(parameters[0]);
+    append(operation, type, move(parameters)); // Ajoute l'instruction au bloc
+    return variable; // Retourne la variable déclarée
+  }
   case IRInstr::ldvar:
     return get<shared_ptr<Symbol>>(parameters[0]); // Retourne la variable chargée
     break;
@@ -134,3 +145,8 @@ shared_ptr<Symbol> BasicBlock::add_IRInstr(IRInstr::Operation operation, Type ty
   return nullptr; // Retourne nullptr si aucune variable n'est produite
 }
 
+// Construit l'instruction dans l'arène du CFG et l'ajoute à la fin du bloc
+void BasicBlock::append(IRInstr::Operation operation, Type type, ParameterList parameters)
+{
+  instructions.push_back(cfg->get_arena().make<IRInstr>(this, operation, type, move(parameters)));
+}
@@ -6,6 +6,7 @@
 #include <string>       
 #include <ostream>      
 #include "IR.h"         
+#include "MachineIR.h"
 #include "Symbol.h"    
 #include "CFG.h"    
 
@@ -15,18 +16,21 @@ class BasicBlock
 {
 public:
   BasicBlock(CFG *cfg, string entry_label);
-  void gen_asm(ostream &o); // Génère l'assembleur du bloc
+  void gen_asm(MachineFunction &function); // Sélectionne les instructions du bloc et de ses successeurs
 
   shared_ptr<Symbol> add_IRInstr(IRInstr::Operation operation, Type type,
-                                      vector<Parameter> parameters);
+                                 ParameterList parameters);
 
   BasicBlock *exit_true;       // Bloc suivant si condition vraie
   BasicBlock *exit_false;      // Bloc suivant si condition fausse (sinon jump inconditionnel)
   bool visited;                // Indique si ce bloc a déjà été généré (utile pour éviter les doublons)
   string label;           // Label du bloc (nom unique)
   CFG *cfg;                    // CFG auquel appartient ce bloc
-  vector<IRInstr> instructions; // Liste des instructions IR dans ce bloc
+  vector<IRInstr *> instructions; // Instructions IR du bloc, allouées dans l'arène du CFG
   string test_var_name;   // Nom de la variable de test (pour if / while, etc.)
+
+private:
+  void append(IRInstr::Operation operation, Type type, ParameterList parameters);
 }; 
 
 #endif
@@ -4,6 +4,8 @@
 #include "Symbol.h"
 #include "Type.h"
 #include "ErrorListenerVisitor.h"
+#include "AsmPrinter.h"
+#include "ParallelMove.h"
 
 #include <iostream>
 #include <memory>
@@ -23,246 +25,234 @@
  * @param type Type de retour de la fonction
  * @param name Nom de la fonction
  * @param argCount Nombre d'arguments
- * @param visitor Le visiteur de génération de code associé
  */
-CFG::CFG(Type type, const string &name, int argCount,
-    CodeGenVisitor *visitor)
- : nextFreeSymbolIndex(1 + 4 * max(0, argCount - 6)), name(name),
-   returnType(type), visitor(visitor)
+CFG::CFG(Type type, const string &name, int argCount)
+ : arena(1024, 64 * 1024), nextFreeSymbolIndex(1 + 4 * max(0, argCount - 6)), nextBBnumber(1),
+   name(name), returnType(type)
 {
- add_bb(new BasicBlock(this, "")); // Ajoute un bloc de base initial
+ add_bb(create_bb("")); // Ajoute un bloc de base initial
  push_table(); // Crée une nouvelle table de symboles pour la portée
 }
 
 CFG::~CFG()
 {
  // Vide toutes les tables de symboles
- while (!symbolTables.empty())
+ while (!symbolTable.empty())
  {
  pop_table();
  }
- // Libère la mémoire des blocs de base
- for (auto bb : bbs)
- {
- delete bb;
- }
+ // Les blocs, instructions et symboles sont libérés avec l'arène
 }
 
 /**
-* Ajoute un bloc de base au CFG
-* Le bloc devient le bloc courant
+* Crée un bloc de base dans l'arène de la fonction ; il n'appartient au CFG
+* qu'une fois ajouté par add_bb
+* @param label Le label assembleur du bloc ("" si aucun saut n'y mène)
 */
-void CFG::add_bb(BasicBlock *bb)
+BasicBlock *CFG::create_bb(const string &label)
 {
- bbs.push_back(bb); // Ajoute le bloc à la liste des blocs
- current_bb = bb; // Définit le bloc courant
+ return arena.make<BasicBlock>(this, label);
 }
 
 /**
-* Convertit un registre IR en nom de registre assembleur
-* @param reg Le nom du registre IR (ex: "reg1")
-* @return Le nom du registre assembleur correspondant (ex: "%eax")
+* Ajoute un bloc de base au CFG
+* Le bloc devient le bloc courant
 */
-string CFG::IR_reg_to_asm(string reg) 
+void CFG::add_bb(BasicBlock *bb)
 {
- // Vérifie si c'est un registre 32 bits
- if (reg.find("reg") != string::npos) {
-   int regNum = stoi(reg.substr(3));
-   if (regNum >= 0 && regNum < 8) {
-     return "%" + registers32[regNum];
-   }
- }
- // Si ce n'est pas un registre connu, retourne le nom tel quel
- return reg;
+ bbs.push_back(bb); // Ajoute le bloc à la liste des blocs
+ current_bb = bb; // Définit le bloc courant
 }
 
 /**
-* Génère le prologue de la fonction (entête, sauvegarde base de pile, etc)
+* Génère le prologue de la fonction (sauvegarde base de pile, récupération des paramètres)
+* L'en-tête (.globl et label) est produit par l'AsmPrinter
 */
-void CFG::gen_asm_prologue(ostream &o)
+void CFG::gen_asm_prologue(MachineBasicBlock &mbb)
 {
-#ifdef __APPLE__
- o << ".globl _" << name << "\n"; // Déclare la fonction comme globale (MacOS)
- o << "_" << name << " : \n";
-#else
- o << ".globl " << name << "\n"; // Déclare la fonction comme globale (Linux/Windows)
- o << name << " : \n";
-#endif
- o << "pushq %rbp\n"; // Sauvegarde la base de pile
- o << "movq %rsp, %rbp\n"; // Initialise la nouvelle base de pile
-
- bool isSwapped = false;
- // Gestion des paramètres si plus de 6
- if (parameterTypes.size() >= 6)
- {
- int parameterRegister1 = getRegisterIndexForSymbol(parameterTypes[4].symbole);
- int parameterRegister2 = getRegisterIndexForSymbol(parameterTypes[4].symbole);
- if (parameterRegister1 == 5 && parameterRegister2 == 4)
- {
-   o << "xchg %r8d, %r9d" << endl; // Échange les registres si nécessaire
- }
- }
-
- // Charge les paramètres dans les registres ou la pile
- for (int i = 4; !isSwapped && i < min((int)parameterTypes.size(), 6);
-    i++)
+ MOperand rbp = MOperand::createReg(PhysReg::RBP, 64);
+ mbb.emit(MOpcode::pushq, {rbp}); // Sauvegarde la base de pile
+ mbb.emit(MOpcode::movq, {MOperand::createReg(PhysReg::RSP, 64), rbp}); // Initialise la nouvelle base de pile
+
+ // Place les paramètres dans leurs registres alloués (ou leur case de pile
+ // s'ils sont déchargés) : les six premiers arrivent dans les registres de
+ // l'ABI, les suivants au-dessus de l'adresse de retour
+ ParallelMove parameterMoves;
+ for (int i = 0; i < parameterTypes.size(); i++)
  {
  auto parameter = parameterTypes[i];
  int parameterRegister = getRegisterIndexForSymbol(parameter.symbole);
- o << "movl %" << paramRegisters[i] << ", %"
-   << registers32[parameterRegister] << endl;
+ MOperand source = i < 6 ? MOperand::createReg(paramPhysRegs[i])
+                         : MOperand::createMem(PhysReg::RBP, 16 + 8 * (i - 6));
  if (parameterRegister == scratchRegister)
  {
-   o << "movl %" << registers32[parameterRegister] << ", -"
-   << parameter.symbole->offset << "(%rbp)" << endl;
- }
+   parameterMoves.add(source, MOperand::createMem(PhysReg::RBP, -parameter.symbole->offset),
+                      parameter.type == Type::CHAR ? 8 : 32);
  }
- for (int i = 0; i < parameterTypes.size(); i++)
- {
- if (i == 4 || i == 5)
+ else
  {
-   continue;
+   parameterMoves.add(source, MOperand::createReg(allocatableRegister(parameterRegister)));
  }
- auto parameter = parameterTypes[i];
- int parameterRegister = getRegisterIndexForSymbol(parameter.symbole);
- if (i < 6)
- {
-   o << "movl %" << paramRegisters[i] << ", %"
-   << registers32[parameterRegister] << endl;
  }
- else
+ parameterMoves.emit(mbb, allocatableRegister(scratchRegister));
+}
+
+/**
+* Génère le code assembleur pour toute la fonction
+* Effectue d'abord l'allocation de registres, sélectionne les instructions
+* machine, les optimise avec l'optimiseur à lucarne puis les affiche
+* @param o Le tampon recevant le code assembleur
+* @param dumpAfter La passe après laquelle afficher l'IR (IRPass::None : aucune)
+* @param irDump Le tampon recevant l'IR affiché
+*/
+void CFG::gen_asm(AsmWriter &o, IRPass dumpAfter, AsmWriter *irDump)
+{
+ if (dumpAfter == IRPass::Lower)
  {
-   o << "movl " << 8 * (i - 4) << "(%rbp)"
-   << ", %" << registers32[parameterRegister] << endl;
+ IRPrinter(*irDump).printFunction(*this, false);
  }
- if (parameterRegister == scratchRegister)
+ performRegisterAllocation(); // Effectue l'allocation des registres
+ if (dumpAfter == IRPass::Regalloc)
  {
-   o << "movl %" << registers32[parameterRegister] << ", -"
-   << parameter.symbole->offset << "(%rbp)" << endl;
- }
+ IRPrinter(*irDump).printFunction(*this, true);
  }
+ MachineFunction function(name);
+ gen_machine_function(function); // Sélectionne les instructions machine
+ PeepholeOptimizer(peepholeStats).run(function); // Simplifie le code après allocation
+ AsmPrinter(o).printFunction(function); // Affiche le code assembleur
 }
 
 /**
-* Génère le code assembleur pour toute la fonction
-* Effectue d'abord l'allocation de registres puis génère le code
+* Sélectionne les instructions machine de la fonction : prologue, blocs de base
+* dans l'ordre de parcours, puis épilogue
+* @param function La fonction machine à remplir
 */
-void CFG::gen_asm(ostream &o)
+void CFG::gen_machine_function(MachineFunction &function)
 {
- performRegisterAllocation(); // Effectue l'allocation des registres
- gen_asm_prologue(o); // Génère le prologue
- bbs[0]->gen_asm(o); // Génère le code des blocs de base
- gen_asm_epilogue(o); // Génère l'épilogue
+ gen_asm_prologue(function.addBlock("")); // Génère le prologue
+ bbs[0]->gen_asm(function); // Génère le code des blocs de base
+ gen_asm_epilogue(function.addBlock("")); // Génère l'épilogue
 }
 
 /**
 * Génère l'épilogue de la fonction (nettoyage de pile et retour)
-* @param o Le flux de sortie pour écrire le code assembleur
+* @param mbb Le bloc machine dans lequel ajouter les instructions
 */
-void CFG::gen_asm_epilogue(ostream &o)
+void CFG::gen_asm_epilogue(MachineBasicBlock &mbb)
 {
  // Restaure la base de pile
- o << "popq %rbp\n";
- 
+ mbb.emit(MOpcode::popq, {MOperand::createReg(PhysReg::RBP, 64)});
+
  // Retourne de la fonction
- o << "ret\n";
- 
- // Aligne la pile si nécessaire (pour les appels système)
- if (nextFreeSymbolIndex > 0) {
-   int stackSize = ((nextFreeSymbolIndex + 15) / 16) * 16;
-   o << ".size " << name << ", .-" << name << "\n";
- }
+ mbb.emit(MOpcode::ret);
+}
+
+/**
+* Génère un label de bloc. Les labels sont numérotés par fonction et
+* préfixés par son nom : le code d'une fonction ne dépend pas des autres,
+* ce qui permet de le réutiliser tel quel (compilation incrémentale)
+* @return Le label, par exemple ".Lmain_1"
+*/
+string CFG::new_BB_name()
+{
+ return ".L" + name + "_" + to_string(nextBBnumber++);
 }
 
 /**
 * Pop une  table de symboles pour la portée courante
+* Les variables jamais utilisées sont signalées par ordre alphabétique
 */
 void CFG::pop_table()
 {
- for (auto it = symbolTables.front().begin(); it != symbolTables.front().end();
-    it++)
+ vector<shared_ptr<Symbol>> unused;
+ for (shared_ptr<Symbol> &symbole : symbolTable.popScope())
  {
- if (!it->second->used)
+ if (!symbole->used)
  {
-   ErrorListenerVisitor::addError("Variable " + it->first +
-                    " not used (declared in line " +
-                    to_string(it->second->line) + ")",
-                  ErrorType::Warning);
+   unused.push_back(move(symbole));
  }
  }
- symbolTables.pop_front(); // Supprime la table de symboles courante
+ sort(unused.begin(), unused.end(),
+   [](const shared_ptr<Symbol> &a, const shared_ptr<Symbol> &b)
+   { return a->identifierName < b->identifierName; });
+ for (const shared_ptr<Symbol> &symbole : unused)
+ {
+ ErrorListenerVisitor::addError("Variable " + symbole->identifierName + " not used",
+                  symbole->line, ErrorType::Warning);
+ }
 }
 
 /**
-* Crée une nouvelle table de symboles pour la portée courante
+* Réserve l'emplacement d'un symbole dans la pile de la fonction
 */
-bool CFG::add_symbol(string id, Type t, int line)
+void CFG::assign_offset(Symbol &symbole)
 {
- if (symbolTables.front().count(id))
+ unsigned int sz = getSize(symbole.type);
+ // This expression handles stack alignment
+ symbole.offset = (nextFreeSymbolIndex + 2 * (sz - 1)) / sz * sz;
+ // Le prochain emplacement suit celui-ci, bourrage d'alignement compris
+ nextFreeSymbolIndex = symbole.offset + 1;
+}
+
+/**
+* Déclare une variable dans la portée courante
+* @param id L'identifiant interné de la variable
+* @param name Son nom, pour les messages et l'affichage de l'IR
+* @return false si la variable est déjà déclarée dans cette portée
+*/
+bool CFG::add_symbol(Identifier id, const string &name, Type t, int line)
+{
+ shared_ptr<Symbol> newSymbol = allocate_shared<Symbol>(ArenaAllocator<Symbol>(arena), t, name, line);
+ if (!symbolTable.declare(id, newSymbol))
  {
  return false; // Retourne false si le symbole existe déjà
  }
- shared_ptr<Symbol> newSymbol = make_shared<Symbol>(t, id, line);
- unsigned int sz = getSize(t);
- // This expression handles stack alignment
- newSymbol->offset = (nextFreeSymbolIndex + 2 * (sz - 1)) / sz * sz;
- nextFreeSymbolIndex += sz;
- symbolTables.front()[id] = newSymbol;
+ assign_offset(*newSymbol);
 
  return true;
 }
 
-shared_ptr<Symbol> CFG::get_symbol(const string &name)
+shared_ptr<Symbol> CFG::get_symbol(Identifier id)
 {
- auto it = symbolTables.begin();
- while (it != symbolTables.end())
- {
- auto symbole = it->find(name);
- if (symbole != it->end())
- {
-   return symbole->second; // Retourne le symbole s'il est trouvé
- }
- it++;
- }
- return nullptr; // Retourne nullptr si le symbole n'est pas trouvé
+ return symbolTable.lookup(id); // nullptr si le symbole n'est pas trouvé
 }
 
+/**
+* Crée une variable temporaire, hors des portées : elle n'est ni cherchée par
+* nom ni concernée par la détection des variables inutilisées
+*/
 shared_ptr<Symbol> CFG::create_new_tempvar(Type t)
 {
- unsigned int sz = getSize(t);
- unsigned int offset = (nextFreeSymbolIndex + 2 * (sz - 1)) / sz * sz;
- string tempVarName = "!T" + to_string(offset);
- if (add_symbol(tempVarName, t, 0))
- {
- shared_ptr<Symbol> symbole = get_symbol(tempVarName);
+ shared_ptr<Symbol> symbole = allocate_shared<Symbol>(ArenaAllocator<Symbol>(arena), t, "", 0);
+ assign_offset(*symbole);
+ symbole->identifierName = "!T" + to_string(symbole->offset);
  symbole->used = true;
+ temporaries.push_back(symbole);
  return symbole; // Retourne la variable temporaire créée
- }
- return nullptr;
 }
 
-shared_ptr<Symbol> CFG::add_parameter(const string &name, Type type,
+shared_ptr<Symbol> CFG::add_parameter(Identifier id, const string &name, Type type,
                       int line)
 {
- bool new_symbol = add_symbol(name, type, line);
+ bool new_symbol = add_symbol(id, name, type, line);
  if (!new_symbol)
  {
  ErrorListenerVisitor::addError(
    "A parameter with name " + name + " has already been declared", line);
  }
- auto symbole = get_symbol(name);
+ auto symbole = get_symbol(id);
  parameterTypes.emplace_back(type, symbole);
  return symbole;
 }
 
 /**
 * Retourne l'offset d'une variable dans la pile
-* @param name Le nom de la variable
+* @param id L'identifiant interné de la variable
 * @return L'offset (décalage) par rapport à %rbp où la variable est stockée
 */
-int CFG::get_var_index(string name)
+int CFG::get_var_index(Identifier id)
 {
- shared_ptr<Symbol> symbole = get_symbol(name);
+ shared_ptr<Symbol> symbole = get_symbol(id);
  if (symbole != nullptr) {
    return symbole->offset;
  }
@@ -272,12 +262,12 @@ int CFG::get_var_index(string name)
 
 /**
 * Retourne le type d'une variable
-* @param name Le nom de la variable
+* @param id L'identifiant interné de la variable
 * @return Le type de la variable (INT, CHAR, etc.)
 */
-Type CFG::get_var_type(string name)
+Type CFG::get_var_type(Identifier id)
 {
- shared_ptr<Symbol> symbole = get_symbol(name);
+ shared_ptr<Symbol> symbole = get_symbol(id);
  if (symbole != nullptr) {
    return symbole->type;
  }
@@ -298,6 +288,7 @@ InstructionLivenessInfo CFG::computeLiveInfo()
 {
  InstructionLivenessInfo livenessInfo;
  bool isAnalysisStable = false;
+ vector<IRInstr *> nextInstructions; // Successeurs de l'instruction courante
 
  // Répète jusqu'à ce que l'analyse devienne stable (aucun changement dans les ensembles de vivacité)
  while (!isAnalysisStable)
@@ -317,43 +308,61 @@ InstructionLivenessInfo CFG::computeLiveInfo()
       int instructionIndex = 0;
 
       // Parcourt les instructions du bloc courant
-      for (auto &instruction : currentBlock->instructions)
+      for (IRInstr *instruction : currentBlock->instructions)
       {
-         set<shared_ptr<Symbol>> previousInSet; // Variables vivantes avant l'instruction (ancienne version)
-         set<shared_ptr<Symbol>> previousOutSet; // Variables vivantes après l'instruction (ancienne version)
-
-         // Récupère les ensembles de vivacité actuels
-         auto inSetIterator = livenessInfo.liveVariablesBeforeInstruction.find(&instruction);
-         auto outSetIterator = livenessInfo.liveVariablesAfterInstruction.find(&instruction);
-         if (inSetIterator != livenessInfo.liveVariablesBeforeInstruction.end())
+         // Ensembles de vivacité de l'instruction, mis à jour sur place (sans
+         // copier leurs anciennes versions)
+         set<shared_ptr<Symbol>> &inSet = livenessInfo.liveVariablesBeforeInstruction[instruction];
+         set<shared_ptr<Symbol>> &outSet = livenessInfo.liveVariablesAfterInstruction[instruction];
+
+         // Calcule les nouvelles variables vivantes avant l'instruction : celles
+         // qu'elle lit, et celles vivantes après elle qu'elle n'écrit pas.
+         // L'ensemble n'est reconstruit que s'il a changé
+         set<shared_ptr<Symbol>> usedVariables = instruction->getUsedVariables();
+         set<shared_ptr<Symbol>> declaredVariables = instruction->getDeclaredVariable();
+         auto liveAfter = [&](const shared_ptr<Symbol> &variable)
          {
-            previousInSet = inSetIterator->second;
-         }
-         if (outSetIterator != livenessInfo.liveVariablesAfterInstruction.end())
+            return outSet.find(variable) != outSet.end() &&
+                   declaredVariables.find(variable) == declaredVariables.end();
+         };
+         size_t newInSize = 0;
+         bool inSetChanged = false;
+         for (auto &liveVariable : outSet)
          {
-            previousOutSet = outSetIterator->second;
+            if (declaredVariables.find(liveVariable) == declaredVariables.end())
+            {
+              newInSize++;
+              inSetChanged |= inSet.find(liveVariable) == inSet.end();
+            }
          }
-
-         // Calcule les nouvelles variables vivantes avant l'instruction
-         set<shared_ptr<Symbol>> outSetUnion = previousOutSet;
-         livenessInfo.liveVariablesBeforeInstruction[&instruction] = instruction.getUsedVariables();
-         for (auto &declaredVariable : instruction.getDeclaredVariable())
+         for (auto &usedVariable : usedVariables)
          {
-            outSetUnion.erase(declaredVariable); // Supprime les variables déclarées
+            if (!liveAfter(usedVariable))
+            {
+              newInSize++;
+              inSetChanged |= inSet.find(usedVariable) == inSet.end();
+            }
          }
-         for (auto &liveVariable : outSetUnion)
+         if (inSetChanged || newInSize != inSet.size())
          {
-            livenessInfo.liveVariablesBeforeInstruction[&instruction].insert(liveVariable);
+            isAnalysisStable = false;
+            inSet = move(usedVariables);
+            for (auto &liveVariable : outSet)
+            {
+              if (declaredVariables.find(liveVariable) == declaredVariables.end())
+              {
+                 inSet.insert(liveVariable);
+              }
+            }
          }
 
          // Calcule les nouvelles variables vivantes après l'instruction
-         livenessInfo.liveVariablesAfterInstruction[&instruction].clear();
-         vector<IRInstr *> nextInstructions;
+         nextInstructions.clear();
 
          // Ajoute la prochaine instruction du bloc si elle existe
          if (instructionIndex + 1 < currentBlock->instructions.size())
          {
-            nextInstructions.push_back(&currentBlock->instructions[instructionIndex + 1]);
+            nextInstructions.push_back(currentBlock->instructions[instructionIndex + 1]);
          }
          else
          {
@@ -375,7 +384,7 @@ InstructionLivenessInfo CFG::computeLiveInfo()
               visitedInBFS.insert(nextBlock);
               if (!nextBlock->instructions.empty())
               {
-                 nextInstructions.push_back(&nextBlock->instructions[0]);
+                 nextInstructions.push_back(nextBlock->instructions[0]);
               }
               else
               {
@@ -391,20 +400,32 @@ InstructionLivenessInfo CFG::computeLiveInfo()
             }
          }
 
-         // Met à jour les variables vivantes après l'instruction
-         for (auto &nextInstruction : nextInstructions)
+         // Met à jour les variables vivantes après l'instruction : avec un seul
+         // successeur, son ensemble est recopié seulement s'il a changé
+         if (nextInstructions.size() == 1)
          {
-            for (auto liveVariable : livenessInfo.liveVariablesBeforeInstruction[nextInstruction])
+            const set<shared_ptr<Symbol>> &nextInSet =
+                livenessInfo.liveVariablesBeforeInstruction[nextInstructions[0]];
+            if (nextInSet != outSet)
             {
-              livenessInfo.liveVariablesAfterInstruction[&instruction].insert(liveVariable);
+              isAnalysisStable = false;
+              outSet = nextInSet;
             }
          }
-
-         // Vérifie si l'analyse est stable
-         if (isAnalysisStable && (livenessInfo.liveVariablesBeforeInstruction[&instruction] != previousInSet ||
-                                          livenessInfo.liveVariablesAfterInstruction[&instruction] != previousOutSet))
+         else
          {
-            isAnalysisStable = false;
+            set<shared_ptr<Symbol>> newOutSet;
+            for (IRInstr *nextInstruction : nextInstructions)
+            {
+              const set<shared_ptr<Symbol>> &nextInSet =
+                  livenessInfo.liveVariablesBeforeInstruction[nextInstruction];
+              newOutSet.insert(nextInSet.begin(), nextInSet.end());
+            }
+            if (newOutSet != outSet)
+            {
+              isAnalysisStable = false;
+              outSet = move(newOutSet);
+            }
          }
 
          instructionIndex++;
@@ -437,7 +458,7 @@ int countUnusedNeighbors(vector<shared_ptr<Symbol>> &neighborSymbols,
             set<shared_ptr<Symbol>> &allocatedNodes)
 {
  int unusedNeighborCount = 0;
- for (auto neighbor : neighborSymbols)
+ for (auto &neighbor : neighborSymbols)
  {
  if (allocatedNodes.find(neighbor) == allocatedNodes.end())
  {
@@ -509,7 +530,7 @@ map<shared_ptr<Symbol>, int> CFG::allocateRegisters(
  for (int registerIndex = 0; registerIndex < totalAvailableRegisters; registerIndex++)
  {
     bool isRegisterFree = true;
-    for (auto neighborSymbol : interferenceGraph[currentSymbol])
+    for (auto &neighborSymbol : interferenceGraph[currentSymbol])
     {
     if (registerAssignments.find(neighborSymbol) != registerAssignments.end() &&
       registerAssignments[neighborSymbol] == registerIndex)
@@ -528,6 +549,125 @@ map<shared_ptr<Symbol>, int> CFG::allocateRegisters(
  return registerAssignments;
 }
 
+/**
+* Construit les paires de symboles que l'allocateur devrait placer dans un même
+* registre : la destination d'une opération à deux adresses et son premier
+* opérande, puis les deux côtés de chaque affectation (voir IRInstr::getTiedOperand)
+* @return Les paires (destination, source) dans l'ordre des instructions
+*/
+vector<pair<shared_ptr<Symbol>, shared_ptr<Symbol>>> CFG::constructTiedSymbols()
+{
+ vector<pair<shared_ptr<Symbol>, shared_ptr<Symbol>>> tiedSymbols;
+ for (auto block : bbs)
+ {
+ for (IRInstr *instruction : block->instructions)
+ {
+    shared_ptr<Symbol> tiedOperand = instruction->getTiedOperand();
+    if (tiedOperand == nullptr)
+    {
+    continue;
+    }
+    shared_ptr<Symbol> definedVariable = *instruction->getDeclaredVariable().begin();
+    if (definedVariable != tiedOperand)
+    {
+    tiedSymbols.push_back({definedVariable, tiedOperand});
+    }
+ }
+ }
+ return tiedSymbols;
+}
+
+/**
+* Fusionne dans le graphe d'interférence les symboles liés qui n'interfèrent pas
+* (coalescence conservatrice de Briggs : le nœud fusionné doit avoir moins de
+* availableRegisterCount voisins de degré élevé, ce qui ne crée pas de spill)
+* @param interferenceGraph Le graphe d'interférence, modifié en place
+* @param tiedSymbols Les paires de symboles à rapprocher
+* @param availableRegisterCount Le nombre de registres disponibles
+* @return Pour chaque symbole fusionné, le symbole qui le représente dans le graphe
+*/
+map<shared_ptr<Symbol>, shared_ptr<Symbol>> CFG::coalesceTiedSymbols(
+ map<shared_ptr<Symbol>, vector<shared_ptr<Symbol>>> &interferenceGraph,
+ vector<pair<shared_ptr<Symbol>, shared_ptr<Symbol>>> &tiedSymbols,
+ int availableRegisterCount)
+{
+ map<shared_ptr<Symbol>, shared_ptr<Symbol>> coalescedSymbols;
+ // Compression de chemin : une longue chaîne d'accumulateurs (a + b + ... + z)
+ // fusionne des milliers de symboles les uns dans les autres, et chaque
+ // symbole parcouru pointe ensuite directement vers son représentant
+ auto representative = [&coalescedSymbols](shared_ptr<Symbol> symbol)
+ {
+ shared_ptr<Symbol> root = symbol;
+ for (auto it = coalescedSymbols.find(root); it != coalescedSymbols.end();
+      it = coalescedSymbols.find(root))
+ {
+    root = it->second;
+ }
+ while (symbol != root)
+ {
+    auto it = coalescedSymbols.find(symbol);
+    symbol = it->second;
+    it->second = root;
+ }
+ return root;
+ };
+
+ for (auto &tie : tiedSymbols)
+ {
+ shared_ptr<Symbol> kept = representative(tie.first);
+ shared_ptr<Symbol> merged = representative(tie.second);
+ if (kept == merged || interferenceGraph.find(kept) == interferenceGraph.end() ||
+      interferenceGraph.find(merged) == interferenceGraph.end())
+ {
+    continue;
+ }
+ vector<shared_ptr<Symbol>> &keptNeighbors = interferenceGraph[kept];
+ vector<shared_ptr<Symbol>> &mergedNeighbors = interferenceGraph[merged];
+ if (find(keptNeighbors.begin(), keptNeighbors.end(), merged) != keptNeighbors.end())
+ {
+    continue; // Les deux symboles sont vivants en même temps
+ }
+
+ // Critère de Briggs sur l'union des voisinages
+ set<shared_ptr<Symbol>> unionNeighbors(keptNeighbors.begin(), keptNeighbors.end());
+ unionNeighbors.insert(mergedNeighbors.begin(), mergedNeighbors.end());
+ int significantNeighbors = 0;
+ for (auto &neighbor : unionNeighbors)
+ {
+    if (interferenceGraph[neighbor].size() >= (size_t)availableRegisterCount)
+    {
+    significantNeighbors++;
+    }
+ }
+ if (significantNeighbors >= availableRegisterCount)
+ {
+    continue;
+ }
+
+ // Reporte les arêtes du symbole fusionné sur son représentant
+ for (auto &neighbor : mergedNeighbors)
+ {
+    vector<shared_ptr<Symbol>> &neighborEdges = interferenceGraph[neighbor];
+    neighborEdges.erase(remove(neighborEdges.begin(), neighborEdges.end(), merged),
+                        neighborEdges.end());
+    if (find(neighborEdges.begin(), neighborEdges.end(), kept) == neighborEdges.end())
+    {
+    neighborEdges.push_back(kept);
+    keptNeighbors.push_back(neighbor);
+    }
+ }
+ interferenceGraph.erase(merged);
+ coalescedSymbols[merged] = kept;
+ }
+
+ // Chaque symbole fusionné pointe directement vers son représentant final
+ for (auto &entry : coalescedSymbols)
+ {
+ entry.second = representative(entry.second);
+ }
+ return coalescedSymbols;
+}
+
 /**
 * Construit le graphe d'interférence à partir des informations de vivacité
 * @param liveInfo Les informations de vivacité
@@ -538,7 +678,7 @@ CFG::constructInterferenceGraph(InstructionLivenessInfo &livenessInfo)
 {
     map<shared_ptr<Symbol>, vector<shared_ptr<Symbol>>> interferenceGraph;
 
-    for (auto instructionEntry : livenessInfo.liveVariablesBeforeInstruction)
+    for (auto &instructionEntry : livenessInfo.liveVariablesBeforeInstruction)
     {
         auto declaredVariables = instructionEntry.first->getDeclaredVariable();
         if (!declaredVariables.empty())
@@ -575,6 +715,20 @@ void CFG::performRegisterAllocation()
  InstructionLivenessInfo liveInfo = computeLiveInfo();
  map<shared_ptr<Symbol>, vector<shared_ptr<Symbol>>>
    interferenceGraph = constructInterferenceGraph(liveInfo);
+ vector<pair<shared_ptr<Symbol>, shared_ptr<Symbol>>>
+   tiedSymbols = constructTiedSymbols();
+ map<shared_ptr<Symbol>, shared_ptr<Symbol>>
+   coalescedSymbols = coalesceTiedSymbols(interferenceGraph, tiedSymbols, 7);
  RegisterAllocationInfo spillInfo = determineRegisterAllocationOrder(interferenceGraph, 7);
  registerAssignment = allocateRegisters(spillInfo, interferenceGraph, 7);
+
+ // Les symboles fusionnés partagent le registre de leur représentant
+ for (auto &coalesced : coalescedSymbols)
+ {
+ auto assignment = registerAssignment.find(coalesced.second);
+ if (assignment != registerAssignment.end())
+ {
+    registerAssignment[coalesced.first] = assignment->second;
+ }
+ }
 }
@@ -10,11 +10,17 @@
 #include <stack>        
 #include <list>        
 
+#include "Arena.h"
 #include "IR.h"         
+#include "MachineIR.h"
+#include "AsmWriter.h"
+#include "IRPrinter.h"
+#include "Peephole.h"
 #include "Symbol.h"     
+#include "ScopedSymbolTable.h"
+#include "StringInterner.h"
 #include "Type.h"       
 #include "BasicBlock.h" 
-#include "CodeGenVisitor.h" 
 
 // ========== Structures auxiliaires ==========
 
@@ -45,41 +51,51 @@ struct RegisterAllocationInfo
 // Représente le Control Flow Graph d'une fonction
 class CFG
 {
+  // Arène de la fonction : ses blocs, ses instructions et ses symboles y sont
+  // alloués, et libérés ensemble avec le CFG. Premier membre, elle est
+  // détruite après tous ceux qui référencent ses objets
+  Arena arena;
+
 public:
   ~CFG();
-  CFG(Type type, const string &name, int argCount, CodeGenVisitor *visitor);
+  CFG(Type type, const string &name, int argCount);
 
+  BasicBlock *create_bb(const string &label); // Crée un bloc dans l'arène, sans l'ajouter
   void add_bb(BasicBlock *bb); // Ajoute un bloc
+  inline Arena &get_arena() { return arena; }
   inline vector<BasicBlock *> &getBlocks() { return bbs; };
 
-  string IR_reg_to_asm(string reg); // Conversion d’un registre IR en emplacement mémoire
-  void gen_asm_prologue(ostream &o);     // Génère le prologue assembleur
-  void gen_asm(ostream &o);              // Génère le corps
-  void gen_asm_epilogue(ostream &o);     // Génère l’épilogue
+  // Alloue les registres, sélectionne et affiche le code ; l'IR est affiché
+  // dans irDump après la passe dumpAfter si demandé
+  void gen_asm(AsmWriter &o, IRPass dumpAfter = IRPass::None, AsmWriter *irDump = nullptr);
+  void gen_machine_function(MachineFunction &function); // Sélectionne les instructions de toute la fonction
+  void gen_asm_prologue(MachineBasicBlock &mbb);      // Génère le prologue
+  void gen_asm_epilogue(MachineBasicBlock &mbb);      // Génère l’épilogue
 
   // Fonctions d'aide pour la gestion des symboles
   shared_ptr<Symbol> create_new_tempvar(Type t);
-  int get_var_index(string name);
-  Type get_var_type(string name);
+  int get_var_index(Identifier id);
+  Type get_var_type(Identifier id);
 
-  string new_BB_name(); // Génère un nom unique pour un nouveau bloc
+  string new_BB_name(); // Génère un label unique pour un nouveau bloc (".L<fonction>_<n>")
 
   BasicBlock *current_bb;               // Bloc courant
+  PeepholeStats peepholeStats;          // Statistiques de l'optimiseur à lucarne
   static const int scratchRegister = 7; // Registre temporaire
 
   // Gestion de la pile de tables des symboles
-  inline void push_table() { symbolTables.push_front(SymbolTable()); }
+  inline void push_table() { symbolTable.pushScope(); }
   void pop_table();
 
-  bool add_symbol(string id, Type t, int line);           // Ajoute une variable
-  shared_ptr<Symbol> get_symbol(const string &name); // Récupère une variable
+  bool add_symbol(Identifier id, const string &name, Type t, int line); // Ajoute une variable
+  shared_ptr<Symbol> get_symbol(Identifier id); // Récupère une variable
 
   string &get_name() { return name; }
   Type get_return_type() { return returnType; }
   const vector<FunctionParameter> &get_parameters_type() { return parameterTypes; }
 
   // Ajout et gestion des paramètres
-  shared_ptr<Symbol> add_parameter(const string &name, Type type, int line);
+  shared_ptr<Symbol> add_parameter(Identifier id, const string &name, Type type, int line);
   map<shared_ptr<Symbol>, int> registerAssignment;
 
   inline void push_parameter(shared_ptr<Symbol> symbole)
@@ -94,8 +110,6 @@ public:
     return symbole;
   }
 
-  inline CodeGenVisitor *get_visitor() { return visitor; }
-
   int getRegisterIndexForSymbol(shared_ptr<Symbol> &param); // Trouve le registre associé à un paramètre
 
   unsigned int nextFreeSymbolIndex; // Utilisé pour indexer les nouvelles variables
@@ -103,6 +117,8 @@ public:
 protected:
   int nextBBnumber; // Numéro du prochain bloc (pour le nommage)
 
+  void assign_offset(Symbol &symbole); // Réserve l'emplacement du symbole dans la pile
+
   string name;
   Type returnType;
   vector<FunctionParameter> parameterTypes;
@@ -110,9 +126,8 @@ protected:
   stack<shared_ptr<Symbol>> parameterStack;
 
   vector<BasicBlock *> bbs;       // Tous les blocs du CFG
-  list<SymbolTable> symbolTables; // Pile de tables de symboles (pour la portée)
-
-  CodeGenVisitor *visitor;
+  ScopedSymbolTable symbolTable;  // Variables nommées, toutes portées confondues
+  vector<shared_ptr<Symbol>> temporaries; // Temporaires, hors de toute portée
 
   // Fonctions pour l’allocation de registre
   void performRegisterAllocation();
@@ -121,6 +136,11 @@ protected:
       map<shared_ptr<Symbol>, vector<shared_ptr<Symbol>>> &interferenceGraph,
       int availableRegisterCount);
   map<shared_ptr<Symbol>, vector<shared_ptr<Symbol>>> constructInterferenceGraph(InstructionLivenessInfo &livenessInfo);
+  vector<pair<shared_ptr<Symbol>, shared_ptr<Symbol>>> constructTiedSymbols();
+  map<shared_ptr<Symbol>, shared_ptr<Symbol>> coalesceTiedSymbols(
+      map<shared_ptr<Symbol>, vector<shared_ptr<Symbol>>> &interferenceGraph,
+      vector<pair<shared_ptr<Symbol>, shared_ptr<Symbol>>> &tiedSymbols,
+      int availableRegisterCount);
   map<shared_ptr<Symbol>, int> allocateRegisters(
       RegisterAllocationInfo &registerAllocationInfo,
       map<shared_ptr<Symbol>, vector<shared_ptr<Symbol>>> &interferenceGraph,
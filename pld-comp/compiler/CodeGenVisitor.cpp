@@ -3,257 +3,208 @@
 #include "ErrorListenerVisitor.h"
 #include "IR.h"
 #include "CFG.h"
-#include "support/Any.h"
 #include "Symbol.h"
 
+#include <algorithm>
 #include <memory>
+#include <numeric>
 #include <string>
 
 using namespace std;
 
-// Constructeur de la classe CodeGenVisitor
-CodeGenVisitor::CodeGenVisitor()
+// Déclare les fonctions getchar et putchar, fournies par la bibliothèque C
+void CodeGenVisitor::declareBuiltins()
 {
-  // Création d'une fonction getchar avec un type de retour INT
-  shared_ptr<CFG> getchar =
-      make_shared<CFG>(Type::INT, "getchar", 0, this);
-
-  // Création d'une fonction putchar avec un type de retour INT
-  shared_ptr<CFG> putchar =
-      make_shared<CFG>(Type::INT, "putchar", 0, this);
-
-  // Ajout d'un paramètre "c" de type INT à la fonction putchar
-  auto symbole = putchar->add_parameter("c", Type::INT, 0);
-  symbole->used = true; // Marque le symbole comme utilisé
-
-  // Ajout des fonctions getchar et putchar à la liste des CFG et au dictionnaire des fonctions
-  functionCFGs.push_back(getchar);
-  functions["getchar"] = getchar;
-  functionCFGs.push_back(putchar);
-  functions["putchar"] = putchar;
+  functions["getchar"] = {Type::INT, {}};
+  functions["putchar"] = {Type::INT, {Type::INT}};
 }
 
-// Visite du nœud Axiom dans l'arbre syntaxique
-antlrcpp::Any CodeGenVisitor::visitAxiom(ifccParser::AxiomContext *ctx)
+/**
+ * Visite du programme : un CFG par fonction, dans l'ordre du source. Chaque
+ * CFG est confié à onFunction sitôt construit, si bien que l'appelant peut
+ * émettre puis libérer une fonction avant que la suivante soit traduite.
+ * @param program Le programme à traduire
+ * @param onFunction Reçoit l'indice de la fonction dans program.functions et
+ *                   son CFG (jamais appelée pour une fonction précompilée)
+ */
+void CodeGenVisitor::visitProgram(Program &program,
+                                  const function<void(size_t, shared_ptr<CFG>)> &onFunction)
 {
-  // Appelle la visite du nœud prog
-  return visit(ctx->prog());
-}
+  this->program = &program;
+  declareBuiltins();
 
-// Visite du nœud Prog dans l'arbre syntaxique
-antlrcpp::Any CodeGenVisitor::visitProg(ifccParser::ProgContext *ctx)
-{
   // Parcourt toutes les fonctions définies dans le programme
-  for (ifccParser::FuncContext *func : ctx->func())
+  for (size_t i = 0; i < program.functions.size(); i++)
   {
-    Type type;
-    // Détermine le type de retour de la fonction
-    if (func->TYPE(0)->toString() == "int")
-    {
-      type = Type::INT;
-    }
-    else if (func->TYPE(0)->toString() == "char")
+    const FunctionDecl *function = program.functions[i];
+
+    // Déclare la signature avant de visiter le corps, pour les appels récursifs
+    string functionName = name(function->name);
+    FunctionSignature signature = {function->returnType, {}};
+    for (const ParameterDecl &parameter : function->parameters)
     {
-      type = Type::CHAR;
+      signature.parameterTypes.push_back(parameter.type == Type::INT ? Type::INT : Type::CHAR);
     }
-    else if (func->TYPE(0)->toString() == "void")
+    functions[functionName] = move(signature);
+
+    // Une fonction déjà compilée ne déclare que sa signature
+    if (precompiledFunctions.count(function))
     {
-      type = Type::VOID;
+      continue;
     }
 
-    // Crée une nouvelle CFG pour la fonction
-    int argCount = func->ID().size() - 1;
-    currentCFG =
-        make_shared<CFG>(type, func->ID(0)->toString(), argCount, this);
-
-    // Ajoute la CFG à la liste et au dictionnaire des fonctions
-    functionCFGs.push_back(currentCFG);
-    functions[func->ID(0)->toString()] = currentCFG;
-
-    // Visite le contenu de la fonction
-    visit(func);
+    // Crée une nouvelle CFG pour la fonction et visite son contenu
+    currentCFG = make_shared<CFG>(function->returnType, functionName,
+                                  function->parameters.size());
+    expressionLabels.clear();
+    visitFunction(function);
 
     // Nettoie la table des symboles
     currentCFG->pop_table();
-  }
 
-  // Si des erreurs ont été détectées, termine le programme
-  if (ErrorListenerVisitor::hasError())
-  {
-    exit(1);
+    // Le CFG appartient désormais à l'appelant
+    onFunction(i, move(currentCFG));
   }
-
-  // Affiche le code assembleur généré
-  cout << assembly.str();
-
-  return 0;
 }
 
-// Visite du nœud Func dans l'arbre syntaxique
-antlrcpp::Any CodeGenVisitor::visitFunc(ifccParser::FuncContext *ctx)
+// Ajoute les paramètres de la fonction à la table des symboles
+void CodeGenVisitor::declareParameters(const FunctionDecl *function)
 {
-  // Ajoute les paramètres de la fonction à la table des symboles
-  for (int i = 1; i < ctx->ID().size(); i++)
+  for (const ParameterDecl &parameter : function->parameters)
   {
-    Type type = (ctx->TYPE(i)->toString() == "int" ? Type::INT : Type::CHAR);
-    auto symbole = currentCFG->add_parameter(ctx->ID(i)->toString(), type,
-                                        ctx->getStart()->getLine());
+    Type type = (parameter.type == Type::INT ? Type::INT : Type::CHAR);
+    auto symbole = currentCFG->add_parameter(parameter.name, name(parameter.name), type,
+                                             function->location.line);
     currentCFG->current_bb->add_IRInstr(IRInstr::param_decl, type, {symbole});
   }
+}
+
+// Visite d'une fonction : ses paramètres, puis les instructions de son bloc
+void CodeGenVisitor::visitFunction(const FunctionDecl *function)
+{
+  declareParameters(function);
 
-  // Visite les instructions du bloc de la fonction
-  for (ifccParser::StmtContext *stmt : ctx->block()->stmt())
+  // Visite les instructions du bloc de la fonction (dans la portée de la fonction)
+  for (const Stmt *stmt : function->body->statements)
   {
-    visit(stmt);
+    visitStatement(stmt);
   }
+}
 
-  return 0;
+// Instruction réduite à une expression (ex : f(x);) : sa valeur est ignorée
+void CodeGenVisitor::visitExpressionStatement(const ExpressionStmt *stmt)
+{
+  visitExpression(stmt->expr);
 }
 
-// Visite du nœud Var_decl_stmt pour déclarer des variables
-antlrcpp::Any
-CodeGenVisitor::visitVar_decl_stmt(ifccParser::Var_decl_stmtContext *ctx)
+// Déclare des variables, initialisées par leur expression ou à 0
+void CodeGenVisitor::visitDeclaration(const DeclarationStmt *stmt)
 {
-  Type type;
-  // Détermine le type de la variable
-  if (ctx->TYPE()->toString() == "int")
-  {
-    type = Type::INT;
-  }
-  else if (ctx->TYPE()->toString() == "char")
-  {
-    type = Type::CHAR;
-  }
-  else if (ctx->TYPE()->toString() == "void")
+  if (stmt->type == Type::VOID)
   {
     // Erreur : une variable ne peut pas être de type void
-    ErrorListenerVisitor::addError(ctx, "Can't create a variable of type void");
+    ErrorListenerVisitor::addError(stmt->location, "Can't create a variable of type void");
   }
 
   // Parcourt les membres de la déclaration
-  for (auto &memberCtx : ctx->var_decl_member())
+  for (const Declarator &variable : stmt->variables)
   {
-    string varName = memberCtx->ID()->toString();
     // Ajoute la variable à la table des symboles
-    addSymbolToSymbolTableFromContext(memberCtx, varName, type);
+    addSymbolToSymbolTable(variable.location, variable.name, stmt->type);
 
-    if (memberCtx->expr())
+    shared_ptr<Symbol> symbole = getSymbolFromSymbolTable(variable.location, variable.name);
+    if (variable.initializer != nullptr)
     {
       // Si une expression d'initialisation est présente, l'évalue
-      shared_ptr<Symbol> symbole = getSymbolFromSymbolTableByContext(memberCtx, varName);
-      shared_ptr<Symbol> source = visit(memberCtx->expr()).as<shared_ptr<Symbol>>();
+      Operand source = visitExpression(variable.initializer);
       currentCFG->current_bb->add_IRInstr(IRInstr::var_assign, Type::INT, {symbole, source});
     }
     else
     {
       // Sinon, initialise implicitement la variable à 0
-      shared_ptr<Symbol> symbole = getSymbolFromSymbolTableByContext(memberCtx, varName);
       auto zero = currentCFG->current_bb->add_IRInstr(IRInstr::ldconst, Type::INT, {"0"});
       currentCFG->current_bb->add_IRInstr(IRInstr::var_assign, Type::INT, {symbole, zero});
     }
   }
-  return 0;
 }
 
-// Visite du nœud Var_assign_stmt pour assigner une valeur à une variable
-antlrcpp::Any
-CodeGenVisitor::visitVar_assign_stmt(ifccParser::Var_assign_stmtContext *ctx)
+// Assigne une valeur à une variable (=, +=, -=, *=, /=)
+void CodeGenVisitor::visitAssignment(const AssignmentStmt *stmt)
 {
   // Récupère le symbole correspondant à l'identifiant dans la table des symboles
-  shared_ptr<Symbol> symbole = getSymbolFromSymbolTableByContext(ctx, ctx->ID()->toString());
+  shared_ptr<Symbol> symbole = getSymbolFromSymbolTable(stmt->location, stmt->name);
 
-  // Si le symbole n'existe pas, retourne une erreur
+  // Si le symbole n'existe pas, l'erreur est déjà signalée
   if (symbole == nullptr)
   {
-    return 1;
+    return;
   }
 
   // Évalue l'expression associée à l'assignation
-  shared_ptr<Symbol> source =
-      visit(ctx->expr()).as<shared_ptr<Symbol>>();
-
-  // Récupère l'opérateur d'assignation à partir du texte brut
-  std::string fullText = ctx->getText();
-  size_t idLength = ctx->ID()->getText().length();
-  size_t exprStart = fullText.find(ctx->expr()->getText());
-  std::string op = fullText.substr(idLength, exprStart - idLength);
+  Operand source = visitExpression(stmt->value);
 
   // Si l'opérateur est une assignation simple
-  if (op == "=")
+  if (stmt->op == AssignOperator::Assign)
   {
     // Ajoute une instruction IR pour assigner la valeur
     currentCFG->current_bb->add_IRInstr(IRInstr::var_assign, Type::INT, {symbole, source});
+    return;
   }
-  else
+
+  // Sinon, détermine l'opération correspondante
+  IRInstr::Operation instr;
+  switch (stmt->op)
   {
-    // Sinon, détermine l'opération correspondante
-    IRInstr::Operation instr;
-    if (op == "+=")
-      instr = IRInstr::add;
-    else if (op == "-=")
-      instr = IRInstr::sub;
-    else if (op == "*=")
-      instr = IRInstr::mul;
-    else if (op == "/=")
-      instr = IRInstr::div;
-
-    // Crée une variable temporaire pour stocker le résultat intermédiaire
-    shared_ptr<Symbol> temp = currentCFG->create_new_tempvar(Type::INT);
-    currentCFG->current_bb->add_IRInstr(IRInstr::ldvar, Type::INT, {symbole});
-    currentCFG->current_bb->add_IRInstr(instr, Type::INT, {symbole, source, temp});
-    currentCFG->current_bb->add_IRInstr(IRInstr::var_assign, Type::INT, {symbole, temp});
-  }
-  return 0;
+  case AssignOperator::Add: instr = IRInstr::add; break;
+  case AssignOperator::Sub: instr = IRInstr::sub; break;
+  case AssignOperator::Mul: instr = IRInstr::mul; break;
+  default: instr = IRInstr::div; break;
+  }
+
+  // Opération en place sur la variable (forme deux adresses : x = x op e)
+  currentCFG->current_bb->add_IRInstr(instr, Type::INT, {symbole, source, symbole});
 }
 
-// Visite du nœud If pour gérer les instructions conditionnelles
-antlrcpp::Any CodeGenVisitor::visitIf(ifccParser::IfContext *ctx)
+// Gère les instructions conditionnelles, avec ou sans branche else
+void CodeGenVisitor::visitIf(const IfStmt *stmt)
 {
   // Évalue l'expression conditionnelle
-  shared_ptr<Symbol> result =
-      visit(ctx->expr()).as<shared_ptr<Symbol>>();
-  string nextBBLabel = ".L" + to_string(nextLabel);
-  nextLabel++;
-
-  // Crée les blocs de base pour la condition et les branches
+  Operand result = visitExpression(stmt->condition);
   BasicBlock *baseBlock = currentCFG->current_bb;
-  BasicBlock *trueBlock = new BasicBlock(currentCFG.get(), "");
-  BasicBlock *falseBlock = new BasicBlock(currentCFG.get(), nextBBLabel);
 
-  // Ajoute une instruction IR pour comparer la condition
-  baseBlock->add_IRInstr(IRInstr::cmpNZ, Type::INT, {result});
+  if (stmt->elseBlock == nullptr)
+  {
+    string nextBBLabel = currentCFG->new_BB_name();
 
-  // Configure les sorties des blocs
-  trueBlock->exit_true = falseBlock;
-  falseBlock->exit_true = baseBlock->exit_true;
+    // Crée les blocs de base pour la condition et les branches
+    BasicBlock *trueBlock = currentCFG->create_bb("");
+    BasicBlock *falseBlock = currentCFG->create_bb(nextBBLabel);
 
-  // Ajoute les blocs au CFG
-  currentCFG->add_bb(trueBlock);
-  visit(ctx->block());
+    // Ajoute une instruction IR pour comparer la condition
+    baseBlock->add_IRInstr(IRInstr::cmpNZ, Type::INT, {result});
 
-  currentCFG->add_bb(falseBlock);
+    // Configure les sorties des blocs
+    trueBlock->exit_true = falseBlock;
+    falseBlock->exit_true = baseBlock->exit_true;
 
-  baseBlock->exit_true = trueBlock;
-  baseBlock->exit_false = falseBlock;
-  return 0;
-}
+    // Ajoute les blocs au CFG
+    currentCFG->add_bb(trueBlock);
+    visitBlock(stmt->thenBlock);
 
-// Visite du nœud If_else pour gérer les instructions conditionnelles avec une branche else
-antlrcpp::Any CodeGenVisitor::visitIf_else(ifccParser::If_elseContext *ctx)
-{
-  // Évalue l'expression conditionnelle
-  shared_ptr<Symbol> result =
-      visit(ctx->expr()).as<shared_ptr<Symbol>>();
-  string elseBBLabel = ".L" + to_string(nextLabel);
-  nextLabel++;
-  string endBBLabel = ".L" + to_string(nextLabel);
-  nextLabel++;
+    currentCFG->add_bb(falseBlock);
+
+    baseBlock->exit_true = trueBlock;
+    baseBlock->exit_false = falseBlock;
+    return;
+  }
+
+  string elseBBLabel = currentCFG->new_BB_name();
+  string endBBLabel = currentCFG->new_BB_name();
 
   // Crée les blocs de base pour la condition, les branches et la fin
-  BasicBlock *baseBlock = currentCFG->current_bb;
-  BasicBlock *trueBlock = new BasicBlock(currentCFG.get(), "");
-  BasicBlock *elseBlock = new BasicBlock(currentCFG.get(), elseBBLabel);
-  BasicBlock *endBlock = new BasicBlock(currentCFG.get(), endBBLabel);
+  BasicBlock *trueBlock = currentCFG->create_bb("");
+  BasicBlock *elseBlock = currentCFG->create_bb(elseBBLabel);
+  BasicBlock *endBlock = currentCFG->create_bb(endBBLabel);
 
   // Configure les sorties des blocs
   trueBlock->exit_true = endBlock;
@@ -265,33 +216,29 @@ antlrcpp::Any CodeGenVisitor::visitIf_else(ifccParser::If_elseContext *ctx)
 
   // Ajoute les blocs au CFG et visite les blocs if et else
   currentCFG->add_bb(trueBlock);
-  visit(ctx->if_block);
+  visitBlock(stmt->thenBlock);
 
   currentCFG->add_bb(elseBlock);
-  visit(ctx->else_block);
+  visitBlock(stmt->elseBlock);
 
   currentCFG->add_bb(endBlock);
 
   baseBlock->exit_true = trueBlock;
   baseBlock->exit_false = elseBlock;
-  return 0;
 }
 
-// Visite du nœud While_stmt pour gérer les boucles while
-antlrcpp::Any
-CodeGenVisitor::visitWhile_stmt(ifccParser::While_stmtContext *ctx)
+// Gère les boucles while
+void CodeGenVisitor::visitWhile(const WhileStmt *stmt)
 {
   // Crée les étiquettes pour les blocs de condition et de fin
-  string conditionBBLabel = ".L" + to_string(nextLabel);
-  nextLabel++;
-  string endBBLabel = ".L" + to_string(nextLabel);
-  nextLabel++;
+  string conditionBBLabel = currentCFG->new_BB_name();
+  string endBBLabel = currentCFG->new_BB_name();
 
   // Crée les blocs de base pour la condition, le corps de la boucle et la fin
   BasicBlock *baseBlock = currentCFG->current_bb;
-  BasicBlock *conditionBlock = new BasicBlock(currentCFG.get(), conditionBBLabel);
-  BasicBlock *stmtBlock = new BasicBlock(currentCFG.get(), "");
-  BasicBlock *endBlock = new BasicBlock(currentCFG.get(), endBBLabel);
+  BasicBlock *conditionBlock = currentCFG->create_bb(conditionBBLabel);
+  BasicBlock *stmtBlock = currentCFG->create_bb("");
+  BasicBlock *endBlock = currentCFG->create_bb(endBBLabel);
 
   // Configure les sorties des blocs
   conditionBlock->exit_true = stmtBlock;
@@ -302,53 +249,60 @@ CodeGenVisitor::visitWhile_stmt(ifccParser::While_stmtContext *ctx)
 
   // Ajoute les blocs au CFG
   currentCFG->add_bb(conditionBlock);
-  shared_ptr<Symbol> result =
-      visit(ctx->expr()).as<shared_ptr<Symbol>>();
+  Operand result = visitExpression(stmt->condition);
   conditionBlock->add_IRInstr(IRInstr::cmpNZ, Type::INT, {result});
 
   currentCFG->add_bb(stmtBlock);
-  visit(ctx->block());
+  visitBlock(stmt->body);
 
   currentCFG->add_bb(endBlock);
-
-  return 0;
 }
 
-// Visite du nœud Block pour gérer les blocs de code
-antlrcpp::Any CodeGenVisitor::visitBlock(ifccParser::BlockContext *ctx)
+// Gère les blocs de code, qui ouvrent chacun une nouvelle portée. Les blocs
+// directement imbriqués ({ { ... } }) sont parcourus avec une pile explicite
+// plutôt que par récursion, quelle que soit leur profondeur
+void CodeGenVisitor::visitBlock(const BlockStmt *stmt)
 {
-  // Pousse une nouvelle table des symboles pour le bloc
+  // Blocs ouverts et indice de leur prochaine instruction
+  vector<pair<const BlockStmt *, size_t>> blocks = {{stmt, 0}};
   currentCFG->push_table();
-  
-  // Parcourt toutes les instructions du bloc
-  for (ifccParser::StmtContext *stmt : ctx->stmt())
+  while (!blocks.empty())
   {
-    visit(stmt); // Visite chaque instruction
+    auto &[block, next] = blocks.back();
+    if (next == block->statements.size())
+    {
+      // Retire la table des symboles à la fin du bloc
+      currentCFG->pop_table();
+      blocks.pop_back();
+      continue;
+    }
+    const Stmt *child = block->statements[next++];
+    if (child->kind == StmtKind::Block)
+    {
+      currentCFG->push_table();
+      blocks.push_back({static_cast<const BlockStmt *>(child), 0});
+      continue;
+    }
+    visitStatement(child);
   }
-
-  // Retire la table des symboles à la fin du bloc
-  currentCFG->pop_table();
-  return 0;
 }
 
-// Visite du nœud Return_stmt pour gérer les instructions de retour
-antlrcpp::Any
-CodeGenVisitor::visitReturn_stmt(ifccParser::Return_stmtContext *ctx)
+// Gère les instructions de retour
+void CodeGenVisitor::visitReturn(const ReturnStmt *stmt)
 {
   // Vérifie si la fonction a un type de retour non void
   if (currentCFG->get_return_type() != Type::VOID)
   {
     // Si une expression de retour est absente, signale une erreur
-    if (ctx->expr() == nullptr)
+    if (stmt->value == nullptr)
     {
       string message =
           "No void function " + currentCFG->get_name() + " should return a value";
-      ErrorListenerVisitor::addError(ctx, message);
-      return 1;
+      ErrorListenerVisitor::addError(stmt->location, message);
+      return;
     }
     // Évalue l'expression de retour
-    shared_ptr<Symbol> val =
-        visit(ctx->expr()).as<shared_ptr<Symbol>>();
+    Operand val = visitExpression(stmt->value);
     // Ajoute une instruction IR pour le retour
     currentCFG->current_bb->add_IRInstr(IRInstr::ret, currentCFG->get_return_type(),
                                     {val});
@@ -356,362 +310,407 @@ CodeGenVisitor::visitReturn_stmt(ifccParser::Return_stmtContext *ctx)
   else
   {
     // Si la fonction est de type void, une expression de retour est interdite
-    if (ctx->expr() != nullptr)
+    if (stmt->value != nullptr)
     {
       string message =
           "Void function " + currentCFG->get_name() + " should not return a value";
-      ErrorListenerVisitor::addError(ctx, message);
-      return 1;
+      ErrorListenerVisitor::addError(stmt->location, message);
+      return;
     }
     // Ajoute une instruction IR pour le retour sans valeur
     currentCFG->current_bb->add_IRInstr(IRInstr::ret, currentCFG->get_return_type(),
                                     {});
   }
-
-  return 0;
-}
-
-// Visite du nœud Par pour gérer les expressions entre parenthèses
-antlrcpp::Any CodeGenVisitor::visitPar(ifccParser::ParContext *ctx)
-{
-  // Visite l'expression contenue dans les parenthèses
-  return visit(ctx->expr());
 }
 
-// Visite du nœud Func_call pour gérer les appels de fonction
-antlrcpp::Any
-CodeGenVisitor::visitFunc_call(ifccParser::Func_callContext *ctx)
+// Gère les appels de fonction
+Operand CodeGenVisitor::visitCall(const CallExpr *expr)
 {
   // Vérifie si la fonction appelée a été déclarée
-  auto it = functions.find(ctx->ID()->toString());
+  string callee = name(expr->callee);
+  auto it = functions.find(callee);
   if (it == functions.end())
   {
-    string message =
-        "Function " + ctx->ID()->toString() + " was not declared";
-    ErrorListenerVisitor::addError(ctx, message);
+    string message = "Function " + callee + " was not declared";
+    ErrorListenerVisitor::addError(expr->location, message);
+    return currentCFG->create_new_tempvar(Type::INT);
   }
 
-  auto funcCfg = it->second;
+  const FunctionSignature &signature = it->second;
 
   // Vérifie si le nombre de paramètres correspond
-  if (ctx->expr().size() != funcCfg->get_parameters_type().size())
+  if (expr->arguments.size() != signature.parameterTypes.size())
   {
     string message = "Wrong number of parameters in function call to " +
-                     funcCfg->get_name() + ": expected " +
-                     to_string(funcCfg->get_parameters_type().size()) +
-                     " but found " + to_string(ctx->expr().size()) +
+                     callee + ": expected " +
+                     to_string(signature.parameterTypes.size()) +
+                     " but found " + to_string(expr->arguments.size()) +
                      " instead";
-    ErrorListenerVisitor::addError(ctx, message);
+    ErrorListenerVisitor::addError(expr->location, message);
   }
 
   // Prépare les paramètres pour l'appel de fonction
-  vector<Parameter> params = {ctx->ID()->toString()};
-  for (int i = 0; i < funcCfg->get_parameters_type().size(); i++)
+  ParameterList params = {callee};
+  size_t count = min(expr->arguments.size(), signature.parameterTypes.size());
+  for (size_t i = 0; i < count; i++)
   {
-    shared_ptr<Symbol> symbole =
-        visit(ctx->expr(i)).as<shared_ptr<Symbol>>();
+    Operand symbole = visitExpression(expr->arguments[i]);
     params.push_back(symbole);
     // Ajoute une instruction IR pour chaque paramètre
     currentCFG->current_bb->add_IRInstr(
-        IRInstr::param, funcCfg->get_parameters_type()[i].type, {symbole});
+        IRInstr::param, signature.parameterTypes[i], {symbole});
   }
 
   // Ajoute une instruction IR pour l'appel de fonction
   return currentCFG->current_bb->add_IRInstr(IRInstr::call,
-                                         funcCfg->get_return_type(), params);
+                                         signature.returnType, move(params));
 }
 
-// Visite du nœud Multdiv pour gérer les opérations de multiplication, division et modulo
-antlrcpp::Any CodeGenVisitor::visitMultdiv(ifccParser::MultdivContext *ctx)
+// Étiquette d'une expression avant prise en compte de ses opérandes, qui
+// sont ajoutés à operands
+static ExpressionLabel ownLabel(const Expr *expr, vector<const Expr *> &operands)
 {
-  IRInstr::Operation instr;
-  // Détermine l'opération en fonction de l'opérateur
-  if (ctx->op->getText() == "*")
-  {
-    instr = IRInstr::mul;
-  }
-  else if (ctx->op->getText() == "/")
-  {
-    instr = IRInstr::div;
-  }
-  else
-  {
-    instr = IRInstr::mod;
-  }
+  ExpressionLabel label = {1, false};
+  switch (expr->kind)
+  {
+  case ExprKind::Call:
+    label.hasSideEffects = true;
+    operands.assign(static_cast<const CallExpr *>(expr)->arguments.begin(),
+                    static_cast<const CallExpr *>(expr)->arguments.end());
+    break;
+  case ExprKind::PreIncDec:
+  case ExprKind::PostIncDec:
+    label.hasSideEffects = true;
+    break;
+  case ExprKind::Unary:
+  {
+    auto unary = static_cast<const UnaryExpr *>(expr);
+    label.hasSideEffects =
+        unary->op == UnaryOperator::Increment || unary->op == UnaryOperator::Decrement;
+    operands.push_back(unary->operand);
+    break;
+  }
+  case ExprKind::Binary:
+    operands.push_back(static_cast<const BinaryExpr *>(expr)->left);
+    operands.push_back(static_cast<const BinaryExpr *>(expr)->right);
+    break;
+  default:
+    break;
+  }
+  return label;
+}
 
-  // Évalue les opérandes gauche et droit
-  shared_ptr<Symbol> leftVal =
-      visit(ctx->expr(0)).as<shared_ptr<Symbol>>();
-  shared_ptr<Symbol> rightVal =
-      visit(ctx->expr(1)).as<shared_ptr<Symbol>>();
+/**
+ * Calcule l'étiquette de Sethi-Ullman d'une expression : une feuille demande
+ * un registre, une opération binaire dont les opérandes demandent n et m
+ * registres en demande max(n, m) si n != m, et n + 1 sinon.
+ * Les appels de fonction et les incrémentations sont marqués comme ayant des
+ * effets de bord : l'ordre d'évaluation de leurs voisins est alors conservé.
+ * L'arbre est parcouru en ordre postfixe avec une pile explicite, pour que
+ * la profondeur de l'expression ne soit pas limitée par celle de la pile
+ * d'appels.
+ * @param expr Le nœud d'expression
+ * @return L'étiquette de l'expression
+ */
+ExpressionLabel CodeGenVisitor::labelExpression(const Expr *expr)
+{
+  // Nœuds à étiqueter, et si leurs opérandes l'ont déjà été
+  vector<pair<const Expr *, bool>> work = {{expr, false}};
+  vector<const Expr *> operands;
+  while (!work.empty())
+  {
+    auto [node, operandsLabeled] = work.back();
+    if (expressionLabels.count(node) != 0)
+    {
+      work.pop_back();
+      continue;
+    }
+    operands.clear();
+    ExpressionLabel label = ownLabel(node, operands);
+    if (!operandsLabeled)
+    {
+      work.back().second = true;
+      for (const Expr *operand : operands)
+      {
+        work.push_back({operand, false});
+      }
+      continue;
+    }
+    work.pop_back();
 
-  // Ajoute une instruction IR pour l'opération
-  return currentCFG->current_bb->add_IRInstr(instr, Type::INT, {leftVal, rightVal});
+    // Combine les étiquettes des sous-expressions
+    for (const Expr *operand : operands)
+    {
+      label.hasSideEffects |= expressionLabels[operand].hasSideEffects;
+    }
+    if (operands.size() == 2)
+    {
+      int leftNeed = expressionLabels[operands[0]].registerNeed;
+      int rightNeed = expressionLabels[operands[1]].registerNeed;
+      label.registerNeed = leftNeed == rightNeed ? leftNeed + 1 : max(leftNeed, rightNeed);
+    }
+    else
+    {
+      for (const Expr *operand : operands)
+      {
+        label.registerNeed = max(label.registerNeed, expressionLabels[operand].registerNeed);
+      }
+    }
+    expressionLabels[node] = label;
+  }
+  return expressionLabels[expr];
 }
 
-// Visite du nœud Addsub pour gérer les opérations d'addition et de soustraction
-antlrcpp::Any CodeGenVisitor::visitAddsub(ifccParser::AddsubContext *ctx)
+// Opérateurs associatifs et commutatifs sur les entiers : une chaîne de l'un
+// d'eux peut être évaluée dans n'importe quel ordre
+static bool isAssociative(BinaryOperator op)
 {
-  // Détermine l'opération en fonction de l'opérateur (+ ou -)
-  IRInstr::Operation instr =
-      (ctx->op->getText() == "+" ? IRInstr::add : IRInstr::sub);
-
-  // Évalue les opérandes gauche et droit
-  shared_ptr<Symbol> leftVal =
-      visit(ctx->expr(0)).as<shared_ptr<Symbol>>();
-  shared_ptr<Symbol> rightVal =
-      visit(ctx->expr(1)).as<shared_ptr<Symbol>>();
+  return op == BinaryOperator::Add || op == BinaryOperator::Mul ||
+         op == BinaryOperator::BitAnd || op == BinaryOperator::BitXor ||
+         op == BinaryOperator::BitOr;
+}
 
-  // Vérifie si les opérandes sont valides
-  if (leftVal == nullptr || rightVal == nullptr)
+static bool isLogical(const Expr *expr)
+{
+  if (expr->kind != ExprKind::Binary)
   {
-    ErrorListenerVisitor::addError(
-        ctx, "Invalid operation with function returning void");
+    return false;
   }
-
-  // Ajoute une instruction IR pour l'opération
-  return currentCFG->current_bb->add_IRInstr(instr, Type::INT, {leftVal, rightVal});
+  BinaryOperator op = static_cast<const BinaryExpr *>(expr)->op;
+  return op == BinaryOperator::LogicalAnd || op == BinaryOperator::LogicalOr;
 }
 
-// Visite du nœud Cmp pour gérer les comparaisons (<, <=, >, >=)
-antlrcpp::Any CodeGenVisitor::visitCmp(ifccParser::CmpContext *ctx)
+/**
+ * Prépare l'évaluation d'une opération binaire (ni && ni ||). Une chaîne du
+ * même opérateur associatif, comme a + b + c + d, est mise à plat en la
+ * liste de ses opérandes. Les opérandes qui demandent le plus de registres
+ * sont évalués en premier, pour que les résultats déjà calculés ne restent
+ * pas vivants pendant leur calcul ; l'ordre source est conservé dès qu'un
+ * opérande a des effets de bord.
+ * @param expr La racine de la chaîne
+ * @return La chaîne, dont aucun opérande n'est encore évalué
+ */
+CodeGenVisitor::PendingChain CodeGenVisitor::prepareChain(const BinaryExpr *expr)
 {
-  IRInstr::Operation instr;
-  // Détermine l'opération en fonction de l'opérateur
-  if (ctx->op->getText() == ">")
-  {
-    instr = IRInstr::Operation::gt;
+  PendingChain chain;
+  switch (expr->op)
+  {
+  case BinaryOperator::Mul: chain.instr = IRInstr::mul; chain.checkVoidOperands = false; break;
+  case BinaryOperator::Div: chain.instr = IRInstr::div; chain.checkVoidOperands = false; break;
+  case BinaryOperator::Mod: chain.instr = IRInstr::mod; chain.checkVoidOperands = false; break;
+  case BinaryOperator::Add: chain.instr = IRInstr::add; break;
+  case BinaryOperator::Sub: chain.instr = IRInstr::sub; break;
+  case BinaryOperator::Less: chain.instr = IRInstr::lt; break;
+  case BinaryOperator::LessEqual: chain.instr = IRInstr::leq; break;
+  case BinaryOperator::Greater: chain.instr = IRInstr::gt; break;
+  case BinaryOperator::GreaterEqual: chain.instr = IRInstr::geq; break;
+  case BinaryOperator::Equal: chain.instr = IRInstr::eq; break;
+  case BinaryOperator::NotEqual: chain.instr = IRInstr::neq; break;
+  case BinaryOperator::BitAnd: chain.instr = IRInstr::b_and; chain.checkVoidOperands = false; break;
+  case BinaryOperator::BitXor: chain.instr = IRInstr::b_xor; break;
+  default: chain.instr = IRInstr::b_or; break;
+  }
+
+  // Opérandes dans l'ordre du source, avec l'opération dont chacun est un
+  // enfant direct
+  vector<const BinaryExpr *> nodes = {expr};
+  while (!nodes.empty())
+  {
+    const BinaryExpr *node = nodes.back();
+    nodes.pop_back();
+    for (const Expr *child : {node->right, node->left})
+    {
+      if (isAssociative(expr->op) && child->kind == ExprKind::Binary &&
+          static_cast<const BinaryExpr *>(child)->op == expr->op)
+      {
+        nodes.push_back(static_cast<const BinaryExpr *>(child));
+      }
+      else
+      {
+        chain.operands.push_back({child, node});
+      }
+    }
   }
-  else if (ctx->op->getText() == ">=")
+  // Les enfants ont été empilés droite puis gauche : on remet l'ordre source
+  reverse(chain.operands.begin(), chain.operands.end());
+
+  bool hasSideEffects = false;
+  vector<int> registerNeeds;
+  for (auto &[operand, parent] : chain.operands)
   {
-    instr = IRInstr::Operation::geq;
+    ExpressionLabel label = labelExpression(operand);
+    hasSideEffects |= label.hasSideEffects;
+    registerNeeds.push_back(label.registerNeed);
   }
-  else if (ctx->op->getText() == "<")
+  chain.order.resize(chain.operands.size());
+  iota(chain.order.begin(), chain.order.end(), 0);
+  if (!hasSideEffects)
   {
-    instr = IRInstr::Operation::lt;
+    stable_sort(chain.order.begin(), chain.order.end(), [&](size_t a, size_t b)
+                { return registerNeeds[a] > registerNeeds[b]; });
   }
-  else if (ctx->op->getText() == "<=")
+  return chain;
+}
+
+/**
+ * Combine la valeur du prochain opérande d'une chaîne avec celles des
+ * opérandes déjà évalués. L'opérande le plus à gauche dans le source reste
+ * l'opérande gauche de l'instruction, ce qui préserve les opérations non
+ * commutatives.
+ * @param chain La chaîne en cours d'évaluation
+ * @param value La valeur de l'opérande chain.order[chain.next]
+ */
+void CodeGenVisitor::accumulate(PendingChain &chain, Operand value)
+{
+  size_t index = chain.order[chain.next++];
+  const BinaryExpr *parent = chain.operands[index].second;
+  if (value == nullptr && chain.checkVoidOperands &&
+      find(chain.reported.begin(), chain.reported.end(), parent) == chain.reported.end())
   {
-    instr = IRInstr::Operation::leq;
+    // Une seule erreur par opération, même si ses deux opérandes sont void
+    ErrorListenerVisitor::addError(parent->location,
+                                   "Invalid operation with function returning void");
+    chain.reported.push_back(parent);
   }
 
-  // Évalue les opérandes gauche et droit
-  shared_ptr<Symbol> leftVal =
-      visit(ctx->expr(0)).as<shared_ptr<Symbol>>();
-  shared_ptr<Symbol> rightVal =
-      visit(ctx->expr(1)).as<shared_ptr<Symbol>>();
-
-  // Vérifie si les opérandes sont valides
-  if (leftVal == nullptr || rightVal == nullptr)
+  if (chain.next == 1)
   {
-    ErrorListenerVisitor::addError(
-        ctx, "Invalid operation with function returning void");
+    chain.accumulator = value;
+    chain.firstOperand = index;
+    return;
+  }
+  if (index < chain.firstOperand)
+  {
+    chain.accumulator = currentCFG->current_bb->add_IRInstr(chain.instr, Type::INT,
+                                                            {value, chain.accumulator});
+    chain.firstOperand = index;
+  }
+  else
+  {
+    chain.accumulator = currentCFG->current_bb->add_IRInstr(chain.instr, Type::INT,
+                                                            {chain.accumulator, value});
   }
-
-  // Ajoute une instruction IR pour la comparaison
-  return currentCFG->current_bb->add_IRInstr(instr, Type::INT, {leftVal, rightVal});
 }
 
-// Visite du nœud Eq pour gérer les comparaisons d'égalité (==, !=)
-antlrcpp::Any CodeGenVisitor::visitEq(ifccParser::EqContext *ctx)
+/**
+ * Gère les opérations binaires : arithmétique (* / % + -), comparaisons
+ * (< <= > >= == !=) et opérations bit à bit (& ^ |) ; && et || sont confiés
+ * à visitLogical.
+ * Les opérations imbriquées sont évaluées avec une pile explicite de chaînes
+ * (voir prepareChain) plutôt que par récursion : un opérande qui est lui-même
+ * une opération binaire ouvre une nouvelle chaîne au sommet de la pile, dont
+ * le résultat est ensuite cumulé dans la chaîne qui l'a ouverte.
+ * @param expr L'opération
+ * @return Le symbole résultat
+ */
+Operand CodeGenVisitor::visitBinary(const BinaryExpr *expr)
 {
-  // Détermine l'opération en fonction de l'opérateur (== ou !=)
-  IRInstr::Operation instr =
-      (ctx->op->getText() == "==" ? IRInstr::eq : IRInstr::neq);
-
-  // Évalue les opérandes gauche et droit
-  shared_ptr<Symbol> leftVal =
-      visit(ctx->expr(0)).as<shared_ptr<Symbol>>();
-  shared_ptr<Symbol> rightVal =
-      visit(ctx->expr(1)).as<shared_ptr<Symbol>>();
-
-  // Vérifie si les opérandes sont valides
-  if (leftVal == nullptr || rightVal == nullptr)
+  if (isLogical(expr))
   {
-    ErrorListenerVisitor::addError(
-        ctx, "Invalid operation with function returning void");
+    return visitLogical(expr);
   }
 
-  // Ajoute une instruction IR pour la comparaison
-  return currentCFG->current_bb->add_IRInstr(instr, Type::INT, {leftVal, rightVal});
-}
-
-// Visite du nœud Val pour gérer les valeurs (identifiants, littéraux entiers ou caractères)
-antlrcpp::Any CodeGenVisitor::visitVal(ifccParser::ValContext *ctx)
-{
-  shared_ptr<Symbol> source;
-  // Si c'est un identifiant, charge la variable
-  if (ctx->ID() != nullptr)
+  vector<PendingChain> chains;
+  chains.push_back(prepareChain(expr));
+  while (true)
   {
-    shared_ptr<Symbol> symbole = getSymbolFromSymbolTableByContext(ctx, ctx->ID()->toString());
-    if (symbole != nullptr)
+    PendingChain &chain = chains.back();
+    if (chain.next == chain.order.size())
     {
-      source =
-          currentCFG->current_bb->add_IRInstr(IRInstr::ldvar, Type::INT, {symbole});
+      Operand result = chain.accumulator;
+      chains.pop_back();
+      if (chains.empty())
+      {
+        return result;
+      }
+      accumulate(chains.back(), result);
+      continue;
     }
-  }
-  // Si c'est un littéral entier, charge la constante
-  else if (ctx->INTEGER_LITERAL() != nullptr)
-  {
-    source = currentCFG->current_bb->add_IRInstr(
-        IRInstr::ldconst, Type::INT, {ctx->INTEGER_LITERAL()->toString()});
-  }
-  // Si c'est un littéral caractère, charge la constante
-  else if (ctx->CHAR_LITERAL() != nullptr)
-  {
-    string val =
-        to_string(static_cast<int>(ctx->CHAR_LITERAL()->toString()[1]));
-    source =
-        currentCFG->current_bb->add_IRInstr(IRInstr::ldconst, Type::CHAR, {val});
-  }
 
-  return source;
+    const Expr *operand = chain.operands[chain.order[chain.next]].first;
+    if (operand->kind == ExprKind::Binary && !isLogical(operand))
+    {
+      chains.push_back(prepareChain(static_cast<const BinaryExpr *>(operand)));
+      continue;
+    }
+    accumulate(chain, visitExpression(operand));
+  }
 }
 
-// Ajoute un symbole à la table des symboles à partir du contexte
-bool CodeGenVisitor::addSymbolToSymbolTableFromContext(antlr4::ParserRuleContext *ctx,
-                                                       const string &id, Type type)
+// Charge une valeur littérale (entier ou caractère, déjà converti en nombre)
+Operand CodeGenVisitor::visitConstant(const ConstantExpr *expr)
 {
-  bool result = currentCFG->add_symbol(id, type, ctx->getStart()->getLine());
-  if (!result)
-  {
-    string error = "The variable " + id + " has already been declared";
-    ErrorListenerVisitor::addError(ctx, error, ErrorType::Error);
-  }
-  return result;
+  return currentCFG->current_bb->add_IRInstr(IRInstr::ldconst, expr->type,
+                                             {name(expr->value)});
 }
 
-// Récupère un symbole de la table des symboles à partir du contexte
-shared_ptr<Symbol>
-CodeGenVisitor::getSymbolFromSymbolTableByContext(antlr4::ParserRuleContext *ctx,
-                                                  const string &id)
+// Charge la valeur d'une variable
+Operand CodeGenVisitor::visitVariable(const VariableExpr *expr)
 {
-  shared_ptr<Symbol> symbole = currentCFG->get_symbol(id);
+  shared_ptr<Symbol> symbole = getSymbolFromSymbolTable(expr->location, expr->name);
   if (symbole == nullptr)
   {
-    const string error = "Symbol not found: " + id;
-    ErrorListenerVisitor::addError(ctx, error, ErrorType::Error);
     return nullptr;
   }
-
-  symbole->used = true;
-  return symbole;
+  return currentCFG->current_bb->add_IRInstr(IRInstr::ldvar, Type::INT, {symbole});
 }
 
-// Visite du nœud B_and pour gérer les opérations binaires AND (&)
-antlrcpp::Any CodeGenVisitor::visitB_and(ifccParser::B_andContext *ctx)
+// Ajoute un symbole à la table des symboles, en signalant une redéclaration
+bool CodeGenVisitor::addSymbolToSymbolTable(const SourceLocation &location,
+                                            Identifier id, Type type)
 {
-  // Évalue les opérandes gauche et droit
-  shared_ptr<Symbol> leftVal =
-      visit(ctx->expr(0)).as<shared_ptr<Symbol>>();
-  shared_ptr<Symbol> rightVal =
-      visit(ctx->expr(1)).as<shared_ptr<Symbol>>();
-
-  // Ajoute une instruction IR pour l'opération AND
-  return currentCFG->current_bb->add_IRInstr(IRInstr::b_and, Type::INT,
-                                         {leftVal, rightVal});
-}
-
-// Visite du nœud B_or pour gérer les opérations binaires OR (|)
-antlrcpp::Any CodeGenVisitor::visitB_or(ifccParser::B_orContext *ctx)
-{
-  // Évalue les opérandes gauche et droit
-  shared_ptr<Symbol> leftVal =
-      visit(ctx->expr(0)).as<shared_ptr<Symbol>>();
-  shared_ptr<Symbol> rightVal =
-      visit(ctx->expr(1)).as<shared_ptr<Symbol>>();
-
-  // Vérifie si les opérandes sont valides
-  if (leftVal == nullptr || rightVal == nullptr)
+  bool result = currentCFG->add_symbol(id, name(id), type, location.line);
+  if (!result)
   {
-    ErrorListenerVisitor::addError(
-        ctx, "Invalid operation with function returning void");
+    string error = "The variable " + name(id) + " has already been declared";
+    ErrorListenerVisitor::addError(location, error, ErrorType::Error);
   }
-
-  // Ajoute une instruction IR pour l'opération OR
-  return currentCFG->current_bb->add_IRInstr(IRInstr::b_or, Type::INT,
-                                         {leftVal, rightVal});
+  return result;
 }
 
-// Visite du nœud B_xor pour gérer les opérations binaires XOR (^)
-antlrcpp::Any CodeGenVisitor::visitB_xor(ifccParser::B_xorContext *ctx)
+// Récupère un symbole de la table des symboles, en signalant son absence
+shared_ptr<Symbol> CodeGenVisitor::getSymbolFromSymbolTable(const SourceLocation &location,
+                                                            Identifier id)
 {
-  // Évalue les opérandes gauche et droit
-  shared_ptr<Symbol> leftVal =
-      visit(ctx->expr(0)).as<shared_ptr<Symbol>>();
-  shared_ptr<Symbol> rightVal =
-      visit(ctx->expr(1)).as<shared_ptr<Symbol>>();
-
-  // Vérifie si les opérandes sont valides
-  if (leftVal == nullptr || rightVal == nullptr)
+  shared_ptr<Symbol> symbole = currentCFG->get_symbol(id);
+  if (symbole == nullptr)
   {
-    ErrorListenerVisitor::addError(
-        ctx, "Invalid operation with function returning void");
+    const string error = "Symbol not found: " + name(id);
+    ErrorListenerVisitor::addError(location, error, ErrorType::Error);
+    return nullptr;
   }
 
-  // Ajoute une instruction IR pour l'opération XOR
-  return currentCFG->current_bb->add_IRInstr(IRInstr::b_xor, Type::INT,
-                                         {leftVal, rightVal});
+  symbole->used = true;
+  return symbole;
 }
 
-// Visite du nœud UnaryOp pour gérer les opérations unaires (-, ~, !, ++, --, +)
-antlrcpp::Any CodeGenVisitor::visitUnaryOp(ifccParser::UnaryOpContext *ctx)
+// Gère les opérations unaires (-, ~, !, ++, --, +)
+Operand CodeGenVisitor::visitUnary(const UnaryExpr *expr)
 {
   // Évalue l'opérande
-  shared_ptr<Symbol> val =
-      visit(ctx->expr()).as<shared_ptr<Symbol>>();
+  Operand val = visitExpression(expr->operand);
   IRInstr::Operation instr;
 
   // Détermine l'opération en fonction de l'opérateur unaire
-  if (ctx->op->getText() == "-")
-  {
-    // Négation arithmétique
-    instr = IRInstr::neg;
-    return currentCFG->current_bb->add_IRInstr(instr, Type::INT, {val});
-  }
-  else if (ctx->op->getText() == "~")
-  {
-    // Négation binaire
-    instr = IRInstr::not_;
-    return currentCFG->current_bb->add_IRInstr(instr, Type::INT, {val});
-  }
-  else if (ctx->op->getText() == "!")
-  {
-    // Négation logique
-    instr = IRInstr::lnot;
-    return currentCFG->current_bb->add_IRInstr(instr, Type::INT, {val});
-  }
-  else if (ctx->op->getText() == "++")
-  {
-    // Incrémentation
-    instr = IRInstr::inc;
-    return currentCFG->current_bb->add_IRInstr(instr, Type::INT, {val});
-  }
-  else if (ctx->op->getText() == "--")
-  {
-    // Décrémentation
-    instr = IRInstr::dec;
-    return currentCFG->current_bb->add_IRInstr(instr, Type::INT, {val});
-  }
-  else if (ctx->op->getText() == "+")
-  {
+  switch (expr->op)
+  {
+  case UnaryOperator::Negate: instr = IRInstr::neg; break;      // Négation arithmétique
+  case UnaryOperator::BitNot: instr = IRInstr::not_; break;     // Négation binaire
+  case UnaryOperator::LogicalNot: instr = IRInstr::lnot; break; // Négation logique
+  case UnaryOperator::Increment: instr = IRInstr::inc; break;   // Incrémentation
+  case UnaryOperator::Decrement: instr = IRInstr::dec; break;   // Décrémentation
+  default:
     // Opérateur unaire + (aucune opération nécessaire)
     return val;
   }
-
-  // Retourne nullptr si l'opérateur n'est pas reconnu
-  return nullptr;
+  return currentCFG->current_bb->add_IRInstr(instr, Type::INT, {val});
 }
 
-antlrcpp::Any CodeGenVisitor::visitPostIncDec(ifccParser::PostIncDecContext *ctx)
+// Gère x++ et x-- : la valeur de l'expression est celle d'avant l'opération
+Operand CodeGenVisitor::visitPostIncDec(const IncDecExpr *expr)
 {
-  shared_ptr<Symbol> symbole = getSymbolFromSymbolTableByContext(ctx, ctx->ID()->getText());
-
-  // Récupérer l'opérateur à partir du texte brut
-  std::string fullText = ctx->getText();
-  std::string op = fullText.substr(fullText.size() - 2); // Les deux derniers caractères
-
-  IRInstr::Operation operation = (op == "++") ? IRInstr::inc : IRInstr::dec;
+  shared_ptr<Symbol> symbole = getSymbolFromSymbolTable(expr->location, expr->name);
+  IRInstr::Operation operation = expr->increment ? IRInstr::inc : IRInstr::dec;
 
   // Sauvegarde de la valeur avant incrémentation
   shared_ptr<Symbol> temp = currentCFG->create_new_tempvar(Type::INT);
@@ -724,15 +723,11 @@ antlrcpp::Any CodeGenVisitor::visitPostIncDec(ifccParser::PostIncDecContext *ctx
   return temp;
 }
 
-antlrcpp::Any CodeGenVisitor::visitPreIncDec(ifccParser::PreIncDecContext *ctx)
+// Gère ++x et --x : la variable elle-même est le résultat
+Operand CodeGenVisitor::visitPreIncDec(const IncDecExpr *expr)
 {
-  shared_ptr<Symbol> symbole = getSymbolFromSymbolTableByContext(ctx, ctx->ID()->getText());
-
-  // Récupérer l'opérateur à partir du texte brut
-  std::string fullText = ctx->getText();
-  std::string op = fullText.substr(0, 2); // Les deux premiers caractères
-
-  IRInstr::Operation operation = (op == "++") ? IRInstr::inc : IRInstr::dec;
+  shared_ptr<Symbol> symbole = getSymbolFromSymbolTable(expr->location, expr->name);
+  IRInstr::Operation operation = expr->increment ? IRInstr::inc : IRInstr::dec;
 
   // Incrémentation avant utilisation
   currentCFG->current_bb->add_IRInstr(operation, Type::INT, {symbole});
@@ -740,54 +735,57 @@ antlrcpp::Any CodeGenVisitor::visitPreIncDec(ifccParser::PreIncDecContext *ctx)
   return symbole;
 }
 
-antlrcpp::Any CodeGenVisitor::visitLogicalOr(ifccParser::LogicalOrContext *ctx) {
-  string falseLabel = ".L" + to_string(nextLabel++);
-  string endLabel = ".L" + to_string(nextLabel++);
-  
-  shared_ptr<Symbol> left = visit(ctx->expr(0)).as<shared_ptr<Symbol>>();
-  shared_ptr<Symbol> result = currentCFG->create_new_tempvar(Type::INT);
-  
-  // Évaluation paresseuse - si gauche est vrai, résultat est vrai
-  currentCFG->current_bb->add_IRInstr(IRInstr::cmpNZ, Type::INT, {left});
-  currentCFG->current_bb->add_IRInstr(IRInstr::ldconst, Type::INT, {"1"});
-  currentCFG->current_bb->add_IRInstr(IRInstr::var_assign, Type::INT, {result, left});
-  
-  BasicBlock* falseBB = new BasicBlock(currentCFG.get(), falseLabel);
-  BasicBlock* endBB = new BasicBlock(currentCFG.get(), endLabel);
-  
-  currentCFG->current_bb->exit_false = falseBB;
-  currentCFG->current_bb->exit_true = endBB;
-  
-  currentCFG->add_bb(falseBB);
-  shared_ptr<Symbol> right = visit(ctx->expr(1)).as<shared_ptr<Symbol>>();
-  currentCFG->current_bb->add_IRInstr(IRInstr::var_assign, Type::INT, {result, right});
-  
-  currentCFG->add_bb(endBB);
-  return result;
-}
+/**
+ * Gère && et || avec évaluation paresseuse : l'opérande droit n'est évalué
+ * que si l'opérande gauche ne suffit pas à déterminer le résultat.
+ * Les && et || imbriqués dans l'opérande gauche (a && b || c && ...) sont
+ * traités sans récursion : leurs blocs sont nommés en descendant la branche
+ * gauche, puis chaque opération est terminée en la remontant.
+ * @param expr L'opération (LogicalAnd ou LogicalOr)
+ * @return Le symbole résultat
+ */
+Operand CodeGenVisitor::visitLogical(const BinaryExpr *expr)
+{
+  struct PendingLogical
+  {
+    const BinaryExpr *expr;
+    string rightLabel;
+    string endLabel;
+  };
+  vector<PendingLogical> spine;
+  const Expr *leftmost = expr;
+  while (isLogical(leftmost))
+  {
+    auto logical = static_cast<const BinaryExpr *>(leftmost);
+    string rightLabel = currentCFG->new_BB_name();
+    string endLabel = currentCFG->new_BB_name();
+    spine.push_back({logical, rightLabel, endLabel});
+    leftmost = logical->left;
+  }
 
-antlrcpp::Any CodeGenVisitor::visitLogicalAnd(ifccParser::LogicalAndContext *ctx) {
-  string trueLabel = ".L" + to_string(nextLabel++);
-  string endLabel = ".L" + to_string(nextLabel++);
-  
-  shared_ptr<Symbol> left = visit(ctx->expr(0)).as<shared_ptr<Symbol>>();
-  shared_ptr<Symbol> result = currentCFG->create_new_tempvar(Type::INT);
-  
-  // Évaluation paresseuse - si gauche est faux, résultat est faux
-  currentCFG->current_bb->add_IRInstr(IRInstr::cmpNZ, Type::INT, {left});
-  currentCFG->current_bb->add_IRInstr(IRInstr::ldconst, Type::INT, {"0"});
-  currentCFG->current_bb->add_IRInstr(IRInstr::var_assign, Type::INT, {result, left});
-  
-  BasicBlock* trueBB = new BasicBlock(currentCFG.get(), trueLabel);
-  BasicBlock* endBB = new BasicBlock(currentCFG.get(), endLabel);
-  
-  currentCFG->current_bb->exit_true = trueBB;
-  currentCFG->current_bb->exit_false = endBB;
-  
-  currentCFG->add_bb(trueBB);
-  shared_ptr<Symbol> right = visit(ctx->expr(1)).as<shared_ptr<Symbol>>();
-  currentCFG->current_bb->add_IRInstr(IRInstr::var_assign, Type::INT, {result, right});
-  
-  currentCFG->add_bb(endBB);
-  return result;
-}
\ No newline at end of file
+  Operand left = visitExpression(leftmost);
+  for (auto it = spine.rbegin(); it != spine.rend(); ++it)
+  {
+    bool isOr = it->expr->op == BinaryOperator::LogicalOr;
+    shared_ptr<Symbol> result = currentCFG->create_new_tempvar(Type::INT);
+
+    // Évaluation paresseuse - si gauche est vrai (||) ou faux (&&), il donne le résultat
+    currentCFG->current_bb->add_IRInstr(IRInstr::cmpNZ, Type::INT, {left});
+    currentCFG->current_bb->add_IRInstr(IRInstr::ldconst, Type::INT, {isOr ? "1" : "0"});
+    currentCFG->current_bb->add_IRInstr(IRInstr::var_assign, Type::INT, {result, left});
+
+    BasicBlock *rightBB = currentCFG->create_bb(it->rightLabel);
+    BasicBlock *endBB = currentCFG->create_bb(it->endLabel);
+
+    currentCFG->current_bb->exit_true = isOr ? endBB : rightBB;
+    currentCFG->current_bb->exit_false = isOr ? rightBB : endBB;
+
+    currentCFG->add_bb(rightBB);
+    Operand right = visitExpression(it->expr->right);
+    currentCFG->current_bb->add_IRInstr(IRInstr::var_assign, Type::INT, {result, right});
+
+    currentCFG->add_bb(endBB);
+    left = result;
+  }
+  return left;
+}
@@ -1,148 +1,183 @@
 #pragma once
 
-#include "ParserRuleContext.h"
+#include "Ast.h"
+#include "AstVisitor.h"
 #include "CFG.h"
 #include "Symbol.h"
-#include "antlr4-runtime.h"
-#include "generated/ifccBaseVisitor.h"
 #include "IR.h"
+#include <functional>
 #include <map>
 #include <memory>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 using namespace std;
 
+// Étiquette de Sethi-Ullman d'une expression : nombre de registres nécessaires
+// pour l'évaluer et présence d'effets de bord (appel, incrémentation)
+struct ExpressionLabel
+{
+  int registerNeed;
+  bool hasSideEffects;
+};
+
+// Signature d'une fonction : seule information gardée par le visiteur pour
+// traduire ses appels, une fois son CFG confié à l'appelant
+struct FunctionSignature
+{
+  Type returnType;
+  vector<Type> parameterTypes;
+};
+
+// Résultat de la visite d'une expression : le symbole (variable ou temporaire)
+// qui contient sa valeur, nullptr pour un appel de fonction void
+typedef shared_ptr<Symbol> Operand;
+
 /**
- * @brief Classe de visiteur utilisée pour parcourir l'AST généré par ANTLR
+ * @brief Classe de visiteur utilisée pour parcourir l'arbre abstrait (Ast.h)
  *        et produire le code intermédiaire (IR).
  *
- * Hérite de ifccBaseVisitor (généré automatiquement par ANTLR à partir de la grammaire).
+ * Les nœuds portent des opérateurs et des types déjà décodés : aucun texte
+ * n'est relu pendant la génération de l'IR. L'aiguillage selon la nature des
+ * nœuds est celui d'AstVisitor : chaque expression retourne son Operand.
  */
-class CodeGenVisitor : public ifccBaseVisitor {
+class CodeGenVisitor : public AstVisitor<CodeGenVisitor, Operand> {
+  friend class AstVisitor<CodeGenVisitor, Operand>;
+
 public:
   // Destructeur par défaut
   virtual ~CodeGenVisitor() = default;
 
     // Constructeur
-  CodeGenVisitor();
+  CodeGenVisitor() = default;
 
-    // Entrée principale du programme
-  virtual antlrcpp::Any visitAxiom(ifccParser::AxiomContext *ctx) override;
-  
-    // Racine du programme (plusieurs fonctions possibles)
+    // Racine du programme (plusieurs fonctions possibles) : le CFG de chaque
+    // fonction est passé à onFunction, avec son indice dans program.functions,
+    // dès qu'il est construit ; le visiteur n'en garde que la signature
+  void visitProgram(Program &program,
+                    const function<void(size_t, shared_ptr<CFG>)> &onFunction);
 
-  virtual antlrcpp::Any visitProg(ifccParser::ProgContext *ctx) override;
-  // Visite d'une fonction complète
+  /**
+   * @brief Désigne des fonctions dont le code est déjà connu (compilation
+   *        incrémentale) : seule leur signature est déclarée, leur corps
+   *        n'est pas visité et aucun CFG n'est construit.
+   */
+  void setPrecompiledFunctions(set<const FunctionDecl *> functions) {
+    precompiledFunctions = move(functions);
+  }
 
-  virtual antlrcpp::Any visitFunc(ifccParser::FuncContext *ctx) override;
-  // Instruction "return"
+private:
+  // Programme en cours de visite (texte des identifiants)
+  Program *program = nullptr;
 
-  virtual antlrcpp::Any visitReturn_stmt(ifccParser::Return_stmtContext *ctx) override;
-  // Déclaration de variable (ex : int x;)
+  // Fonctions à ne pas visiter (voir setPrecompiledFunctions)
+  set<const FunctionDecl *> precompiledFunctions;
 
-  virtual antlrcpp::Any visitVar_decl_stmt(ifccParser::Var_decl_stmtContext *ctx) override;
-  // Affectation de variable (ex : x = 5;)
+  // Texte d'un identifiant du programme
+  inline string name(Identifier id) const { return string(program->spelling(id)); }
 
-  virtual antlrcpp::Any visitVar_assign_stmt(ifccParser::Var_assign_stmtContext *ctx) override;
-  // Expression entre parenthèses
+  // Déclare les signatures de getchar et putchar
+  void declareBuiltins();
 
-  virtual antlrcpp::Any visitPar(ifccParser::ParContext *ctx) override;
-  // Condition "if" sans "else"
+  // Ajoute les paramètres d'une fonction à la table des symboles du CFG courant
+  void declareParameters(const FunctionDecl *function);
 
-  virtual antlrcpp::Any visitIf(ifccParser::IfContext *ctx) override;
-  // Condition "if ... else"
+  // Visite d'une fonction complète
+  void visitFunction(const FunctionDecl *function);
 
-  virtual antlrcpp::Any visitIf_else(ifccParser::If_elseContext *ctx) override;
+  // Instructions (aiguillées par AstVisitor::visitStatement)
+  // Déclaration de variable (ex : int x;)
+  void visitDeclaration(const DeclarationStmt *stmt);
+  // Affectation de variable (ex : x = 5;)
+  void visitAssignment(const AssignmentStmt *stmt);
+  // Condition "if", avec ou sans "else"
+  void visitIf(const IfStmt *stmt);
   // Boucle "while"
-
-  virtual antlrcpp::Any visitWhile_stmt(ifccParser::While_stmtContext *ctx) override;
+  void visitWhile(const WhileStmt *stmt);
   // Bloc de code (ex : { ... })
-
-  virtual antlrcpp::Any visitBlock(ifccParser::BlockContext *ctx) override;
-  // Appel de fonction
-
-  virtual antlrcpp::Any visitFunc_call(ifccParser::Func_callContext *ctx) override;
-  // Opérations * et / (multiplication/division)
-
-  virtual antlrcpp::Any visitMultdiv(ifccParser::MultdivContext *ctx) override;
-  // Opérations + et - (addition/soustraction)
-
-  virtual antlrcpp::Any visitAddsub(ifccParser::AddsubContext *ctx) override;
-  // Comparateurs relationnels (ex : <, >, <=, >=)
-
-  virtual antlrcpp::Any visitCmp(ifccParser::CmpContext *ctx) override;
-  // Comparateurs d'égalité (==, !=)
-
-  virtual antlrcpp::Any visitEq(ifccParser::EqContext *ctx) override;
-  // Valeur littérale ou identifiant
-
-  virtual antlrcpp::Any visitVal(ifccParser::ValContext *ctx) override;
-  // Opération bitwise AND ( & )
-
-  virtual antlrcpp::Any visitB_and(ifccParser::B_andContext *ctx) override;
-  // Opération bitwise OR ( | )
-
-  virtual antlrcpp::Any visitB_or(ifccParser::B_orContext *ctx) override;
-  // Opération bitwise XOR ( ^ )
-
-  virtual antlrcpp::Any visitB_xor(ifccParser::B_xorContext *ctx) override;
+  void visitBlock(const BlockStmt *stmt);
+  // Expression seule (ex : f(x);)
+  void visitExpressionStatement(const ExpressionStmt *stmt);
+  // Instruction "return"
+  void visitReturn(const ReturnStmt *stmt);
+
+  // Expressions (aiguillées par AstVisitor::visitExpression) : chacune
+  // retourne le symbole qui contient sa valeur
+  // Valeur littérale
+  Operand visitConstant(const ConstantExpr *expr);
+  // Lecture d'une variable
+  Operand visitVariable(const VariableExpr *expr);
   // Opérateurs unaires (ex : -x, !x, ~x)
+  Operand visitUnary(const UnaryExpr *expr);
+  // Opérateurs binaires arithmétiques, de comparaison et bit à bit
+  Operand visitBinary(const BinaryExpr *expr);
+  // Opérateurs && et || (évaluation paresseuse)
+  Operand visitLogical(const BinaryExpr *expr);
+  // Appel de fonction
+  Operand visitCall(const CallExpr *expr);
+  Operand visitPreIncDec(const IncDecExpr *expr);
+  Operand visitPostIncDec(const IncDecExpr *expr);
 
-  virtual antlrcpp::Any visitUnaryOp(ifccParser::UnaryOpContext *ctx) override;
-  
-  virtual antlrcpp::Any visitPostIncDec(ifccParser::PostIncDecContext *ctx) override;
-
-  virtual antlrcpp::Any visitPreIncDec(ifccParser::PreIncDecContext *ctx) override;
-
-  virtual antlrcpp::Any visitLogicalOr(ifccParser::LogicalOrContext *ctx) override;
-
-  virtual antlrcpp::Any visitLogicalAnd(ifccParser::LogicalAndContext *ctx) override;
-  /**
-   * @brief Accès à la liste des CFG (Control Flow Graphs) générés pour chaque fonction
-   */
-  const vector<shared_ptr<CFG>> &getCfgList() const {
-    return functionCFGs;
-  }
-
-  /**
-   * @brief Récupère le CFG correspondant à une fonction par son nom
-   */
-  CFG *getFunction(const string &id) { return functions[id].get(); }
-
-private:
-  // Numéro utilisé pour générer des labels uniques dans l'IR (pour les sauts)
-  int nextLabel = 1;
-
-    // Liste des CFG générés pour chaque fonction rencontrée
-
-  vector<shared_ptr<CFG>> functionCFGs;
-    // Map des fonctions par nom, associées à leur CFG
+    // Map des fonctions déjà rencontrées par nom, associées à leur signature
 
-  map<string, shared_ptr<CFG>> functions;
+  map<string, FunctionSignature> functions;
     // CFG courant, modifié à chaque nouvelle fonction rencontrée
 
   shared_ptr<CFG> currentCFG;
-  // Buffer interne pour stocker du code assembleur éventuel
-
-  stringstream assembly;
 
  /**
    * @brief Ajoute un symbole (variable, paramètre...) à la table des symboles du CFG courant,
    *        en vérifiant s'il n'est pas déjà déclaré.
    *
-   * @param ctx Le contexte ANTLR correspondant
-   * @param id  Le nom de l'identifiant à ajouter
+   * @param location La position de la déclaration
+   * @param id  L'identifiant interné à ajouter
    * @param type Le type de la variable (int, char, etc.)
    */
-  bool addSymbolToSymbolTableFromContext(antlr4::ParserRuleContext *ctx, const string &id,
-    Type type);
+  bool addSymbolToSymbolTable(const SourceLocation &location, Identifier id, Type type);
 
 /**
 * @brief Récupère un symbole depuis la table des symboles du CFG courant,
-*        avec vérification du contexte.
+*        en signalant une erreur s'il n'est pas déclaré.
 *
-* @param ctx Le contexte ANTLR où apparaît le symbole
-* @param id  Le nom de l'identifiant à récupérer
+* @param location La position où apparaît le symbole
+* @param id  L'identifiant interné à récupérer
 */
-shared_ptr<Symbol> getSymbolFromSymbolTableByContext(antlr4::ParserRuleContext *ctx,
-                       const string &id);
-};
\ No newline at end of file
+shared_ptr<Symbol> getSymbolFromSymbolTable(const SourceLocation &location, Identifier id);
+
+  // Étiquettes de Sethi-Ullman déjà calculées, par nœud d'expression de la
+  // fonction courante
+  unordered_map<const Expr *, ExpressionLabel> expressionLabels;
+
+  /**
+   * @brief Calcule (et mémorise) l'étiquette de Sethi-Ullman d'une expression.
+   */
+  ExpressionLabel labelExpression(const Expr *expr);
+
+  // Opération binaire en cours d'évaluation (voir visitBinary) : une chaîne
+  // du même opérateur associatif y est mise à plat en ses opérandes
+  struct PendingChain
+  {
+    IRInstr::Operation instr;
+    bool checkVoidOperands = true; // Signale un opérande issu d'une fonction void
+    // Opérandes dans l'ordre du source, avec l'opération dont chacun est l'enfant
+    vector<pair<const Expr *, const BinaryExpr *>> operands;
+    vector<size_t> order; // Ordre d'évaluation (indices dans operands)
+    size_t next = 0;      // Prochain opérande à évaluer (indice dans order)
+    Operand accumulator;  // Valeur des opérandes déjà évalués
+    size_t firstOperand = 0; // Plus à gauche des opérandes déjà évalués
+    vector<const BinaryExpr *> reported; // Opérations déjà signalées (void)
+  };
+
+  /**
+   * @brief Met à plat une opération binaire et choisit l'ordre d'évaluation
+   *        de ses opérandes.
+   */
+  PendingChain prepareChain(const BinaryExpr *expr);
+
+  /**
+   * @brief Cumule la valeur du prochain opérande d'une chaîne.
+   */
+  void accumulate(PendingChain &chain, Operand value);
+};
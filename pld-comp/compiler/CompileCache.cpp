@@ -0,0 +1,280 @@
+#include "CompileCache.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <dirent.h>
+#include <fcntl.h>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+#include "AsmWriter.h"
+#include "Compiler.h"
+#include "IncludeCache.h"
+#include "Sha256.h"
+#include "SourceFile.h"
+
+// En-tête des entrées, à changer si leur format change
+static const char entryHeader[] = "ifcc-cache 2\n";
+
+// Nombre de sous-répertoires (deux chiffres hexadécimaux de l'empreinte)
+static const int subdirectoryCount = 256;
+
+/**
+ * @param directory Le répertoire du cache (créé au besoin)
+ * @param maximumSize La taille totale visée, en octets
+ */
+CompileCache::CompileCache(const string &directory, uint64_t maximumSize)
+    : directory(directory), maximumSize(maximumSize) {}
+
+// Identité de la build, fixée à la compilation par le Makefile (empreinte des
+// sources), pour qu'un compilateur reconstruit ne réutilise pas les anciennes
+// entrées même si sa version n'a pas changé. À défaut, la date de
+// compilation de ce fichier en tient lieu.
+#ifndef IFCC_BUILD_ID
+#define IFCC_BUILD_ID __DATE__ " " __TIME__
+#endif
+
+/**
+ * Calcule la clé d'une compilation. La version du compilateur et l'identité
+ * de la build en font partie.
+ * @param source Le texte du programme
+ * @param options Les options qui influent sur le résultat, sous forme de texte
+ */
+string CompileCache::computeKey(string_view source, const string &options)
+{
+  Sha256 hash;
+  hash.update(compilerVersion());
+  hash.update(string_view("\0", 1));
+  hash.update(IFCC_BUILD_ID);
+  hash.update(string_view("\0", 1));
+  hash.update(options);
+  hash.update(string_view("\0", 1));
+  hash.update(source);
+  return hash.hexDigest();
+}
+
+// Extrait la prochaine ligne (sans le '\n') ; false s'il n'y en a pas
+static bool nextLine(string_view &text, string_view &line)
+{
+  size_t end = text.find('\n');
+  if (end == string_view::npos)
+  {
+    return false;
+  }
+  line = text.substr(0, end);
+  text.remove_prefix(end + 1);
+  return true;
+}
+
+string CompileCache::entryPath(const string &key) const
+{
+  return directory + "/" + key.substr(0, 2) + "/" + key.substr(2);
+}
+
+/**
+ * Cherche une compilation dans le cache. Une entrée illisible ou d'un
+ * autre format compte comme un échec, tout comme une entrée dont un fichier
+ * inclus a changé, est apparu ou a disparu depuis la compilation.
+ * @param includeCache Où relire les fichiers inclus (nullptr : sans cache)
+ * @return true si l'entrée a été trouvée et lue dans entry
+ */
+bool CompileCache::lookup(const string &key, CachedCompilation &entry,
+                          IncludeCache *includeCache)
+{
+  string path = entryPath(key);
+  SourceFile file;
+  if (!file.open(path))
+  {
+    misses++;
+    return false;
+  }
+  string_view contents = file.contents();
+  size_t headerLength = sizeof(entryHeader) - 1;
+  if (contents.substr(0, headerLength) != entryHeader)
+  {
+    misses++;
+    return false;
+  }
+
+  // Fichiers inclus : un nombre, puis une ligne "empreinte|- chemin" chacun
+  contents.remove_prefix(headerLength);
+  string_view line;
+  size_t count = 0;
+  bool valid = nextLine(contents, line) && sscanf(string(line).c_str(), "%zu", &count) == 1;
+  entry.includes.clear();
+  for (size_t i = 0; i < count && valid; i++)
+  {
+    size_t space = 0;
+    valid = nextLine(contents, line) && (space = line.find(' ')) != string_view::npos;
+    if (valid)
+    {
+      string_view digest = line.substr(0, space);
+      entry.includes.push_back(
+          {string(line.substr(space + 1)), digest == "-" ? "" : string(digest)});
+    }
+  }
+
+  // Diagnostics : un nombre, puis une ligne "E|W ligne colonne message"
+  // chacun ; le reste de l'entrée est l'assembleur
+  valid = valid && nextLine(contents, line) && sscanf(string(line).c_str(), "%zu", &count) == 1;
+  entry.diagnostics.clear();
+  for (size_t i = 0; i < count && valid; i++)
+  {
+    char severity = 0;
+    int messageStart = 0;
+    Diagnostic diagnostic{ErrorType::Warning, 0, 0, ""};
+    valid = nextLine(contents, line);
+    string text(line);
+    valid = valid && sscanf(text.c_str(), "%c %zu %zu %n", &severity, &diagnostic.line,
+                            &diagnostic.column, &messageStart) == 3 && messageStart > 0;
+    if (valid)
+    {
+      diagnostic.severity = severity == 'E' ? ErrorType::Error : ErrorType::Warning;
+      diagnostic.message = text.substr(messageStart);
+      entry.diagnostics.push_back(diagnostic);
+    }
+  }
+  if (!valid)
+  {
+    misses++;
+    return false;
+  }
+  entry.assembly = contents;
+
+  // Les #include doivent encore trouver les mêmes fichiers, au même contenu
+  IncludeCache ownCache;
+  for (const IncludeDependency &include : entry.includes)
+  {
+    shared_ptr<const IncludedFile> file =
+        (includeCache != nullptr ? includeCache : &ownCache)->load(include.path);
+    if ((file != nullptr ? file->digest : "") != include.digest)
+    {
+      misses++;
+      return false;
+    }
+  }
+
+  // Marque l'entrée comme récemment utilisée pour l'éviction
+  utimensat(AT_FDCWD, path.c_str(), nullptr, 0);
+  hits++;
+  return true;
+}
+
+/**
+ * Ajoute une compilation au cache. Les erreurs (disque plein, droits...) sont
+ * ignorées : le cache n'est qu'une accélération.
+ */
+void CompileCache::store(const string &key, const CachedCompilation &entry)
+{
+  // Crée le sous-répertoire et ses parents au besoin
+  string subdirectory = directory + "/" + key.substr(0, 2);
+  for (size_t slash = subdirectory.find('/', 1); slash != string::npos;
+       slash = subdirectory.find('/', slash + 1))
+  {
+    mkdir(subdirectory.substr(0, slash).c_str(), 0755);
+  }
+  mkdir(subdirectory.c_str(), 0755);
+
+  AsmWriter contents(entry.assembly.size() + 256);
+  contents << entryHeader << (long long)entry.includes.size() << '\n';
+  for (const IncludeDependency &include : entry.includes)
+  {
+    // Un chemin sur plusieurs lignes ne pourrait pas être relu
+    if (include.path.find('\n') != string::npos)
+    {
+      return;
+    }
+    contents << (include.digest.empty() ? "-" : include.digest) << ' ' << include.path << '\n';
+  }
+  contents << (long long)entry.diagnostics.size() << '\n';
+  for (const Diagnostic &diagnostic : entry.diagnostics)
+  {
+    string message = diagnostic.message;
+    replace(message.begin(), message.end(), '\n', ' ');
+    contents << (diagnostic.severity == ErrorType::Error ? 'E' : 'W') << ' '
+             << (long long)diagnostic.line << ' ' << (long long)diagnostic.column << ' '
+             << message << '\n';
+  }
+  contents << entry.assembly;
+
+  // Écriture dans un fichier temporaire propre à ce thread, puis renommage
+  // atomique : un lecteur voit l'ancienne entrée, la nouvelle ou aucune
+  ostringstream temporary;
+  temporary << entryPath(key) << ".tmp." << getpid() << "." << this_thread::get_id();
+  if (!contents.writeToFile(temporary.str()) ||
+      rename(temporary.str().c_str(), entryPath(key).c_str()) != 0)
+  {
+    unlink(temporary.str().c_str());
+    return;
+  }
+  stores++;
+  evict(subdirectory);
+}
+
+/**
+ * Supprime les entrées les moins récemment utilisées d'un sous-répertoire
+ * tant qu'il dépasse sa part de la taille maximale. Seul le sous-répertoire
+ * qui vient de grandir est parcouru, ce qui garde le coût d'un ajout borné.
+ */
+void CompileCache::evict(const string &subdirectory)
+{
+  struct Entry
+  {
+    string path;
+    uint64_t size;
+    timespec lastUse;
+  };
+  vector<Entry> entries;
+  uint64_t totalSize = 0;
+  DIR *listing = opendir(subdirectory.c_str());
+  if (listing == nullptr)
+  {
+    return;
+  }
+  while (dirent *file = readdir(listing))
+  {
+    struct stat info;
+    string path = subdirectory + "/" + file->d_name;
+    // Seules les entrées sont concernées, pas les fichiers temporaires
+    if (strlen(file->d_name) != 62 || stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode))
+    {
+      continue;
+    }
+    entries.push_back({path, (uint64_t)info.st_size, modificationTime(info)});
+    totalSize += info.st_size;
+  }
+  closedir(listing);
+
+  uint64_t share = maximumSize / subdirectoryCount;
+  if (totalSize <= share)
+  {
+    return;
+  }
+  sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b)
+       { return a.lastUse.tv_sec != b.lastUse.tv_sec ? a.lastUse.tv_sec < b.lastUse.tv_sec
+                                                     : a.lastUse.tv_nsec < b.lastUse.tv_nsec; });
+  for (const Entry &entry : entries)
+  {
+    if (totalSize <= share)
+    {
+      break;
+    }
+    if (unlink(entry.path.c_str()) == 0)
+    {
+      evictions++;
+    }
+    totalSize -= entry.size;
+  }
+}
+
+void CompileCache::printStats(ostream &o) const
+{
+  o << "cache: hits: " << hits << "\n";
+  o << "cache: misses: " << misses << "\n";
+  o << "cache: stores: " << stores << "\n";
+  o << "cache: evictions: " << evictions << "\n";
+}
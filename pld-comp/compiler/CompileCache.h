@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Diagnostics.h"
+
+using namespace std;
+
+class IncludeCache;
+
+// ========== Structure IncludeDependency ==========
+// Fichier cherché pour un #include par une compilation : l'entrée du cache
+// n'est reprise que si chacun est encore dans le même état
+struct IncludeDependency
+{
+  string path;
+  string digest; // Empreinte SHA-256 du contenu ("" : le fichier n'existait pas)
+};
+
+// ========== Structure CachedCompilation ==========
+// Ce qui est rejoué lors d'un succès du cache : l'assembleur et les
+// avertissements de la compilation d'origine, avec les fichiers inclus dont
+// elle dépend
+struct CachedCompilation
+{
+  string assembly;
+  vector<Diagnostic> diagnostics;
+  vector<IncludeDependency> includes;
+};
+
+// ========== Classe CompileCache ==========
+// Cache sur disque des compilations réussies, adressé par le contenu : la
+// clé est l'empreinte SHA-256 du source, de la version du compilateur et des
+// options. Chaque entrée est un fichier <répertoire>/<2 chiffres>/<empreinte>
+// écrit dans un fichier temporaire puis renommé, pour que plusieurs
+// compilateurs puissent partager le cache. Une entrée lue est "touchée" ; les
+// entrées les moins récemment utilisées sont supprimées quand un
+// sous-répertoire dépasse sa part de la taille maximale. Une entrée retient
+// aussi les fichiers cherchés par ses #include, vérifiés à chaque lecture.
+class CompileCache
+{
+public:
+  CompileCache(const string &directory, uint64_t maximumSize);
+
+  // Clé d'une compilation
+  static string computeKey(string_view source, const string &options);
+
+  // Entrée de la clé, si les fichiers inclus dont elle dépend n'ont pas changé
+  bool lookup(const string &key, CachedCompilation &entry, IncludeCache *includeCache = nullptr);
+  void store(const string &key, const CachedCompilation &entry);
+
+  // Affiche "cache: hits: N" et les autres compteurs
+  void printStats(ostream &o) const;
+
+private:
+  string directory;
+  uint64_t maximumSize;
+  atomic<unsigned> hits{0};
+  atomic<unsigned> misses{0};
+  atomic<unsigned> stores{0};
+  atomic<unsigned> evictions{0};
+
+  string entryPath(const string &key) const;
+  void evict(const string &subdirectory);
+};
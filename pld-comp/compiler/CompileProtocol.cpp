@@ -0,0 +1,204 @@
+#include "CompileProtocol.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "AsmWriter.h"
+
+// Protège le serveur contre une longueur aberrante (client défectueux)
+static const uint32_t maximumFieldLength = 1u << 30;
+static const unsigned long maximumIncludePaths = 1u << 16;
+
+// Ajoute un champ au message : longueur sur 4 octets puis contenu
+static void appendField(AsmWriter &message, const string &field)
+{
+  uint32_t length = field.size();
+  for (int i = 0; i < 4; i++)
+  {
+    message << (char)((length >> (8 * i)) & 0xff);
+  }
+  message << field;
+}
+
+// Lit exactement size octets ; false si la connexion est fermée avant
+static bool readFully(int fd, char *data, size_t size)
+{
+  while (size > 0)
+  {
+    ssize_t count = read(fd, data, size);
+    if (count < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (count <= 0)
+    {
+      return false;
+    }
+    data += count;
+    size -= count;
+  }
+  return true;
+}
+
+static bool readField(int fd, string &field)
+{
+  unsigned char header[4];
+  if (!readFully(fd, (char *)header, sizeof(header)))
+  {
+    return false;
+  }
+  uint32_t length = header[0] | header[1] << 8 | header[2] << 16 | (uint32_t)header[3] << 24;
+  if (length > maximumFieldLength)
+  {
+    return false;
+  }
+  field.resize(length);
+  return readFully(fd, field.data(), length);
+}
+
+// Crée une adresse de socket Unix ; false si le chemin est trop long
+static bool makeAddress(const string &path, sockaddr_un &address)
+{
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path))
+  {
+    return false;
+  }
+  memcpy(address.sun_path, path.c_str(), path.size() + 1);
+  return true;
+}
+
+// Socket Unix fermée par exec (SOCK_CLOEXEC n'existe pas sous macOS)
+static int openSocket()
+{
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd >= 0)
+  {
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+  }
+  return fd;
+}
+
+int listenOnSocket(const string &path)
+{
+  sockaddr_un address;
+  if (!makeAddress(path, address))
+  {
+    return -1;
+  }
+  int fd = openSocket();
+  if (fd < 0)
+  {
+    return -1;
+  }
+  unlink(path.c_str()); // Socket laissée par un serveur précédent
+  if (bind(fd, (sockaddr *)&address, sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0)
+  {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+int connectToSocket(const string &path)
+{
+  sockaddr_un address;
+  if (!makeAddress(path, address))
+  {
+    return -1;
+  }
+  int fd = openSocket();
+  if (fd < 0)
+  {
+    return -1;
+  }
+  if (connect(fd, (sockaddr *)&address, sizeof(address)) != 0)
+  {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// Chaque message est construit en entier puis écrit en un seul appel
+bool sendRequest(int fd, const ServerRequest &request)
+{
+  AsmWriter message(request.source.size() + request.sourceName.size() + 64);
+  appendField(message, request.sourceName);
+  appendField(message, request.source);
+  appendField(message, request.dumpIR);
+  appendField(message, request.stats ? "1" : "0");
+  appendField(message, request.nativeLexer ? "1" : "0");
+  appendField(message, request.nativeParser ? "1" : "0");
+  appendField(message, request.workingDirectory);
+  appendField(message, to_string(request.includePaths.size()));
+  for (const string &path : request.includePaths)
+  {
+    appendField(message, path);
+  }
+  return message.writeTo(fd);
+}
+
+bool receiveRequest(int fd, ServerRequest &request)
+{
+  string stats, nativeLexer, nativeParser, includeCount;
+  if (!readField(fd, request.sourceName) || !readField(fd, request.source) ||
+      !readField(fd, request.dumpIR) || !readField(fd, stats) ||
+      !readField(fd, nativeLexer) || !readField(fd, nativeParser) ||
+      !readField(fd, request.workingDirectory) || !readField(fd, includeCount))
+  {
+    return false;
+  }
+  request.stats = stats == "1";
+  request.nativeLexer = nativeLexer == "1";
+  request.nativeParser = nativeParser == "1";
+
+  // Nombre de répertoires -I, puis chacun dans son champ
+  char *end = nullptr;
+  unsigned long count = strtoul(includeCount.c_str(), &end, 10);
+  if (includeCount.empty() || *end != '\0' || count > maximumIncludePaths)
+  {
+    return false;
+  }
+  request.includePaths.resize(count);
+  for (string &path : request.includePaths)
+  {
+    if (!readField(fd, path))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool sendReply(int fd, const ServerReply &reply)
+{
+  AsmWriter message(reply.assembly.size() + reply.diagnostics.size() +
+                    reply.irDump.size() + reply.stats.size() + 64);
+  appendField(message, reply.success ? "1" : "0");
+  appendField(message, reply.assembly);
+  appendField(message, reply.diagnostics);
+  appendField(message, reply.irDump);
+  appendField(message, reply.stats);
+  return message.writeTo(fd);
+}
+
+bool receiveReply(int fd, ServerReply &reply)
+{
+  string success;
+  if (!readField(fd, success) || !readField(fd, reply.assembly) ||
+      !readField(fd, reply.diagnostics) || !readField(fd, reply.irDump) ||
+      !readField(fd, reply.stats))
+  {
+    return false;
+  }
+  reply.success = success == "1";
+  return true;
+}
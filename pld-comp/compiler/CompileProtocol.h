@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// ========== Protocole du serveur de compilation ==========
+// Échanges entre "ifcc --client" (ou tout autre client) et "ifcc --server"
+// sur une socket Unix. Une connexion peut enchaîner plusieurs requêtes ;
+// chaque message est une suite de champs, chacun précédé de sa longueur
+// (4 octets, petit-boutiste). Ce fichier ne dépend pas d'ANTLR, pour que
+// les clients restent légers.
+
+// Requête : compiler un source
+struct ServerRequest
+{
+  string sourceName; // Nom du source dans les diagnostics
+  string source;     // Texte du programme
+  string dumpIR;     // Passe après laquelle afficher l'IR ("" : aucune)
+  bool stats = false; // Statistiques de l'optimiseur à lucarne demandées
+  bool nativeLexer = true;   // -flexer=native (sinon antlr)
+  bool nativeParser = false; // -fparser=native (sinon antlr)
+  vector<string> includePaths; // Répertoires de -I, dans l'ordre
+  string workingDirectory;     // Répertoire courant du client (chemins relatifs)
+};
+
+// Réponse : ce qu'aurait produit ifcc pour ce source
+struct ServerReply
+{
+  bool success = false;
+  string assembly;    // Code assembleur (sortie standard ou -o)
+  string diagnostics; // Diagnostics formatés (sortie d'erreur)
+  string irDump;      // IR affiché avec -dump-ir (sortie d'erreur)
+  string stats;       // Statistiques avec -stats (sortie d'erreur)
+};
+
+// Crée la socket d'écoute (remplace une socket existante) ; -1 en cas d'erreur
+int listenOnSocket(const string &path);
+// Se connecte au serveur ; -1 en cas d'erreur
+int connectToSocket(const string &path);
+
+// Envoi et réception d'un message complet ; false si la connexion est
+// fermée ou si le message est invalide
+bool sendRequest(int fd, const ServerRequest &request);
+bool receiveRequest(int fd, ServerRequest &request);
+bool sendReply(int fd, const ServerReply &reply);
+bool receiveReply(int fd, ServerReply &reply);
@@ -0,0 +1,148 @@
+#include "CompileServer.h"
+
+#include <cerrno>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+#include "Compiler.h"
+#include "CompileProtocol.h"
+#include "IncludeCache.h"
+#include "ThreadPool.h"
+
+// Chemin de la socket, supprimée lorsque le serveur est arrêté par un signal
+static char socketToRemove[108];
+
+static void stopServer(int)
+{
+  unlink(socketToRemove);
+  _exit(0);
+}
+
+// Connexions servies en même temps, un thread chacune : les suivantes
+// attendent dans la file de la socket qu'une connexion se termine
+static const unsigned maximumConnections = 64;
+static mutex connectionLock;
+static condition_variable connectionClosed;
+static unsigned openConnections = 0;
+
+/**
+ * Compile une requête, avec la même sortie que ifcc sur la ligne de commande
+ * @param request Le source et les options de la requête
+ * @param pool Le pool partagé entre toutes les connexions
+ * @param includeCache Les fichiers inclus, partagés entre toutes les requêtes
+ */
+static ServerReply compileRequest(const ServerRequest &request, ThreadPool &pool,
+                                  IncludeCache &includeCache)
+{
+  ServerReply reply;
+  CompileOptions options;
+  options.sourceName = request.sourceName;
+  options.pool = &pool;
+  options.includeCache = &includeCache;
+  options.nativeLexer = request.nativeLexer;
+  options.nativeParser = request.nativeParser;
+  options.includePaths = request.includePaths;
+  options.workingDirectory = request.workingDirectory;
+  if (!request.dumpIR.empty() && !parseIRPass(request.dumpIR, options.dumpAfter))
+  {
+    reply.diagnostics = "error: unknown pass for -dump-ir: " + request.dumpIR + "\n";
+    return reply;
+  }
+
+  CompileResult result = compile(request.source, options);
+  reply.success = result.success;
+  if (result.success)
+  {
+    reply.assembly.assign(result.assembly.data(), result.assembly.size());
+  }
+  AsmWriter diagnostics(0);
+  printDiagnostics(diagnostics, result.diagnostics);
+  reply.diagnostics.assign(diagnostics.data(), diagnostics.size());
+  reply.irDump.assign(result.irDump.data(), result.irDump.size());
+  if (request.stats)
+  {
+    ostringstream stats;
+    result.peepholeStats.print(stats);
+    reply.stats = stats.str();
+  }
+  return reply;
+}
+
+// Sert les requêtes d'une connexion jusqu'à sa fermeture par le client
+static void serveConnection(int connection, ThreadPool &pool, IncludeCache &includeCache)
+{
+  ServerRequest request;
+  while (receiveRequest(connection, request))
+  {
+    if (!sendReply(connection, compileRequest(request, pool, includeCache)))
+    {
+      break;
+    }
+  }
+  close(connection);
+  lock_guard<mutex> guard(connectionLock);
+  openConnections--;
+  connectionClosed.notify_one();
+}
+
+/**
+ * Démarre le serveur et accepte les connexions indéfiniment
+ * @param socketPath Le chemin de la socket Unix à créer
+ * @param jobs Le nombre de threads du pool de génération de code
+ */
+int runCompileServer(const string &socketPath, unsigned jobs)
+{
+  int listener = listenOnSocket(socketPath);
+  if (listener < 0)
+  {
+    cerr << "error: cannot listen on socket: " << socketPath << ": "
+         << strerror(errno) << endl;
+    return 1;
+  }
+  strncpy(socketToRemove, socketPath.c_str(), sizeof(socketToRemove) - 1);
+  signal(SIGINT, stopServer);
+  signal(SIGTERM, stopServer);
+  signal(SIGPIPE, SIG_IGN); // Un client parti ne doit pas arrêter le serveur
+
+  // Jamais détruit : des connexions peuvent encore l'utiliser à la sortie
+  ThreadPool &pool = *new ThreadPool(jobs);
+  IncludeCache &includeCache = *new IncludeCache();
+
+  // Une première compilation construit les DFA d'ANTLR et les allocations
+  // durables avant l'arrivée des vrais clients
+  compile("int main() { int a = 1; return a + 2; }");
+
+  while (true)
+  {
+    {
+      unique_lock<mutex> guard(connectionLock);
+      connectionClosed.wait(guard, []
+                            { return openConnections < maximumConnections; });
+    }
+    int connection = accept(listener, nullptr, nullptr);
+    if (connection < 0)
+    {
+      if (errno == EINTR || errno == ECONNABORTED)
+      {
+        continue;
+      }
+      cerr << "error: accept failed: " << strerror(errno) << endl;
+      close(listener);
+      return 1;
+    }
+    fcntl(connection, F_SETFD, FD_CLOEXEC);
+    {
+      lock_guard<mutex> guard(connectionLock);
+      openConnections++;
+    }
+    thread(serveConnection, connection, ref(pool), ref(includeCache)).detach();
+  }
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string>
+
+using namespace std;
+
+// ========== Serveur de compilation (ifcc --server) ==========
+// Processus persistant qui compile les requêtes reçues sur une socket Unix
+// (voir CompileProtocol.h). Le processus et les caches DFA du lexer et du
+// parser ANTLR restent chauds d'une requête à l'autre. Chaque connexion est
+// servie par son propre thread, 64 au plus à la fois ; les fonctions de
+// chaque programme sont réparties sur un pool de jobs threads.
+// Ne retourne qu'en cas d'erreur (code de sortie du processus).
+int runCompileServer(const string &socketPath, unsigned jobs);
@@ -0,0 +1,360 @@
+#include "Compiler.h"
+
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <set>
+#include <unistd.h>
+
+// Inclusion des fichiers nécessaires pour ANTLR et le générateur de code
+#include "antlr4-runtime.h"
+#include "generated/ifccLexer.h"
+#include "generated/ifccParser.h"
+
+#include "AstBuilder.h"
+#include "CodeGenVisitor.h"
+#include "CompileCache.h"
+#include "CFG.h"
+#include "ErrorListenerVisitor.h"
+#include "FastTokenSource.h"
+#include "NativeParser.h"
+#include "Preprocessor.h"
+#include "SourceFile.h"
+#include "ThreadPool.h"
+#include "TwoStageParse.h"
+
+using namespace antlr4;
+
+const char *compilerVersion()
+{
+  return "ifcc 1.0";
+}
+
+/**
+ * Forme canonique des options qui changent le résultat d'une compilation :
+ * les analyseurs (leurs diagnostics diffèrent) et les répertoires de -I,
+ * rendus absolus pour qu'un même -I relatif lancé d'ailleurs ne partage
+ * pas les entrées du cache.
+ * @param options Les options de la compilation
+ * @return Une chaîne égale pour deux compilations équivalentes
+ */
+string canonicalOptions(const CompileOptions &options)
+{
+  string workingDirectory = options.workingDirectory;
+  if (workingDirectory.empty())
+  {
+    char *current = getcwd(nullptr, 0);
+    workingDirectory = current != nullptr ? current : "";
+    free(current);
+  }
+  string canonical = string("lexer=") + (options.nativeLexer ? "native" : "antlr") +
+                     ";parser=" + (options.nativeParser ? "native" : "antlr") + ";";
+  for (const string &path : options.includePaths)
+  {
+    canonical += "I=" + (path[0] == '/' ? path : workingDirectory + "/" + path) + ";";
+  }
+  return canonical;
+}
+
+// Signature d'une fonction telle que la voient ses appelants
+static string functionSignature(const Program &program, const FunctionDecl *function)
+{
+  string signature = string(getTypeName(function->returnType)) + " " +
+                     string(program.spelling(function->name)) + "(";
+  for (size_t i = 0; i < function->parameters.size(); i++)
+  {
+    signature += (i > 0 ? "," : "") + string(getTypeName(function->parameters[i].type));
+  }
+  return signature + ")";
+}
+
+/**
+ * Calcule la clé de chaque fonction pour la compilation incrémentale : son
+ * texte, la signature de chaque fonction appelée telle qu'elle est
+ * visible à cet endroit (vérification des appels) et en fin de programme
+ * (génération du code des appels), et les options de la compilation. Le
+ * code d'une fonction ne dépend de rien d'autre : deux fonctions de même
+ * clé produisent le même assembleur et les mêmes avertissements.
+ * Une fonction qui n'est pas écrite telle quelle dans le source (macro,
+ * directive, fichier inclus) n'a pas de clé ("") : elle est recompilée.
+ * @param functions Les fonctions du programme, dans l'ordre du source
+ * @param source Le texte du programme
+ * @param preprocessor Le préprocesseur qui l'a lu (nullptr : aucun)
+ * @param options Les options de la compilation, sous forme canonique
+ */
+static vector<string> computeFunctionKeys(const Program &program, string_view source,
+                                          const Preprocessor *preprocessor,
+                                          const string &options)
+{
+  map<string, string> builtins = {{"getchar", "int getchar()"}, {"putchar", "int putchar(int)"}};
+  map<string, string> finalSignatures = builtins;
+  for (const FunctionDecl *function : program.functions)
+  {
+    finalSignatures[string(program.spelling(function->name))] = functionSignature(program, function);
+  }
+
+  map<string, string> visibleSignatures = builtins;
+  vector<string> keys;
+  for (const FunctionDecl *function : program.functions)
+  {
+    // Une fonction est visible dans son propre corps (appels récursifs)
+    visibleSignatures[string(program.spelling(function->name))] =
+        functionSignature(program, function);
+    set<string> callees;
+    for (Identifier callee : function->callees)
+    {
+      callees.insert(string(program.spelling(callee)));
+    }
+    string dependencies = "function;" + options;
+    for (const string &callee : callees)
+    {
+      auto visible = visibleSignatures.find(callee);
+      auto last = finalSignatures.find(callee);
+      dependencies += callee + "=" + (visible != visibleSignatures.end() ? visible->second : "?") +
+                      "/" + (last != finalSignatures.end() ? last->second : "?") + ";";
+    }
+    if (preprocessor != nullptr &&
+        !preprocessor->isVerbatim(function->sourceStart, function->sourceEnd))
+    {
+      keys.push_back("");
+      continue;
+    }
+    keys.push_back(CompileCache::computeKey(
+        source.substr(function->sourceStart, function->sourceEnd - function->sourceStart),
+        dependencies));
+  }
+  return keys;
+}
+
+/**
+ * Analyse le source et construit son arbre abstrait. Le lexer, le parser et
+ * l'arbre d'ANTLR sont locaux : ils sont libérés dès le retour, avant la
+ * génération de l'IR.
+ * @param source Le texte du programme
+ * @param options Le nom du source et les analyseurs à utiliser
+ * @param preprocessor Le préprocesseur qui fournit les tokens de FastLexer
+ *                     (nullptr avec ifccLexer et ifccParser)
+ * @return Le programme, ou nullptr en cas d'erreur de syntaxe (déjà signalée)
+ */
+static unique_ptr<Program> parseProgram(string_view source, const CompileOptions &options,
+                                        Preprocessor *preprocessor)
+{
+  // ifccLexer saute les directives (règle DIRECTIVE) : sans préprocesseur,
+  // elles sont refusées plutôt qu'ignorées en silence
+  if (preprocessor == nullptr && source.find('#') != string_view::npos)
+  {
+    for (const LexToken &token : FastLexer(source, true).tokenize())
+    {
+      if (token.kind == TokenKind::Hash)
+      {
+        DiagnosticEngine::current().report(ErrorType::Error, token.line,
+                                           FastLexer::columnOf(source, token.offset) + 1,
+                                           "preprocessing directives need -flexer=native");
+        return nullptr;
+      }
+    }
+  }
+
+  // NativeParser (-fparser=native) lit directement les tokens du
+  // préprocesseur et construit lui-même l'arbre abstrait
+  if (options.nativeParser)
+  {
+    return NativeParser(*preprocessor).parse();
+  }
+
+  // Crée un flux d'entrée pour ANTLR lisant directement le texte source
+  // (et celui des fichiers inclus)
+  SourceCharStream input(source, options.sourceName);
+
+  // Initialise le lexer pour analyser les tokens : FastLexer, ou le lexer
+  // généré par ANTLR avec -flexer=antlr (mêmes tokens, mêmes erreurs)
+  SyntaxErrorListener syntaxErrors; // Remplace l'affichage direct d'ANTLR sur cerr
+  ifccLexer lexer(&input);
+  lexer.removeErrorListeners();
+  lexer.addErrorListener(&syntaxErrors);
+  unique_ptr<FastTokenSource> fastLexer;
+  if (preprocessor != nullptr)
+  {
+    input.setSourceMap(&preprocessor->getSourceMap());
+    fastLexer = make_unique<FastTokenSource>(*preprocessor, &input, lexer.getVocabulary(),
+                                             &syntaxErrors);
+  }
+  CommonTokenStream tokens(fastLexer != nullptr ? static_cast<TokenSource *>(fastLexer.get())
+                                                : &lexer);
+  tokens.fill(); // Remplit le flux de tokens
+
+  // Analyse l'arbre syntaxique : SLL, puis LL complet en cas d'échec
+  ifccParser parser(&tokens);
+  ifccParser::AxiomContext *tree = parseTwoStage(parser, &syntaxErrors).tree;
+  size_t lexicalErrors = fastLexer != nullptr ? fastLexer->getNumberOfSyntaxErrors()
+                                              : lexer.getNumberOfSyntaxErrors();
+  if (lexicalErrors != 0 || parser.getNumberOfSyntaxErrors() != 0)
+  {
+    return nullptr;
+  }
+  return AstBuilder::build(tree);
+}
+
+/**
+ * Compile un programme. Chaque appel possède son propre lexer, parser et
+ * visiteur, et ses propres diagnostics ; seul le pool peut être partagé.
+ * @param source Le texte du programme (lu sans copie pendant l'appel)
+ * @param options Le nom du source, l'IR à afficher, le pool à utiliser et le
+ *                cache des fonctions pour la compilation incrémentale
+ * @return L'assembleur produit, les diagnostics, l'IR affiché et les statistiques
+ */
+CompileResult compile(string_view source, const CompileOptions &options)
+{
+  CompileResult result;
+  // Les diagnostics de cette compilation, même signalés par un autre thread,
+  // vont dans son propre moteur
+  DiagnosticEngine diagnostics;
+  DiagnosticEngine::Scope diagnosticScope(diagnostics);
+
+  // Analyse syntaxique : seul l'arbre abstrait survit à l'analyse. Le
+  // préprocesseur reste pour savoir quelles fonctions sont écrites telles
+  // quelles dans le source
+  unique_ptr<Preprocessor> preprocessor;
+  if (options.nativeLexer || options.nativeParser)
+  {
+    preprocessor = make_unique<Preprocessor>(source, options.sourceName, options.includePaths,
+                                             options.includeCache, options.workingDirectory);
+  }
+  unique_ptr<Program> program = parseProgram(source, options, preprocessor.get());
+  if (preprocessor != nullptr)
+  {
+    for (const auto &[path, digest] : preprocessor->getProbedFiles())
+    {
+      result.includes.push_back({path, digest});
+    }
+  }
+  vector<FunctionDecl *> programFunctions;
+  if (program != nullptr)
+  {
+    programFunctions = program->functions;
+  }
+
+  // Compilation incrémentale : les fonctions dont la clé est dans le cache
+  // ne sont ni visitées ni allouées, leur code est repris tel quel
+  vector<string> functionKeys;
+  vector<CachedCompilation> reusedFunctions(programFunctions.size());
+  vector<bool> isReused(programFunctions.size(), false);
+  CodeGenVisitor v;
+  if (program != nullptr && options.functionCache != nullptr && options.dumpAfter == IRPass::None)
+  {
+    functionKeys = computeFunctionKeys(*program, source, preprocessor.get(),
+                                       canonicalOptions(options));
+    set<const FunctionDecl *> precompiled;
+    for (size_t i = 0; i < programFunctions.size(); i++)
+    {
+      isReused[i] = !functionKeys[i].empty() &&
+                    options.functionCache->lookup(functionKeys[i], reusedFunctions[i]);
+      if (isReused[i])
+      {
+        precompiled.insert(programFunctions[i]);
+        // Rejoue les avertissements, enregistrés relativement au début de la fonction
+        size_t firstLine = programFunctions[i]->location.line;
+        for (const Diagnostic &warning : reusedFunctions[i].diagnostics)
+        {
+          diagnostics.report(warning.severity, warning.line + firstLine - 1, warning.column,
+                             warning.message);
+        }
+      }
+    }
+    v.setPrecompiledFunctions(precompiled);
+  }
+
+  // Traduit, alloue et émet les fonctions une à une, dans l'ordre du source :
+  // le CFG d'une fonction est libéré dès son code émis et le visiteur n'en
+  // garde que la signature, si bien que la mémoire occupée par l'IR ne croît
+  // pas avec le nombre de fonctions. Chaque fonction est émise dans son
+  // propre tampon par le pool, pendant que les suivantes sont traduites ;
+  // au plus maxPendingFunctions CFG attendent leur émission à la fois
+  unique_ptr<ThreadPool> callerOnly;
+  if (options.pool == nullptr)
+  {
+    callerOnly = make_unique<ThreadPool>(1);
+  }
+  ThreadPool &pool = options.pool != nullptr ? *options.pool : *callerOnly;
+  const size_t maxPendingFunctions = 2 * pool.size();
+  vector<AsmWriter> functionAssembly(programFunctions.size(), AsmWriter(0));
+  vector<AsmWriter> functionIR(programFunctions.size(), AsmWriter(0));
+  vector<PeepholeStats> functionStats(programFunctions.size());
+  vector<bool> isCompiled(programFunctions.size(), false);
+  TaskGroup pendingFunctions;
+  size_t pendingCount = 0;
+  auto emitFunction = [&](size_t i, shared_ptr<CFG> cfg)
+  {
+    // Ignore les fonctions spéciales "putchar" et "getchar" ; après une
+    // erreur, les fonctions sont encore traduites pour être vérifiées, mais
+    // plus émises
+    if (cfg->get_name() == "putchar" || cfg->get_name() == "getchar" || diagnostics.hasError())
+    {
+      return;
+    }
+    if (pendingCount == maxPendingFunctions)
+    {
+      pool.wait(pendingFunctions);
+      pendingCount = 0;
+    }
+    isCompiled[i] = true;
+    pendingCount++;
+    pool.submit(pendingFunctions, [&, i, cfg]() mutable
+                {
+                  DiagnosticEngine::Scope functionScope(diagnostics);
+                  cfg->gen_asm(functionAssembly[i], options.dumpAfter, &functionIR[i]);
+                  functionStats[i] = move(cfg->peepholeStats);
+                  cfg.reset(); // Libère les blocs, instructions et symboles
+                });
+  };
+
+  // Visite l'arbre pour générer l'IR, sauf en cas d'erreur de syntaxe
+  // (déjà signalée pendant l'analyse)
+  if (program != nullptr)
+  {
+    v.visitProgram(*program, emitFunction);
+  }
+  pool.wait(pendingFunctions);
+  if (diagnostics.hasError())
+  {
+    result.diagnostics = diagnostics.getDiagnostics();
+    return result;
+  }
+  result.success = true;
+  result.diagnostics = diagnostics.getDiagnostics();
+
+  // Concatène les tampons dans l'ordre du source pour une sortie
+  // déterministe, en libérant chacun une fois recopié
+  for (size_t i = 0; i < programFunctions.size(); i++)
+  {
+    if (isReused[i])
+    {
+      result.assembly << reusedFunctions[i].assembly;
+      continue;
+    }
+    result.assembly.append(functionAssembly[i]);
+    result.irDump.append(functionIR[i]);
+    result.peepholeStats.merge(functionStats[i]);
+
+    // Conserve le code des fonctions recompilées, avec leurs avertissements
+    if (isCompiled[i] && !functionKeys.empty() && !functionKeys[i].empty())
+    {
+      const FunctionDecl *function = programFunctions[i];
+      CachedCompilation entry;
+      entry.assembly.assign(functionAssembly[i].data(), functionAssembly[i].size());
+      size_t firstLine = function->location.line;
+      size_t lastLine = function->lastLine;
+      for (const Diagnostic &warning : result.diagnostics)
+      {
+        if (warning.line >= firstLine && warning.line <= lastLine)
+        {
+          entry.diagnostics.push_back({warning.severity, warning.line - firstLine + 1,
+                                       warning.column, warning.message});
+        }
+      }
+      options.functionCache->store(functionKeys[i], entry);
+    }
+    functionAssembly[i] = AsmWriter(0);
+  }
+  return result;
+}
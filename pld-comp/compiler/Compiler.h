@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "AsmWriter.h"
+#include "CompileCache.h"
+#include "Diagnostics.h"
+#include "IRPrinter.h"
+#include "Peephole.h"
+
+using namespace std;
+
+class ThreadPool;
+class IncludeCache;
+
+// ========== Interface de libifcc ==========
+// Compilation d'un programme en assembleur x86-64 dans le processus appelant,
+// sans fichier ni sortie sur la console : le driver ifcc (main.cpp) n'est
+// qu'un utilisateur de cette interface. Plusieurs appels à compile peuvent
+// s'exécuter en même temps sur des threads différents.
+
+// Options d'une compilation
+struct CompileOptions
+{
+  string sourceName = "<input>";   // Nom du source (répertoire des #include "...")
+  IRPass dumpAfter = IRPass::None; // Passe après laquelle l'IR est affiché dans irDump
+  ThreadPool *pool = nullptr;      // Pool où répartir les fonctions (nullptr : thread appelant)
+  bool nativeLexer = true;         // FastLexer plutôt que ifccLexer (mêmes tokens)
+  bool nativeParser = false;       // NativeParser plutôt que ifccParser (même arbre)
+  // Préprocesseur (FastLexer seulement : ifccLexer ignore les directives)
+  vector<string> includePaths;         // Répertoires de -I, dans l'ordre
+  IncludeCache *includeCache = nullptr; // Fichiers inclus partagés entre compilations
+  // Répertoire par rapport auquel le source et les -I relatifs sont lus ("" :
+  // celui du processus ; le serveur y met celui du client)
+  string workingDirectory;
+  // Compilation incrémentale : le code de chaque fonction est conservé dans ce
+  // cache, et repris tant que son texte et les signatures qu'elle utilise
+  // n'ont pas changé (nullptr : tout est recompilé ; ignoré avec dumpAfter)
+  CompileCache *functionCache = nullptr;
+};
+
+// Résultat d'une compilation
+struct CompileResult
+{
+  bool success = false;           // false si au moins une erreur a été signalée
+  AsmWriter assembly;             // Code assembleur (valable seulement si success)
+  vector<Diagnostic> diagnostics; // Erreurs et avertissements, triés par position
+  AsmWriter irDump{0};            // IR affiché si options.dumpAfter le demande
+  PeepholeStats peepholeStats;    // Cumul des statistiques de toutes les fonctions
+  vector<IncludeDependency> includes; // Fichiers cherchés par les #include
+};
+
+// Version du compilateur (fait partie de la clé du cache)
+const char *compilerVersion();
+
+// Options qui changent le résultat d'une compilation, sous une forme
+// canonique (fait aussi partie de la clé du cache)
+string canonicalOptions(const CompileOptions &options);
+
+// Compile le texte source d'un programme
+CompileResult compile(string_view source, const CompileOptions &options = CompileOptions());
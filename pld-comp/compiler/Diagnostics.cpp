@@ -0,0 +1,95 @@
+#include "Diagnostics.h"
+
+#include <algorithm>
+
+// Moteur installé par DiagnosticEngine::Scope sur le thread courant
+static thread_local DiagnosticEngine *scopedEngine = nullptr;
+
+/**
+ * Enregistre un diagnostic
+ * @param severity Erreur ou avertissement
+ * @param line La ligne concernée (0 si aucune)
+ * @param column La colonne concernée, à partir de 1 (0 si inconnue)
+ * @param message Le texte du diagnostic
+ */
+void DiagnosticEngine::report(ErrorType severity, size_t line, size_t column,
+                              const string &message)
+{
+  lock_guard<mutex> guard(lock);
+  diagnostics.push_back({severity, line, column, message});
+  if (severity == ErrorType::Error)
+  {
+    errorCount++;
+  }
+}
+
+bool DiagnosticEngine::hasError() const
+{
+  lock_guard<mutex> guard(lock);
+  return errorCount != 0;
+}
+
+/**
+ * Retourne les diagnostics dans l'ordre d'affichage. L'ordre est total, pour
+ * que deux exécutions donnent la même sortie quel que soit l'ordre dans
+ * lequel les threads ont signalé leurs diagnostics.
+ */
+vector<Diagnostic> DiagnosticEngine::getDiagnostics() const
+{
+  vector<Diagnostic> sorted;
+  {
+    lock_guard<mutex> guard(lock);
+    sorted = diagnostics;
+  }
+  stable_sort(sorted.begin(), sorted.end(),
+              [](const Diagnostic &a, const Diagnostic &b)
+              {
+                if (a.line != b.line)
+                  return a.line < b.line;
+                if (a.column != b.column)
+                  return a.column < b.column;
+                if (a.severity != b.severity)
+                  return a.severity == ErrorType::Error;
+                return a.message < b.message;
+              });
+  return sorted;
+}
+
+/**
+ * Formate des diagnostics comme ils l'ont toujours été : "Error: Line N
+ * message", ou "Error: message" sans position (la colonne n'est pas affichée)
+ * @param o Le tampon qui reçoit le texte
+ * @param diagnostics Les diagnostics, dans l'ordre d'affichage
+ */
+void printDiagnostics(AsmWriter &o, const vector<Diagnostic> &diagnostics)
+{
+  for (const Diagnostic &diagnostic : diagnostics)
+  {
+    o << (diagnostic.severity == ErrorType::Error ? "Error: " : "Warning: ");
+    if (diagnostic.line != 0)
+    {
+      o << "Line " << (long long)diagnostic.line << ' ';
+    }
+    o << diagnostic.message << '\n';
+  }
+}
+
+/**
+ * Moteur courant du thread. En dehors de toute portée Scope, les diagnostics
+ * vont dans un moteur propre au thread.
+ */
+DiagnosticEngine &DiagnosticEngine::current()
+{
+  static thread_local DiagnosticEngine threadEngine;
+  return scopedEngine != nullptr ? *scopedEngine : threadEngine;
+}
+
+DiagnosticEngine::Scope::Scope(DiagnosticEngine &engine) : previous(scopedEngine)
+{
+  scopedEngine = &engine;
+}
+
+DiagnosticEngine::Scope::~Scope()
+{
+  scopedEngine = previous;
+}
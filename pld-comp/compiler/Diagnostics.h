@@ -0,0 +1,71 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "AsmWriter.h"
+
+using namespace std;
+
+enum class ErrorType
+{
+  Error,
+  Warning
+};
+
+// ========== Structure Diagnostic ==========
+// Erreur ou avertissement rattaché à une position du source
+struct Diagnostic
+{
+  ErrorType severity;
+  size_t line;   // 0 : sans position (erreur d'entrée/sortie...)
+  size_t column; // À partir de 1 ; 0 : colonne inconnue
+  string message;
+};
+
+// Ajoute des diagnostics au tampon, un par ligne : "Error: Line N message"
+void printDiagnostics(AsmWriter &o, const vector<Diagnostic> &diagnostics);
+
+// ========== Classe DiagnosticEngine ==========
+// Diagnostics d'une compilation (un fichier source). Les messages sont
+// conservés au lieu d'être écrits au fil de l'eau : plusieurs compilations
+// peuvent tourner en parallèle dans le même processus, et chacune est
+// affichée d'un bloc, dans un ordre qui ne dépend pas des threads.
+// Un moteur peut recevoir des diagnostics de plusieurs threads à la fois.
+class DiagnosticEngine
+{
+public:
+  DiagnosticEngine() = default;
+  DiagnosticEngine(const DiagnosticEngine &) = delete;
+  DiagnosticEngine &operator=(const DiagnosticEngine &) = delete;
+
+  void report(ErrorType severity, size_t line, size_t column, const string &message);
+  bool hasError() const;
+
+  // Diagnostics triés par position (puis gravité et texte)
+  vector<Diagnostic> getDiagnostics() const;
+  // Ajoute les diagnostics triés au tampon (voir printDiagnostics)
+  inline void print(AsmWriter &o) const { printDiagnostics(o, getDiagnostics()); }
+
+  // Moteur qui reçoit les diagnostics du thread courant (voir Scope)
+  static DiagnosticEngine &current();
+
+  // Désigne un moteur comme moteur courant du thread le temps d'une portée
+  class Scope
+  {
+  public:
+    explicit Scope(DiagnosticEngine &engine);
+    ~Scope();
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    DiagnosticEngine *previous;
+  };
+
+private:
+  mutable mutex lock;
+  vector<Diagnostic> diagnostics;
+  size_t errorCount = 0;
+};
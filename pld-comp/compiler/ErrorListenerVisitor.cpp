@@ -1,31 +1,15 @@
 #include "ErrorListenerVisitor.h"
 
+#include "Ast.h"
 #include "Token.h"
-#include "iostream"
 
 using namespace std;
 
-// Variable statique pour indiquer si une erreur a été rencontrée
-bool ErrorListenerVisitor::mHasError = false;
-
 // Ajoute une erreur ou un avertissement avec un message, une ligne et un type d'erreur
 void ErrorListenerVisitor::addError(const string &message, int line,
                                     ErrorType errorType)
 {
-  // Vérifie le type d'erreur
-  switch (errorType)
-  {
-  case ErrorType::Error:
-    cerr << "Error: "; // Préfixe pour une erreur
-    mHasError = true;  // Marque qu'une erreur a été rencontrée
-    break;
-  case ErrorType::Warning:
-    cerr << "Warning: "; // Préfixe pour un avertissement
-    break;
-  }
-
-  // Affiche le message d'erreur ou d'avertissement avec le numéro de ligne
-  cerr << "Line " << line << " " << message << endl;
+  DiagnosticEngine::current().report(errorType, line, 0, message);
 }
 
 // Ajoute une erreur ou un avertissement en utilisant un contexte de règle du parser
@@ -33,26 +17,33 @@ void ErrorListenerVisitor::addError(antlr4::ParserRuleContext *ctx,
                                     const string &message,
                                     ErrorType errorType)
 {
-  // Récupère la ligne de début du contexte et appelle la méthode précédente
-  addError(message, ctx->getStart()->getLine(), errorType);
+  // Récupère la position de début du contexte (colonnes comptées à partir de 1)
+  antlr4::Token *start = ctx->getStart();
+  DiagnosticEngine::current().report(errorType, start->getLine(),
+                                     start->getCharPositionInLine() + 1, message);
+}
+
+// Ajoute une erreur ou un avertissement à la position d'un nœud de l'arbre abstrait
+void ErrorListenerVisitor::addError(const SourceLocation &location,
+                                    const string &message,
+                                    ErrorType errorType)
+{
+  DiagnosticEngine::current().report(errorType, location.line, location.column, message);
 }
 
 // Ajoute une erreur ou un avertissement avec seulement un message et un type d'erreur
 void ErrorListenerVisitor::addError(const string &message,
                                     ErrorType errorType)
 {
-  // Vérifie le type d'erreur
-  switch (errorType)
-  {
-  case ErrorType::Error:
-    cerr << "Error: "; // Préfixe pour une erreur
-    mHasError = true;  // Marque qu'une erreur a été rencontrée
-    break;
-  case ErrorType::Warning:
-    cerr << "Warning: "; // Préfixe pour un avertissement
-    break;
-  }
+  DiagnosticEngine::current().report(errorType, 0, 0, message);
+}
 
-  // Affiche le message d'erreur ou d'avertissement
-  cerr << message << endl;
-}
\ No newline at end of file
+// Transmet une erreur de syntaxe au moteur de diagnostics courant
+void SyntaxErrorListener::syntaxError(antlr4::Recognizer *recognizer,
+                                      antlr4::Token *offendingSymbol, size_t line,
+                                      size_t charPositionInLine,
+                                      const string &message, exception_ptr e)
+{
+  DiagnosticEngine::current().report(ErrorType::Error, line,
+                                     charPositionInLine + 1, message);
+}
@@ -1,27 +1,37 @@
 #pragma once
 
 #include "ParserRuleContext.h"
+#include "antlr4-runtime.h"
+#include "Diagnostics.h"
 
 using namespace std;
 
-enum class ErrorType
-{
-  Error,
-  Warning
-};
+struct SourceLocation;
 
+// Point d'entrée des passes pour signaler une erreur ou un avertissement :
+// les diagnostics vont au moteur courant du thread (DiagnosticEngine::current)
 class ErrorListenerVisitor
 {
 public:
-  static inline bool hasError() { return mHasError; }
+  static inline bool hasError() { return DiagnosticEngine::current().hasError(); }
   static void addError(antlr4::ParserRuleContext *ctx,
                        const string &message,
                        ErrorType errorType = ErrorType::Error);
+  static void addError(const SourceLocation &location,
+                       const string &message,
+                       ErrorType errorType = ErrorType::Error);
   static void addError(const string &message, int line,
                        ErrorType errorType = ErrorType::Error);
   static void addError(const string &message,
                        ErrorType errorType = ErrorType::Error);
+};
 
-protected:
-  static bool mHasError;
-};
\ No newline at end of file
+// Reçoit les erreurs de syntaxe du lexer et du parser ANTLR (à la place de
+// ConsoleErrorListener, qui écrit directement sur cerr)
+class SyntaxErrorListener : public antlr4::BaseErrorListener
+{
+public:
+  void syntaxError(antlr4::Recognizer *recognizer, antlr4::Token *offendingSymbol,
+                   size_t line, size_t charPositionInLine, const string &message,
+                   exception_ptr e) override;
+};
@@ -0,0 +1,503 @@
+#include "FastLexer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Classes de caractères : la première lettre d'un token suffit à choisir la
+// règle à appliquer
+enum CharClass : uint8_t
+{
+  OtherChar,  // Caractère hors du langage
+  SpaceChar,  // ' ', '\t', '\r'
+  NewlineChar,
+  IdentifierStart,
+  DigitChar,
+  QuoteChar,
+  SlashChar,  // '/' : division, "/=" ou début de commentaire
+  HashChar,   // '#' : directive
+  OperatorChar // Ponctuation ou début d'opérateur
+};
+
+static constexpr array<uint8_t, 256> buildCharClasses()
+{
+  array<uint8_t, 256> classes{};
+  for (int c = 'a'; c <= 'z'; c++)
+  {
+    classes[c] = IdentifierStart;
+    classes[c - 'a' + 'A'] = IdentifierStart;
+  }
+  classes['_'] = IdentifierStart;
+  for (int c = '0'; c <= '9'; c++)
+  {
+    classes[c] = DigitChar;
+  }
+  classes[' '] = classes['\t'] = classes['\r'] = SpaceChar;
+  classes['\n'] = NewlineChar;
+  classes['\''] = QuoteChar;
+  classes['/'] = SlashChar;
+  classes['#'] = HashChar;
+  for (char c : string_view("(){},;=+-*%~!<>&^|"))
+  {
+    classes[static_cast<uint8_t>(c)] = OperatorChar;
+  }
+  return classes;
+}
+
+static constexpr array<uint8_t, 256> charClasses = buildCharClasses();
+
+// ========== Mots-clés ==========
+// Hachage parfait sur la longueur, les deux premiers et le dernier caractère :
+// les 33 mots-clés occupent des cases distinctes d'une table de 64 entrées,
+// une seule comparaison suffit donc pour reconnaître un identifiant
+
+struct Keyword
+{
+  string_view text;
+  TokenKind kind;
+};
+
+static constexpr Keyword keywords[] = {
+    {"int", TokenKind::Int},
+    {"char", TokenKind::Char},
+    {"void", TokenKind::Void},
+    {"return", TokenKind::Return},
+    {"if", TokenKind::If},
+    {"else", TokenKind::Else},
+    {"while", TokenKind::While},
+    {"double", TokenKind::ReservedKeyword},
+    {"long", TokenKind::ReservedKeyword},
+    {"short", TokenKind::ReservedKeyword},
+    {"float", TokenKind::ReservedKeyword},
+    {"break", TokenKind::ReservedKeyword},
+    {"case", TokenKind::ReservedKeyword},
+    {"continue", TokenKind::ReservedKeyword},
+    {"default", TokenKind::ReservedKeyword},
+    {"do", TokenKind::ReservedKeyword},
+    {"enum", TokenKind::ReservedKeyword},
+    {"extern", TokenKind::ReservedKeyword},
+    {"for", TokenKind::ReservedKeyword},
+    {"goto", TokenKind::ReservedKeyword},
+    {"inline", TokenKind::ReservedKeyword},
+    {"register", TokenKind::ReservedKeyword},
+    {"restrict", TokenKind::ReservedKeyword},
+    {"signed", TokenKind::ReservedKeyword},
+    {"sizeof", TokenKind::ReservedKeyword},
+    {"static", TokenKind::ReservedKeyword},
+    {"struct", TokenKind::ReservedKeyword},
+    {"switch", TokenKind::ReservedKeyword},
+    {"typedef", TokenKind::ReservedKeyword},
+    {"union", TokenKind::ReservedKeyword},
+    {"unsigned", TokenKind::ReservedKeyword},
+    {"volatile", TokenKind::ReservedKeyword},
+    {"const", TokenKind::ReservedKeyword},
+};
+
+static const size_t keywordMinLength = 2;
+static const size_t keywordMaxLength = 8;
+
+// text doit contenir au moins keywordMinLength caractères
+static constexpr unsigned keywordHash(const char *text, size_t length)
+{
+  return (static_cast<uint8_t>(text[0]) * 15u + static_cast<uint8_t>(text[1]) * 14u +
+          static_cast<uint8_t>(text[length - 1]) + static_cast<unsigned>(length)) &
+         63u;
+}
+
+struct KeywordTable
+{
+  Keyword slots[64];
+  bool perfect; // false si deux mots-clés partagent une case
+};
+
+static constexpr KeywordTable buildKeywordTable()
+{
+  KeywordTable table{};
+  table.perfect = true;
+  for (const Keyword &keyword : keywords)
+  {
+    Keyword &slot = table.slots[keywordHash(keyword.text.data(), keyword.text.size())];
+    table.perfect = table.perfect && slot.text.empty();
+    slot = keyword;
+  }
+  return table;
+}
+
+static constexpr KeywordTable keywordTable = buildKeywordTable();
+static_assert(keywordTable.perfect, "keywordHash must be collision-free");
+
+// Catégorie d'un identifiant : mot-clé ou Identifier
+static inline TokenKind identifierKind(const char *text, size_t length)
+{
+  if (length < keywordMinLength || length > keywordMaxLength)
+  {
+    return TokenKind::Identifier;
+  }
+  const Keyword &slot = keywordTable.slots[keywordHash(text, length)];
+  if (slot.text.size() == length && memcmp(slot.text.data(), text, length) == 0)
+  {
+    return slot.kind;
+  }
+  return TokenKind::Identifier;
+}
+
+// ========== Classe FastLexer ==========
+
+/**
+ * Avance sur les espaces (' ', '\t', '\r', '\n') en comptant les lignes.
+ * Avec SSE2, 16 octets sont classés à la fois : le premier octet qui n'est
+ * pas un espace est le premier zéro du masque obtenu.
+ * @param position La position de départ
+ * @param line La ligne courante, incrémentée à chaque '\n' passé
+ * @return La position du premier caractère qui n'est pas un espace
+ */
+size_t FastLexer::skipWhitespace(size_t position, uint32_t &line) const
+{
+  const char *text = source.data();
+#if defined(__SSE2__)
+  const __m128i space = _mm_set1_epi8(' ');
+  const __m128i tab = _mm_set1_epi8('\t');
+  const __m128i carriageReturn = _mm_set1_epi8('\r');
+  const __m128i newline = _mm_set1_epi8('\n');
+  while (position + 16 <= source.size())
+  {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + position));
+    __m128i newlines = _mm_cmpeq_epi8(chunk, newline);
+    __m128i spaces = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space),
+                                               _mm_cmpeq_epi8(chunk, tab)),
+                                  _mm_or_si128(_mm_cmpeq_epi8(chunk, carriageReturn), newlines));
+    unsigned spaceMask = static_cast<unsigned>(_mm_movemask_epi8(spaces));
+    unsigned newlineMask = static_cast<unsigned>(_mm_movemask_epi8(newlines));
+    if (spaceMask != 0xFFFF)
+    {
+      unsigned run = static_cast<unsigned>(__builtin_ctz(~spaceMask));
+      line += __builtin_popcount(newlineMask & ((1u << run) - 1));
+      return position + run;
+    }
+    line += __builtin_popcount(newlineMask);
+    position += 16;
+  }
+#endif
+  while (position < source.size())
+  {
+    uint8_t charClass = charClasses[static_cast<uint8_t>(text[position])];
+    if (charClass == NewlineChar)
+    {
+      line++;
+    }
+    else if (charClass != SpaceChar)
+    {
+      break;
+    }
+    position++;
+  }
+  return position;
+}
+
+/**
+ * Avance sur les caractères [a-zA-Z_0-9] d'un identifiant. Avec SSE2, une
+ * lettre est reconnue par (c | 0x20) - 'a' < 26 et un chiffre par
+ * c - '0' < 10, comparaisons non signées réalisées en décalant de 128.
+ * @param position La position du caractère qui suit la première lettre
+ * @return La position du premier caractère hors de l'identifiant
+ */
+size_t FastLexer::scanIdentifier(size_t position) const
+{
+  const char *text = source.data();
+#if defined(__SSE2__)
+  const __m128i lowercase = _mm_set1_epi8(0x20);
+  const __m128i letterBias = _mm_set1_epi8(static_cast<char>(0x80 - 'a'));
+  const __m128i letterLimit = _mm_set1_epi8(static_cast<char>(0x80 + 26));
+  const __m128i digitBias = _mm_set1_epi8(static_cast<char>(0x80 - '0'));
+  const __m128i digitLimit = _mm_set1_epi8(static_cast<char>(0x80 + 10));
+  const __m128i underscore = _mm_set1_epi8('_');
+  while (position + 16 <= source.size())
+  {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text + position));
+    __m128i letters = _mm_cmplt_epi8(
+        _mm_add_epi8(_mm_or_si128(chunk, lowercase), letterBias), letterLimit);
+    __m128i digits = _mm_cmplt_epi8(_mm_add_epi8(chunk, digitBias), digitLimit);
+    __m128i identifier = _mm_or_si128(_mm_or_si128(letters, digits),
+                                      _mm_cmpeq_epi8(chunk, underscore));
+    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(identifier));
+    if (mask != 0xFFFF)
+    {
+      return position + static_cast<unsigned>(__builtin_ctz(~mask));
+    }
+    position += 16;
+  }
+#endif
+  while (position < source.size())
+  {
+    uint8_t charClass = charClasses[static_cast<uint8_t>(text[position])];
+    if (charClass != IdentifierStart && charClass != DigitChar)
+    {
+      break;
+    }
+    position++;
+  }
+  return position;
+}
+
+/**
+ * Découpe le source en tokens. Comme ifccLexer, chaque token est le plus long
+ * préfixe reconnu ; un texte non reconnu produit un token Invalid couvrant
+ * ce qu'ifccLexer signalerait et ignorerait ("token recognition error").
+ * @return Les tokens, terminés par EndOfInput
+ */
+vector<LexToken> FastLexer::tokenize()
+{
+  vector<LexToken> tokens;
+  tokens.reserve(source.size() / 2 + 1);
+  const char *text = source.data();
+  const size_t size = source.size();
+  uint32_t line = 1;
+  size_t position = 0;
+  bool inDirective = false; // Entre le Hash d'une directive et la fin de sa ligne
+
+  while (true)
+  {
+    if (inDirective)
+    {
+      // Le retour à la ligne termine la directive, sauf s'il suit un '\'
+      while (position < size)
+      {
+        if (text[position] == ' ' || text[position] == '\t' || text[position] == '\r')
+        {
+          position++;
+        }
+        else if (text[position] == '\\' && position + 1 < size && text[position + 1] == '\n')
+        {
+          position += 2;
+          line++;
+        }
+        else
+        {
+          break;
+        }
+      }
+      if (position >= size || text[position] == '\n')
+      {
+        tokens.push_back({TokenKind::EndOfDirective, static_cast<uint32_t>(position), 0, line});
+        inDirective = false;
+        continue;
+      }
+    }
+    else
+    {
+      position = skipWhitespace(position, line);
+    }
+    if (position >= size)
+    {
+      break;
+    }
+    const size_t start = position;
+    const uint32_t startLine = line;
+    const char c = text[position];
+    const char next = position + 1 < size ? text[position + 1] : '\0';
+    TokenKind kind = TokenKind::Invalid;
+
+    switch (charClasses[static_cast<uint8_t>(c)])
+    {
+    case IdentifierStart:
+      position = scanIdentifier(position + 1);
+      kind = identifierKind(text + start, position - start);
+      break;
+
+    case DigitChar:
+      while (position < size && charClasses[static_cast<uint8_t>(text[position])] == DigitChar)
+      {
+        position++;
+      }
+      kind = TokenKind::IntegerLiteral;
+      break;
+
+    case QuoteChar:
+      // '\'' . '\'' : n'importe quel caractère, y compris un retour à la ligne
+      if (position + 2 < size && text[position + 2] == '\'')
+      {
+        line += next == '\n';
+        position += 3;
+        kind = TokenKind::CharLiteral;
+      }
+      else
+      {
+        // ifccLexer abandonne sur le troisième caractère, qu'il ignore aussi
+        position = min(position + 3, size);
+      }
+      break;
+
+    case SlashChar:
+      if (next == '*')
+      {
+        const char *end = static_cast<const char *>(
+            memmem(text + position + 2, size - position - 2, "*/", 2));
+        if (end != nullptr)
+        {
+          line += count(text + position, end, '\n');
+          position = end + 2 - text;
+          continue; // Commentaire ignoré
+        }
+        // Commentaire non terminé : seul "/" est reconnu
+        position++;
+        kind = TokenKind::Slash;
+      }
+      else if (next == '/')
+      {
+        while (position < size && text[position] != '\n' && text[position] != '\r')
+        {
+          position++;
+        }
+        continue;
+      }
+      else if (next == '=')
+      {
+        position += 2;
+        kind = TokenKind::SlashAssign;
+      }
+      else
+      {
+        position++;
+        kind = TokenKind::Slash;
+      }
+      break;
+
+    case HashChar:
+    {
+      if (keepDirectives)
+      {
+        // Les tokens de la directive suivent, jusqu'à EndOfDirective
+        position++;
+        kind = TokenKind::Hash;
+        inDirective = true;
+        break;
+      }
+      // Directive ignorée jusqu'au retour à la ligne inclus
+      const char *end = static_cast<const char *>(memchr(text + position, '\n', size - position));
+      if (end != nullptr)
+      {
+        line++;
+        position = end + 1 - text;
+        continue;
+      }
+      position = size; // Directive non terminée : erreur jusqu'à la fin
+      break;
+    }
+
+    case OperatorChar:
+    {
+      // Opérateur de deux caractères si le suivant le permet, sinon d'un seul
+      TokenKind single = TokenKind::Invalid;
+      TokenKind pair = TokenKind::Invalid;
+      switch (c)
+      {
+      case '(': single = TokenKind::LeftParen; break;
+      case ')': single = TokenKind::RightParen; break;
+      case '{': single = TokenKind::LeftBrace; break;
+      case '}': single = TokenKind::RightBrace; break;
+      case ',': single = TokenKind::Comma; break;
+      case ';': single = TokenKind::Semicolon; break;
+      case '~': single = TokenKind::Tilde; break;
+      case '%': single = TokenKind::Percent; break;
+      case '^': single = TokenKind::BitXor; break;
+      case '=':
+        single = TokenKind::Assign;
+        pair = next == '=' ? TokenKind::Equal : pair;
+        break;
+      case '!':
+        single = TokenKind::Not;
+        pair = next == '=' ? TokenKind::NotEqual : pair;
+        break;
+      case '<':
+        single = TokenKind::Less;
+        pair = next == '=' ? TokenKind::LessEqual : pair;
+        break;
+      case '>':
+        single = TokenKind::Greater;
+        pair = next == '=' ? TokenKind::GreaterEqual : pair;
+        break;
+      case '*':
+        single = TokenKind::Star;
+        pair = next == '=' ? TokenKind::StarAssign : pair;
+        break;
+      case '+':
+        single = TokenKind::Plus;
+        pair = next == '=' ? TokenKind::PlusAssign : next == '+' ? TokenKind::PlusPlus : pair;
+        break;
+      case '-':
+        single = TokenKind::Minus;
+        pair = next == '=' ? TokenKind::MinusAssign : next == '-' ? TokenKind::MinusMinus : pair;
+        break;
+      case '&':
+        single = TokenKind::BitAnd;
+        pair = next == '&' ? TokenKind::LogicalAnd : pair;
+        break;
+      case '|':
+        single = TokenKind::BitOr;
+        pair = next == '|' ? TokenKind::LogicalOr : pair;
+        break;
+      }
+      kind = pair != TokenKind::Invalid ? pair : single;
+      position += pair != TokenKind::Invalid ? 2 : 1;
+      break;
+    }
+
+    default:
+      // Caractère inconnu : comme ifccLexer, qui lit de l'UTF-8, un caractère
+      // sur plusieurs octets n'est signalé qu'une fois
+      position++;
+      while ((c & 0xC0) == 0xC0 && position < size && (text[position] & 0xC0) == 0x80)
+      {
+        position++;
+      }
+      break;
+    }
+
+    tokens.push_back({kind, static_cast<uint32_t>(start),
+                      static_cast<uint32_t>(position - start), startLine});
+  }
+
+  tokens.push_back({TokenKind::EndOfInput, static_cast<uint32_t>(size), 0, line});
+  return tokens;
+}
+
+/**
+ * @param source Le texte découpé
+ * @param offset Une position dans ce texte
+ * @return Le nombre de caractères entre le début de la ligne et offset
+ */
+uint32_t FastLexer::columnOf(string_view source, uint32_t offset)
+{
+  if (offset == 0)
+  {
+    return 0;
+  }
+  size_t previousNewline = source.rfind('\n', offset - 1);
+  return previousNewline == string_view::npos
+             ? offset
+             : offset - static_cast<uint32_t>(previousNewline) - 1;
+}
+
+/**
+ * @param text Le texte non reconnu (un token Invalid)
+ * @return Le message, avec le texte affiché comme par Lexer::getErrorDisplay
+ */
+string FastLexer::recognitionError(string_view text)
+{
+  string message = "token recognition error at: '";
+  for (char c : text)
+  {
+    switch (c)
+    {
+    case '\n': message += "\\n"; break;
+    case '\t': message += "\\t"; break;
+    case '\r': message += "\\r"; break;
+    default: message += c; break;
+    }
+  }
+  return message + "'";
+}
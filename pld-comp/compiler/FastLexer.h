@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// ========== Enum TokenKind ==========
+// Catégories de tokens du langage de ifcc.g4 (espaces et commentaires ne
+// produisent pas de token, les directives seulement pour le préprocesseur)
+enum class TokenKind : uint8_t
+{
+  EndOfInput,
+  Identifier,
+  IntegerLiteral,
+  CharLiteral,
+  // Mots-clés utilisés par la grammaire
+  Int,
+  Char,
+  Void,
+  Return,
+  If,
+  Else,
+  While,
+  ReservedKeyword, // Autres mots-clés du C (double, for, struct...), toujours refusés
+  // Ponctuation et opérateurs
+  LeftParen,
+  RightParen,
+  LeftBrace,
+  RightBrace,
+  Comma,
+  Semicolon,
+  Assign,
+  PlusAssign,
+  MinusAssign,
+  StarAssign,
+  SlashAssign,
+  PlusPlus,
+  MinusMinus,
+  Plus,
+  Minus,
+  Star,
+  Slash,
+  Percent,
+  Tilde,
+  Not,
+  Less,
+  LessEqual,
+  Greater,
+  GreaterEqual,
+  Equal,
+  NotEqual,
+  BitAnd,
+  BitXor,
+  BitOr,
+  LogicalAnd,
+  LogicalOr,
+  // Directives, produites seulement si le préprocesseur les demande
+  Hash,           // '#' : début de directive, ou opérateur dans une directive
+  EndOfDirective, // Fin de la ligne d'une directive (longueur nulle)
+  Invalid // Texte non reconnu (erreur lexicale), couvert par le token
+};
+
+// ========== Structure LexToken ==========
+// Token compact (16 octets) : son texte est source.substr(offset, length)
+struct LexToken
+{
+  TokenKind kind;
+  uint32_t offset; // Position du premier caractère dans le source
+  uint32_t length;
+  uint32_t line; // Ligne du premier caractère (à partir de 1)
+};
+
+// ========== Classe FastLexer ==========
+// Analyseur lexical écrit à la main pour ifcc.g4 : automate piloté par une
+// table de classes de caractères, mots-clés reconnus par hachage parfait,
+// espaces et identifiants parcourus 16 octets à la fois (SSE2). Les tokens
+// reconnus sont ceux de ifccLexer, avec la même règle du plus long préfixe.
+class FastLexer
+{
+public:
+  // Le texte doit rester valide tant que les tokens sont utilisés. Sans
+  // keepDirectives, les directives sont ignorées comme par ifccLexer ; avec,
+  // chacune produit Hash, les tokens de sa ligne (lignes prolongées par '\'
+  // comprises) puis EndOfDirective.
+  explicit FastLexer(string_view source, bool keepDirectives = false)
+      : source(source), keepDirectives(keepDirectives) {}
+
+  // Découpe tout le source ; le dernier token est toujours EndOfInput
+  vector<LexToken> tokenize();
+
+  // Colonne (à partir de 0) d'une position du source
+  static uint32_t columnOf(string_view source, uint32_t offset);
+
+  // Message de ifccLexer pour un texte non reconnu
+  static string recognitionError(string_view text);
+
+private:
+  string_view source;
+  bool keepDirectives;
+
+  size_t skipWhitespace(size_t position, uint32_t &line) const;
+  size_t scanIdentifier(size_t position) const;
+};
@@ -0,0 +1,162 @@
+#include "FastTokenSource.h"
+
+using namespace antlr4;
+
+// Type ANTLR du token de fin de flux (Token::EOF)
+static const size_t END_OF_INPUT = static_cast<size_t>(-1);
+
+// Orthographe des tokens de texte fixe, telle qu'elle apparaît entre
+// apostrophes dans le vocabulaire du parser ("'('", "'return'"...)
+static const struct
+{
+  TokenKind kind;
+  const char *spelling;
+} fixedSpellings[] = {
+    {TokenKind::Return, "return"},   {TokenKind::If, "if"},
+    {TokenKind::Else, "else"},       {TokenKind::While, "while"},
+    {TokenKind::LeftParen, "("},     {TokenKind::RightParen, ")"},
+    {TokenKind::LeftBrace, "{"},     {TokenKind::RightBrace, "}"},
+    {TokenKind::Comma, ","},         {TokenKind::Semicolon, ";"},
+    {TokenKind::Assign, "="},        {TokenKind::PlusAssign, "+="},
+    {TokenKind::MinusAssign, "-="},  {TokenKind::StarAssign, "*="},
+    {TokenKind::SlashAssign, "/="},  {TokenKind::PlusPlus, "++"},
+    {TokenKind::MinusMinus, "--"},   {TokenKind::Plus, "+"},
+    {TokenKind::Minus, "-"},         {TokenKind::Star, "*"},
+    {TokenKind::Slash, "/"},         {TokenKind::Percent, "%"},
+    {TokenKind::Tilde, "~"},         {TokenKind::Not, "!"},
+    {TokenKind::Less, "<"},          {TokenKind::LessEqual, "<="},
+    {TokenKind::Greater, ">"},       {TokenKind::GreaterEqual, ">="},
+    {TokenKind::Equal, "=="},        {TokenKind::NotEqual, "!="},
+    {TokenKind::BitAnd, "&"},        {TokenKind::BitXor, "^"},
+    {TokenKind::BitOr, "|"},         {TokenKind::LogicalAnd, "&&"},
+    {TokenKind::LogicalOr, "||"},
+};
+
+// Tokens définis par une règle nommée de la grammaire ("int" est un TYPE,
+// la règle TYPE précédant INT dans ifcc.g4)
+static const struct
+{
+  TokenKind kind;
+  const char *symbolicName;
+} namedTokens[] = {
+    {TokenKind::Identifier, "ID"},
+    {TokenKind::IntegerLiteral, "INTEGER_LITERAL"},
+    {TokenKind::CharLiteral, "CHAR_LITERAL"},
+    {TokenKind::Int, "TYPE"},
+    {TokenKind::Char, "TYPE"},
+    {TokenKind::Void, "TYPE"},
+};
+
+/**
+ * Lit les tokens produits par le préprocesseur et associe chaque catégorie
+ * de token à son type dans le vocabulaire du parser, retrouvé par son nom :
+ * aucun numéro de token généré par ANTLR n'est écrit en dur.
+ * @param preprocessor Le préprocesseur du programme
+ * @param input Le flux de caractères de sa SourceMap (texte des tokens)
+ * @param vocabulary Le vocabulaire du parser qui consommera les tokens
+ * @param errorListener Reçoit les erreurs lexicales
+ */
+FastTokenSource::FastTokenSource(Preprocessor &preprocessor, CharStream *input,
+                                 const dfa::Vocabulary &vocabulary,
+                                 ANTLRErrorListener *errorListener)
+    : preprocessor(&preprocessor), input(input), errorListener(errorListener),
+      next(preprocessor.next())
+{
+  initializeTypes(vocabulary);
+}
+
+FastTokenSource::FastTokenSource(string_view source, CharStream *input,
+                                 const dfa::Vocabulary &vocabulary,
+                                 ANTLRErrorListener *errorListener)
+    : ownPreprocessor(make_unique<Preprocessor>(source, input->getSourceName())),
+      preprocessor(ownPreprocessor.get()), input(input), errorListener(errorListener),
+      next(preprocessor->next())
+{
+  initializeTypes(vocabulary);
+}
+
+void FastTokenSource::initializeTypes(const dfa::Vocabulary &vocabulary)
+{
+  tokenTypes.assign(static_cast<size_t>(TokenKind::Invalid) + 1, Token::INVALID_TYPE);
+  map<string, size_t> symbolicTypes;
+  for (size_t type = 1; type <= vocabulary.getMaxTokenType(); type++)
+  {
+    string literal = vocabulary.getLiteralName(type);
+    if (literal.size() >= 2)
+    {
+      literalTypes[literal.substr(1, literal.size() - 2)] = type;
+    }
+    symbolicTypes[vocabulary.getSymbolicName(type)] = type;
+  }
+
+  for (const auto &token : fixedSpellings)
+  {
+    auto literal = literalTypes.find(token.spelling);
+    if (literal != literalTypes.end())
+    {
+      tokenTypes[static_cast<size_t>(token.kind)] = literal->second;
+    }
+  }
+  for (const auto &token : namedTokens)
+  {
+    tokenTypes[static_cast<size_t>(token.kind)] = symbolicTypes[token.symbolicName];
+  }
+  tokenTypes[static_cast<size_t>(TokenKind::EndOfInput)] = END_OF_INPUT;
+}
+
+size_t FastTokenSource::typeOf(const LexToken &token) const
+{
+  if (token.kind != TokenKind::ReservedKeyword)
+  {
+    return tokenTypes[static_cast<size_t>(token.kind)];
+  }
+  auto keyword =
+      literalTypes.find(preprocessor->getSourceMap().text(token.offset, token.length));
+  return keyword != literalTypes.end() ? keyword->second : Token::INVALID_TYPE;
+}
+
+// Signale un texte non reconnu avec le message de ifccLexer
+void FastTokenSource::reportInvalid(const PreprocessedToken &token)
+{
+  syntaxErrors++;
+  string_view text = preprocessor->getSourceMap().text(token.token.offset, token.token.length);
+  errorListener->syntaxError(nullptr, nullptr, token.token.line, token.column,
+                             FastLexer::recognitionError(text), nullptr);
+}
+
+/**
+ * Produit le token suivant ; les textes non reconnus sont signalés puis
+ * ignorés, et le token de fin de flux est répété indéfiniment.
+ */
+unique_ptr<Token> FastTokenSource::nextToken()
+{
+  while (next.token.kind == TokenKind::Invalid)
+  {
+    reportInvalid(next);
+    next = preprocessor->next();
+  }
+  const LexToken token = next.token;
+  const uint32_t column = next.column;
+  if (token.kind != TokenKind::EndOfInput)
+  {
+    next = preprocessor->next();
+  }
+  // Indices de caractères inclusifs, comme ceux de ifccLexer (stop = start - 1
+  // pour la fin de flux)
+  auto result = make_unique<CommonToken>(make_pair(this, input), typeOf(token),
+                                         Token::DEFAULT_CHANNEL, token.offset,
+                                         static_cast<size_t>(token.offset) + token.length - 1);
+  result->setLine(token.line);
+  result->setCharPositionInLine(column);
+  return result;
+}
+
+size_t FastTokenSource::getLine() const
+{
+  return next.token.line;
+}
+
+size_t FastTokenSource::getCharPositionInLine()
+{
+  return next.column;
+}
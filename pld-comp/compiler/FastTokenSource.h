@@ -0,0 +1,67 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "antlr4-runtime.h"
+#include "FastLexer.h"
+#include "Preprocessor.h"
+
+using namespace std;
+
+// ========== Classe FastTokenSource ==========
+// Source de tokens ANTLR alimentée par FastLexer et le préprocesseur, à la
+// place de ifccLexer : les tokens portent les types du vocabulaire du parser
+// et leurs positions dans le flux de caractères, et les erreurs lexicales sont
+// transmises au listener comme le ferait ifccLexer. Les espaces ne produisent
+// aucun token.
+class FastTokenSource : public antlr4::TokenSource
+{
+public:
+  // input doit lire le texte de la SourceMap du préprocesseur ; vocabulary
+  // est celui du parser
+  FastTokenSource(Preprocessor &preprocessor, antlr4::CharStream *input,
+                  const antlr4::dfa::Vocabulary &vocabulary,
+                  antlr4::ANTLRErrorListener *errorListener);
+  // Prétraite lui-même source, sans répertoire d'inclusion ; input doit
+  // lire le même texte que source
+  FastTokenSource(string_view source, antlr4::CharStream *input,
+                  const antlr4::dfa::Vocabulary &vocabulary,
+                  antlr4::ANTLRErrorListener *errorListener);
+
+  unique_ptr<antlr4::Token> nextToken() override;
+  size_t getLine() const override;
+  size_t getCharPositionInLine() override;
+  antlr4::CharStream *getInputStream() override { return input; }
+  string getSourceName() override { return input->getSourceName(); }
+  Ref<antlr4::TokenFactory<antlr4::CommonToken>> getTokenFactory() override
+  {
+    return antlr4::CommonTokenFactory::DEFAULT;
+  }
+
+  // Nombre d'erreurs lexicales et de prétraitement signalées jusqu'ici
+  size_t getNumberOfSyntaxErrors() const
+  {
+    return syntaxErrors + preprocessor->getNumberOfErrors();
+  }
+
+private:
+  unique_ptr<Preprocessor> ownPreprocessor;
+  Preprocessor *preprocessor;
+  antlr4::CharStream *input;
+  antlr4::ANTLRErrorListener *errorListener;
+  PreprocessedToken next; // Prochain token à produire (position des erreurs)
+  size_t syntaxErrors = 0;
+
+  void initializeTypes(const antlr4::dfa::Vocabulary &vocabulary);
+
+  // Type ANTLR de chaque TokenKind, et de chaque token de texte fixe (les
+  // mots-clés réservés ont chacun leur type)
+  vector<size_t> tokenTypes;
+  map<string, size_t, less<>> literalTypes;
+
+  size_t typeOf(const LexToken &token) const;
+  void reportInvalid(const PreprocessedToken &token);
+};
@@ -1,9 +1,11 @@
 #include "IR.h"
-#include "CodeGenVisitor.h"
+#include "ParallelMove.h"
 #include "BasicBlock.h"
 #include "CFG.h"
 #include "Type.h"
 #include "ErrorListenerVisitor.h"
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <memory>
 #include <queue>
@@ -38,97 +40,119 @@ ostream &operator<<(ostream &os, const Parameter &parameter)
  * @param parameters Les paramètres de l'instruction
  */
 IRInstr::IRInstr(BasicBlock *basicBlock, Operation operation, Type type,
-                 const vector<Parameter> &parameters)
-    : block(basicBlock), operation(operation), outType(type), parameters(parameters) {}
+                 ParameterList parameters)
+    : block(basicBlock), operation(operation), outType(type), parameters(move(parameters)) {}
+
+// Opérande registre (32 ou 8 bits) pour un index de l'allocateur de registres
+static MOperand reg32(int index)
+{
+  return MOperand::createReg(allocatableRegister(index), 32);
+}
+
+static MOperand reg8(int index)
+{
+  return MOperand::createReg(allocatableRegister(index), 8);
+}
+
+static MOperand reg64(int index)
+{
+  return MOperand::createReg(allocatableRegister(index), 64);
+}
+
+// Emplacement d'un symbole dans la pile, relatif à %rbp
+static MOperand stackSlot(const shared_ptr<Symbol> &symbole)
+{
+  return MOperand::createMem(PhysReg::RBP, -symbole->offset);
+}
 
 /**
- * Génère le code assembleur x86-64 correspondant à l'instruction IR
- * @param os Le flux de sortie pour écrire le code assembleur
+ * Sélectionne les instructions machine x86-64 correspondant à l'instruction IR
+ * @param mbb Le bloc machine dans lequel ajouter les instructions
  * @param cfg Le graphe de flux de contrôle associé
  */
-void IRInstr::genAsm(ostream &os, CFG *cfg)
+void IRInstr::selectInstructions(MachineBasicBlock &mbb, CFG *cfg)
 {
   switch (operation)
   {
   case add:
-    generateBinaryOperation("addl", os, cfg); // Génère une addition
+    generateBinaryOperation(MOpcode::addl, mbb, cfg); // Génère une addition
     break;
   case sub:
-    generateBinaryOperation("subl", os, cfg); // Génère une soustraction
+    generateBinaryOperation(MOpcode::subl, mbb, cfg); // Génère une soustraction
     break;
   case mul:
-    generateBinaryOperation("imull", os, cfg); // Génère une multiplication
+    generateBinaryOperation(MOpcode::imull, mbb, cfg); // Génère une multiplication
     break;
   case cmpNZ:
-    generateCompareNotZero(os, cfg); // Génère une comparaison avec zéro
+    generateCompareNotZero(mbb, cfg); // Génère une comparaison avec zéro
     break;
   case div:
-    generateDivisionInstruction(os, cfg); // Génère une division entière
+    generateDivisionInstruction(mbb, cfg); // Génère une division entière
     break;
   case mod:
-    generateModuloInstruction(os, cfg); // Génère un modulo
+    generateModuloInstruction(mbb, cfg); // Génère un modulo
     break;
   case b_and:
-    generateBinaryOperation("andl", os, cfg); // Génère un AND binaire
+    generateBinaryOperation(MOpcode::andl, mbb, cfg); // Génère un AND binaire
     break;
   case b_or:
-    generateBinaryOperation("orl", os, cfg); // Génère un OR binaire
+    generateBinaryOperation(MOpcode::orl, mbb, cfg); // Génère un OR binaire
     break;
   case b_xor:
-    generateBinaryOperation("xorl", os, cfg); // Génère un XOR binaire
+    generateBinaryOperation(MOpcode::xorl, mbb, cfg); // Génère un XOR binaire
     break;
   case lt:
-    generateComparisonOperation("setl", os, cfg); // Génère une comparaison <
+    generateComparisonOperation(MOpcode::setl, mbb, cfg); // Génère une comparaison <
     break;
   case leq:
-    generateComparisonOperation("setle", os, cfg); // Génère une comparaison <=
+    generateComparisonOperation(MOpcode::setle, mbb, cfg); // Génère une comparaison <=
     break;
   case gt:
-    generateComparisonOperation("setg", os, cfg); // Génère une comparaison >
+    generateComparisonOperation(MOpcode::setg, mbb, cfg); // Génère une comparaison >
     break;
   case geq:
-    generateComparisonOperation("setge", os, cfg); // Génère une comparaison >=
+    generateComparisonOperation(MOpcode::setge, mbb, cfg); // Génère une comparaison >=
     break;
   case eq:
-    generateComparisonOperation("sete", os, cfg); // Génère une comparaison ==
+    generateComparisonOperation(MOpcode::sete, mbb, cfg); // Génère une comparaison ==
     break;
   case neq:
-    generateComparisonOperation("setne", os, cfg); // Génère une comparaison !=
+    generateComparisonOperation(MOpcode::setne, mbb, cfg); // Génère une comparaison !=
     break;
   case ret:
-    generateReturnInstruction(os, cfg); // Génère une instruction de retour
+    generateReturnInstruction(mbb, cfg); // Génère une instruction de retour
     break;
   case var_assign:
-    generateVariableAssignment(os, cfg); // Génère une affectation de variable
+    generateVariableAssignment(mbb, cfg); // Génère une affectation de variable
     break;
   case ldconst:
-    generateLoadConstant(os, cfg); // Charge une constante
+    generateLoadConstant(mbb, cfg); // Charge une constante
     break;
   case ldvar:
-    generateLoadVariable(os, cfg); // Charge une variable
+    generateLoadVariable(mbb, cfg); // Charge une variable
     break;
   case neg:
-    generateUnaryOperation("neg", os, cfg); // Génère une négation
+    generateUnaryOperation(MOpcode::negl, mbb, cfg); // Génère une négation
     break;
   case not_:
-    generateUnaryOperation("notl", os, cfg); // Génère un NOT binaire
+    generateUnaryOperation(MOpcode::notl, mbb, cfg); // Génère un NOT binaire
     break;
   case lnot:
-    generateUnaryOperation("lnot", os, cfg); // Génère un NOT logique
+    generateLogicalNot(mbb, cfg); // Génère un NOT logique
     break;
   case inc:
-    generateUnaryOperation("inc", os, cfg); // Génère une incrémentation
+    generateUnaryOperation(MOpcode::incl, mbb, cfg); // Génère une incrémentation
     break;
   case dec:
-    generateUnaryOperation("dec", os, cfg); // Génère une décrémentation
+    generateUnaryOperation(MOpcode::decl, mbb, cfg); // Génère une décrémentation
     break;
   case nothing:
     break; // Pas d'opération
   case call:
-    generateFunctionCall(os, cfg); // Génère un appel de fonction
+    generateFunctionCall(mbb, cfg); // Génère un appel de fonction
     break;
   case param:
-    generateFunctionParameterPassing(os, cfg); // Prépare un paramètre pour un appel
+    generateFunctionParameterPassing(mbb, cfg); // Prépare un paramètre pour un appel
     break;
   case param_decl:
     break; // Déclaration de paramètre (pas d'implémentation ici)
@@ -209,6 +233,21 @@ set<shared_ptr<Symbol>> IRInstr::getUsedVariables()
 set<shared_ptr<Symbol>> IRInstr::getDeclaredVariable()
 {
   set<shared_ptr<Symbol>> result;
+  int destinationIndex = getDestinationIndex();
+  if (destinationIndex >= 0)
+  {
+    result.insert(get<shared_ptr<Symbol>>(parameters[destinationIndex]));
+  }
+  return result;
+}
+
+/**
+ * Retourne la position, parmi les paramètres, de la variable écrite par
+ * cette instruction
+ * @return L'index du paramètre destination, ou -1 si aucune variable n'est écrite
+ */
+int IRInstr::getDestinationIndex() const
+{
   switch (operation)
   {
   case IRInstr::add:
@@ -225,27 +264,23 @@ set<shared_ptr<Symbol>> IRInstr::getDeclaredVariable()
   case IRInstr::geq:
   case IRInstr::eq:
   case IRInstr::neq:
-    result.insert(get<shared_ptr<Symbol>>(parameters[2])); // Ajoute la destination
-    break;
+    return 2; // La destination
   case IRInstr::ldconst:
   case IRInstr::lnot:
-    result.insert(get<shared_ptr<Symbol>>(parameters[1])); // Ajoute la destination
-    break;
+    return 1; // La destination
   case IRInstr::var_assign:
   case IRInstr::neg:
   case IRInstr::not_:
   case IRInstr::inc:
   case IRInstr::dec:
   case IRInstr::param_decl:
-    result.insert(get<shared_ptr<Symbol>>(parameters[0])); // Ajoute la variable
-    break;
+    return 0; // La variable
   case IRInstr::call:
     if (outType != Type::VOID)
     {
-      result.insert(
-          get<shared_ptr<Symbol>>(parameters[parameters.size() - 1])); // Ajoute la valeur de retour
+      return parameters.size() - 1; // La valeur de retour
     }
-    break;
+    return -1;
   case IRInstr::ret:
   case IRInstr::cmpNZ:
   case IRInstr::ldvar:
@@ -253,7 +288,32 @@ set<shared_ptr<Symbol>> IRInstr::getDeclaredVariable()
   case IRInstr::param:
     break; // Pas de variables déclarées
   }
-  return result;
+  return -1;
+}
+
+/**
+ * Retourne l'opérande source que l'allocateur devrait placer dans le même
+ * registre que la destination. Les opérations x86 sont à deux adresses
+ * (dest = dest op source) : lier la destination au premier opérande évite
+ * la copie préalable ; une affectation liée devient une copie vide.
+ * @return Le symbole lié à la destination, ou nullptr
+ */
+shared_ptr<Symbol> IRInstr::getTiedOperand()
+{
+  switch (operation)
+  {
+  case IRInstr::add:
+  case IRInstr::sub:
+  case IRInstr::mul:
+  case IRInstr::b_and:
+  case IRInstr::b_or:
+  case IRInstr::b_xor:
+    return get<shared_ptr<Symbol>>(parameters[0]); // Premier opérande
+  case IRInstr::var_assign:
+    return get<shared_ptr<Symbol>>(parameters[1]); // Source de la copie
+  default:
+    return nullptr;
+  }
 }
 
 /**
@@ -371,11 +431,12 @@ ostream &operator<<(ostream &os, IRInstr &instruction)
   return os;
 }
 
+
 /**
- * Génère le code assembleur pour une comparaison avec zéro
+ * Sélectionne les instructions pour une comparaison avec zéro
  * Utilisé pour les conditions if/while
  */
-void IRInstr::generateCompareNotZero(ostream &os, CFG *cfg)
+void IRInstr::generateCompareNotZero(MachineBasicBlock &mbb, CFG *cfg)
 {
   // Récupère le registre associé au premier paramètre
   int firstRegister =
@@ -384,20 +445,19 @@ void IRInstr::generateCompareNotZero(ostream &os, CFG *cfg)
   // Si le registre est un registre temporaire, charge la valeur depuis la pile
   if (firstRegister == cfg->scratchRegister)
   {
-    os << "movl -" << get<shared_ptr<Symbol>>(parameters[0])->offset
-       << "(%rbp), " << registers32[firstRegister] << endl;
+    mbb.emit(MOpcode::movl, {stackSlot(get<shared_ptr<Symbol>>(parameters[0])),
+                             reg32(firstRegister)});
   }
 
   // Effectue une opération de test sur le registre
-  os << "testl %" << registers32[firstRegister] << ", %"
-     << registers32[firstRegister] << endl;
+  mbb.emit(MOpcode::testl, {reg32(firstRegister), reg32(firstRegister)});
 }
 
 /**
- * Génère le code assembleur pour une division entière
+ * Sélectionne les instructions pour une division entière
  * Utilise les registres eax et edx pour stocker le résultat
  */
-void IRInstr::generateDivisionInstruction(ostream &os, CFG *cfg)
+void IRInstr::generateDivisionInstruction(MachineBasicBlock &mbb, CFG *cfg)
 {
   // Récupère les registres associés aux paramètres
   int firstRegister =
@@ -410,41 +470,40 @@ void IRInstr::generateDivisionInstruction(ostream &os, CFG *cfg)
   // Charge le premier opérande dans eax
   if (firstRegister == cfg->scratchRegister)
   {
-    os << "movl -" << get<shared_ptr<Symbol>>(parameters[0])->offset
-       << "(%rbp), %" << registers32[firstRegister] << endl;
+    mbb.emit(MOpcode::movl, {stackSlot(get<shared_ptr<Symbol>>(parameters[0])),
+                             reg32(firstRegister)});
   }
-  os << "movl %" << registers32[firstRegister] << ", %eax" << endl;
+  mbb.emit(MOpcode::movl, {reg32(firstRegister), MOperand::createReg(PhysReg::RAX)});
 
   // Initialise edx à 0 pour la division
-  os << "movl $0, %edx" << endl;
+  mbb.emit(MOpcode::movl, {MOperand::createImm(0), MOperand::createReg(PhysReg::RDX)});
 
   // Charge le second opérande si nécessaire
   if (secondRegister == cfg->scratchRegister)
   {
-    os << "movl -" << get<shared_ptr<Symbol>>(parameters[1])->offset
-       << "(%rbp), " << registers32[secondRegister] << endl;
+    mbb.emit(MOpcode::movl, {stackSlot(get<shared_ptr<Symbol>>(parameters[1])),
+                             reg32(secondRegister)});
   }
 
   // Effectue la division entière
-  os << "idivl %" << registers32[secondRegister] << endl;
+  mbb.emit(MOpcode::idivl, {reg32(secondRegister)});
 
   // Stocke le résultat dans le registre de destination
-  os << "movl %eax, %" << registers32[destRegister] << endl;
+  mbb.emit(MOpcode::movl, {MOperand::createReg(PhysReg::RAX), reg32(destRegister)});
 
   // Si le registre de destination est temporaire, sauvegarde le résultat dans la pile
   if (destRegister == cfg->scratchRegister)
   {
-    os << "movl %" << registers32[destRegister] << ", -"
-       << get<shared_ptr<Symbol>>(parameters[2])->offset << "(%rbp)"
-       << endl;
+    mbb.emit(MOpcode::movl, {reg32(destRegister),
+                             stackSlot(get<shared_ptr<Symbol>>(parameters[2]))});
   }
 }
 
 /**
- * Génère le code assembleur pour un modulo
+ * Sélectionne les instructions pour un modulo
  * Fonctionne comme la division mais conserve le reste dans edx
  */
-void IRInstr::generateModuloInstruction(ostream &os, CFG *cfg)
+void IRInstr::generateModuloInstruction(MachineBasicBlock &mbb, CFG *cfg)
 {
   // Récupère les registres associés aux paramètres
   int firstRegister =
@@ -457,41 +516,40 @@ void IRInstr::generateModuloInstruction(ostream &os, CFG *cfg)
   // Charge le premier opérande dans eax
   if (firstRegister == cfg->scratchRegister)
   {
-    os << "movl -" << get<shared_ptr<Symbol>>(parameters[0])->offset
-       << "(%rbp), %" << registers32[firstRegister] << endl;
+    mbb.emit(MOpcode::movl, {stackSlot(get<shared_ptr<Symbol>>(parameters[0])),
+                             reg32(firstRegister)});
   }
-  os << "movl %" << registers32[firstRegister] << ", %eax" << endl;
+  mbb.emit(MOpcode::movl, {reg32(firstRegister), MOperand::createReg(PhysReg::RAX)});
 
   // Initialise edx à 0 pour la division
-  os << "movl $0, %edx" << endl;
+  mbb.emit(MOpcode::movl, {MOperand::createImm(0), MOperand::createReg(PhysReg::RDX)});
 
   // Charge le second opérande si nécessaire
   if (secondRegister == cfg->scratchRegister)
   {
-    os << "movl -" << get<shared_ptr<Symbol>>(parameters[1])->offset
-       << "(%rbp), %" << registers32[secondRegister] << endl;
+    mbb.emit(MOpcode::movl, {stackSlot(get<shared_ptr<Symbol>>(parameters[1])),
+                             reg32(secondRegister)});
   }
 
   // Effectue la division entière
-  os << "idivl %" << registers32[secondRegister] << endl;
+  mbb.emit(MOpcode::idivl, {reg32(secondRegister)});
 
   // Stocke le reste (modulo) dans le registre de destination
-  os << "movl %edx, %" << registers32[destRegister] << endl;
+  mbb.emit(MOpcode::movl, {MOperand::createReg(PhysReg::RDX), reg32(destRegister)});
 
   // Si le registre de destination est temporaire, sauvegarde le résultat dans la pile
   if (destRegister == cfg->scratchRegister)
   {
-    os << "movl %" << registers32[destRegister] << ",-"
-       << get<shared_ptr<Symbol>>(parameters[2])->offset << "(%rbp)"
-       << endl;
+    mbb.emit(MOpcode::movl, {reg32(destRegister),
+                             stackSlot(get<shared_ptr<Symbol>>(parameters[2]))});
   }
 }
 
 /**
- * Génère le code assembleur pour une instruction return
+ * Sélectionne les instructions pour une instruction return
  * Gère à la fois les retours void et non-void
  */
-void IRInstr::generateReturnInstruction(ostream &os, CFG *cfg)
+void IRInstr::generateReturnInstruction(MachineBasicBlock &mbb, CFG *cfg)
 {
   // Si la fonction retourne une valeur, charge-la dans eax
   if (outType != Type::VOID)
@@ -501,22 +559,22 @@ void IRInstr::generateReturnInstruction(ostream &os, CFG *cfg)
 
     if (firstRegister == cfg->scratchRegister)
     {
-      os << "movl -" << get<shared_ptr<Symbol>>(parameters[0])->offset
-         << "(%rbp), %" << registers32[firstRegister] << endl;
+      mbb.emit(MOpcode::movl, {stackSlot(get<shared_ptr<Symbol>>(parameters[0])),
+                               reg32(firstRegister)});
     }
-    os << "movl %" << registers32[firstRegister] << ", %eax" << endl;
+    mbb.emit(MOpcode::movl, {reg32(firstRegister), MOperand::createReg(PhysReg::RAX)});
   }
 
   // Restaure la base de pile et retourne
-  os << "popq %rbp\n";
-  os << "ret\n";
+  mbb.emit(MOpcode::popq, {MOperand::createReg(PhysReg::RBP, 64)});
+  mbb.emit(MOpcode::ret);
 }
 
 /**
- * Génère le code assembleur pour une affectation de variable
+ * Sélectionne les instructions pour une affectation de variable
  * Gère différents types (int/char) avec les bonnes instructions mov
  */
-void IRInstr::generateVariableAssignment(ostream &os, CFG *cfg)
+void IRInstr::generateVariableAssignment(MachineBasicBlock &mbb, CFG *cfg)
 {
   // Récupère les registres associés à la source et à la destination
   int destRegister =
@@ -525,167 +583,150 @@ void IRInstr::generateVariableAssignment(ostream &os, CFG *cfg)
       cfg->getRegisterIndexForSymbol(get<shared_ptr<Symbol>>(parameters[1]));
   auto symbole = get<shared_ptr<Symbol>>(parameters[0]);
 
-  // Détermine l'instruction mov appropriée en fonction du type
-  string instr = (symbole->type == Type::CHAR ? "movb " : "movl ");
-  const string *registers =
-      (symbole->type == Type::CHAR ? registers8 : registers32);
-
   // Charge la source si elle est dans un registre temporaire
   if (sourceRegister == cfg->scratchRegister)
   {
-    os << "movl -" << get<shared_ptr<Symbol>>(parameters[1])->offset
-       << "(%rbp), %" << registers32[sourceRegister] << endl;
+    mbb.emit(MOpcode::movl, {stackSlot(get<shared_ptr<Symbol>>(parameters[1])),
+                             reg32(sourceRegister)});
   }
 
   // Effectue l'affectation entre registres
   if (sourceRegister != destRegister)
   {
-    os << "movl %" << registers32[sourceRegister] << ", %"
-       << registers32[destRegister] << "\n";
+    mbb.emit(MOpcode::movl, {reg32(sourceRegister), reg32(destRegister)});
   }
 
   // Si la destination est un registre temporaire, sauvegarde dans la pile
+  // avec l'instruction mov appropriée au type
   if (destRegister == cfg->scratchRegister)
   {
-    os << instr << " %" << registers32[destRegister] << ", -" << symbole->offset
-       << "(%rbp)" << endl;
+    if (symbole->type == Type::CHAR)
+    {
+      mbb.emit(MOpcode::movb, {reg8(destRegister), stackSlot(symbole)});
+    }
+    else
+    {
+      mbb.emit(MOpcode::movl, {reg32(destRegister), stackSlot(symbole)});
+    }
   }
 }
 
 /**
- * Génère le code assembleur pour charger une constante
+ * Sélectionne les instructions pour charger une constante
  * Utilise l'instruction mov avec une valeur immédiate
  */
-void IRInstr::generateLoadConstant(ostream &os, CFG *cfg)
+void IRInstr::generateLoadConstant(MachineBasicBlock &mbb, CFG *cfg)
 {
   // Récupère le symbole et la valeur de la constante
   auto symbole = get<shared_ptr<Symbol>>(parameters[1]);
   auto value = get<string>(parameters[0]);
   int destRegister = cfg->getRegisterIndexForSymbol(symbole);
 
-  // Détermine l'instruction mov appropriée en fonction du type
-  string instr = (symbole->type == Type::CHAR ? "movb" : "movl");
-  const string *registers =
-      (symbole->type == Type::CHAR ? registers8 : registers32);
-
   // Charge la constante dans le registre de destination
-  os << "movl $" << value << ", %" << registers32[destRegister] << endl;
+  mbb.emit(MOpcode::movl, {MOperand::createImm(strtoll(value.c_str(), nullptr, 10)),
+                           reg32(destRegister)});
 
   // Si le registre de destination est temporaire, sauvegarde dans la pile
   if (destRegister == cfg->scratchRegister)
   {
-    os << "movl %" << registers32[destRegister] << ", -"
-       << get<shared_ptr<Symbol>>(parameters[1])->offset << "(%rbp)"
-       << endl;
+    mbb.emit(MOpcode::movl, {reg32(destRegister), stackSlot(symbole)});
   }
 }
 
 /**
- * Génère le code assembleur pour charger une variable en mémoire
- * @param os Le flux de sortie pour écrire le code assembleur
+ * Sélectionne les instructions pour charger une variable en mémoire
+ * @param mbb Le bloc machine dans lequel ajouter les instructions
  * @param cfg Le graphe de flux de contrôle associé
  */
-void IRInstr::generateLoadVariable(ostream &os, CFG *cfg)
+void IRInstr::generateLoadVariable(MachineBasicBlock &mbb, CFG *cfg)
 {
   // Récupère le symbole et le registre de destination
   auto symbole = get<shared_ptr<Symbol>>(parameters[0]);
   int destRegister = cfg->getRegisterIndexForSymbol(symbole);
 
-  // Détermine l'instruction mov appropriée en fonction du type
-  string instr = (symbole->type == Type::CHAR ? "movb" : "movl");
-  const string *registers = (symbole->type == Type::CHAR ? registers8 : registers32);
-
-  // Charge la variable depuis la pile vers le registre
-  os << instr << " -" << symbole->offset << "(%rbp), %" 
-     << registers[destRegister] << endl;
+  // Charge la variable depuis la pile vers le registre, selon son type
+  if (symbole->type == Type::CHAR)
+  {
+    mbb.emit(MOpcode::movb, {stackSlot(symbole), reg8(destRegister)});
+  }
+  else
+  {
+    mbb.emit(MOpcode::movl, {stackSlot(symbole), reg32(destRegister)});
+  }
 }
 
 /**
- * Génère le code assembleur pour une opération binaire (add, sub, etc)
- * @param operation Le mnémonique assembleur (ex: "addl", "subl")
- * Gère les différents cas d'allocation de registres
+ * Sélectionne les instructions pour une opération binaire (add, sub, etc)
+ * @param operation L'opcode machine (ex: addl, subl)
+ * Les opérations x86 sont à deux adresses (dest = dest op source) : lorsque
+ * l'allocateur a lié la destination au premier opérande, une seule instruction
+ * en place est émise. Un opérande déchargé est lu directement en mémoire.
  */
-void IRInstr::generateBinaryOperation(const string &operation, ostream &os,
+void IRInstr::generateBinaryOperation(MOpcode operation, MachineBasicBlock &mbb,
                                       CFG *cfg)
 {
-  // Récupère les registres associés aux paramètres
-  int firstRegister =
-      cfg->getRegisterIndexForSymbol(get<shared_ptr<Symbol>>(parameters[0]));
-  int secondRegister =
-      cfg->getRegisterIndexForSymbol(get<shared_ptr<Symbol>>(parameters[1]));
-  int destRegister =
-      cfg->getRegisterIndexForSymbol(get<shared_ptr<Symbol>>(parameters[2]));
-
-  // Charge les opérandes si nécessaire et effectue l'opération
-  if (firstRegister == cfg->scratchRegister)
-  {
-    os << "movl -" << get<shared_ptr<Symbol>>(parameters[0])->offset
-       << "(%rbp), %" << registers32[firstRegister] << endl;
-  }
-  if (firstRegister == cfg->scratchRegister &&
-      secondRegister == cfg->scratchRegister &&
-      destRegister == cfg->scratchRegister)
-  {
-    os << operation << " -" << get<shared_ptr<Symbol>>(parameters[1])->offset
-       << "(%rbp), %" << registers32[destRegister] << endl;
-  }
-  else if (destRegister != secondRegister)
-  {
-    if (destRegister != firstRegister)
+  // Récupère les symboles et les registres associés aux paramètres
+  auto first = get<shared_ptr<Symbol>>(parameters[0]);
+  auto second = get<shared_ptr<Symbol>>(parameters[1]);
+  auto dest = get<shared_ptr<Symbol>>(parameters[2]);
+  int firstRegister = cfg->getRegisterIndexForSymbol(first);
+  int secondRegister = cfg->getRegisterIndexForSymbol(second);
+  int destRegister = cfg->getRegisterIndexForSymbol(dest);
+
+  // Opérandes sources : registre alloué ou case de pile si déchargé
+  MOperand firstOperand = firstRegister == cfg->scratchRegister
+                              ? stackSlot(first)
+                              : reg32(firstRegister);
+  MOperand secondOperand = secondRegister == cfg->scratchRegister
+                               ? stackSlot(second)
+                               : reg32(secondRegister);
+
+  if (destRegister == secondRegister && destRegister != firstRegister &&
+      destRegister != cfg->scratchRegister)
+  {
+    // La destination écrase le second opérande
+    if (isCommutative(operation))
     {
-      os << "movl %" << registers32[firstRegister] << ", %"
-         << registers32[destRegister] << "\n";
+      mbb.emit(operation, {firstOperand, reg32(destRegister)});
     }
-    if (secondRegister == cfg->scratchRegister)
+    else
     {
-      os << "movl -" << get<shared_ptr<Symbol>>(parameters[1])->offset
-         << "(%rbp), %" << registers32[secondRegister] << endl;
+      mbb.emit(MOpcode::movl, {secondOperand, reg32(cfg->scratchRegister)});
+      mbb.emit(MOpcode::movl, {firstOperand, reg32(destRegister)});
+      mbb.emit(operation, {reg32(cfg->scratchRegister), reg32(destRegister)});
     }
-    os << operation << " %" << registers32[secondRegister] << ", %"
-       << registers32[destRegister] << endl;
   }
   else
   {
-    if (secondRegister != cfg->scratchRegister)
+    // Forme deux adresses : dest = first, puis dest = dest op second
+    if (destRegister != firstRegister || destRegister == cfg->scratchRegister)
     {
-      if (firstRegister != cfg->scratchRegister)
-      {
-        os << "movl %" << registers32[secondRegister] << ", %"
-           << registers32[cfg->scratchRegister] << "\n";
-        os << "movl %" << registers32[firstRegister] << ", %"
-           << registers32[destRegister] << "\n";
-        os << operation << " %" << registers32[cfg->scratchRegister] << ", %"
-           << registers32[destRegister] << endl;
-      }
-      else
-      {
-        os << "xchg %" << registers32[secondRegister] << ", %"
-           << registers32[firstRegister] << endl;
-        os << operation << " %" << registers32[firstRegister] << ", %"
-           << registers32[destRegister] << endl;
-      }
+      mbb.emit(MOpcode::movl, {firstOperand, reg32(destRegister)});
+    }
+    mbb.emit(operation, {secondOperand, reg32(destRegister)});
+  }
+
+  // Si la destination est déchargée, sauvegarde le résultat dans la pile
+  if (destRegister == cfg->scratchRegister)
+  {
+    if (dest->type == Type::CHAR)
+    {
+      mbb.emit(MOpcode::movb, {reg8(destRegister), stackSlot(dest)});
     }
     else
     {
-      os << "movl -" << get<shared_ptr<Symbol>>(parameters[1])->offset
-         << "(%rbp), %" << registers32[secondRegister] << endl;
-      if (destRegister != firstRegister)
-      {
-        os << "movl %" << registers32[firstRegister] << ", %"
-           << registers32[destRegister] << "\n";
-      }
-      os << operation << " %" << registers32[secondRegister] << ", %"
-         << registers32[destRegister] << endl;
+      mbb.emit(MOpcode::movl, {reg32(destRegister), stackSlot(dest)});
     }
   }
 }
 
 /**
- * Génère le code assembleur pour une opération de comparaison
- * @param operation Le mnémonique assembleur (ex: "setl", "sete")
+ * Sélectionne les instructions pour une opération de comparaison
+ * @param operation L'opcode setcc correspondant (ex: setl, sete)
  * Produit un résultat booléen (0 ou 1) dans le registre de destination
  */
-void IRInstr::generateComparisonOperation(const string &operation, ostream &os, CFG *cfg)
+void IRInstr::generateComparisonOperation(MOpcode operation, MachineBasicBlock &mbb,
+                                          CFG *cfg)
 {
   // Récupère les registres associés aux paramètres
   int firstRegister =
@@ -699,38 +740,33 @@ void IRInstr::generateComparisonOperation(const string &operation, ostream &os,
   if (firstRegister == cfg->scratchRegister &&
       secondRegister == cfg->scratchRegister)
   {
-    os << "movl -" << get<shared_ptr<Symbol>>(parameters[0])->offset
-       << "(%rbp), %" << registers32[firstRegister] << endl;
-    os << "cmp -" << get<shared_ptr<Symbol>>(parameters[1])->offset
-       << "(%rbp)"
-       << ", %" << registers32[firstRegister] << endl;
-    os << "movzbl %" << registers8[cfg->scratchRegister] << ", %"
-       << registers32[destRegister] << endl;
+    mbb.emit(MOpcode::movl, {stackSlot(get<shared_ptr<Symbol>>(parameters[0])),
+                             reg32(firstRegister)});
+    mbb.emit(MOpcode::cmpl, {stackSlot(get<shared_ptr<Symbol>>(parameters[1])),
+                             reg32(firstRegister)});
   }
   else
   {
     if (firstRegister == cfg->scratchRegister)
     {
-      os << "movl -" << get<shared_ptr<Symbol>>(parameters[0])->offset
-         << "(%rbp), %" << registers32[firstRegister] << endl;
+      mbb.emit(MOpcode::movl, {stackSlot(get<shared_ptr<Symbol>>(parameters[0])),
+                               reg32(firstRegister)});
     }
     else if (secondRegister == cfg->scratchRegister)
     {
-      os << "movl -" << get<shared_ptr<Symbol>>(parameters[1])->offset
-         << "(%rbp), %" << registers32[secondRegister] << endl;
+      mbb.emit(MOpcode::movl, {stackSlot(get<shared_ptr<Symbol>>(parameters[1])),
+                               reg32(secondRegister)});
     }
-    os << "cmp %" << registers32[secondRegister] << ", %"
-       << registers32[firstRegister] << endl;
-    os << operation << " %" << registers8[cfg->scratchRegister] << endl;
-    os << "movzbl %" << registers8[cfg->scratchRegister] << ", %"
-       << registers32[destRegister] << endl;
+    mbb.emit(MOpcode::cmpl, {reg32(secondRegister), reg32(firstRegister)});
   }
+  mbb.emit(operation, {reg8(cfg->scratchRegister)});
+  mbb.emit(MOpcode::movzbl, {reg8(cfg->scratchRegister), reg32(destRegister)});
 
   // Si le registre de destination est temporaire, sauvegarde dans la pile
   if (destRegister == cfg->scratchRegister)
   {
-    os << "movl %" << registers32[destRegister] << ", -"
-       << get<shared_ptr<Symbol>>(parameters[2])->offset << "(%rbp)";
+    mbb.emit(MOpcode::movl, {reg32(destRegister),
+                             stackSlot(get<shared_ptr<Symbol>>(parameters[2]))});
   }
 }
 
@@ -749,181 +785,166 @@ int CFG::getRegisterIndexForSymbol(shared_ptr<Symbol> &param)
 }
 
 /**
- * Génère le code assembleur pour une opération unaire (neg, not, etc)
- * @param operation Le mnémonique assembleur (ex: "neg", "notl")
- * Gère les opérations arithmétiques et logiques
+ * Sélectionne les instructions pour une opération unaire (neg, not, inc, dec)
+ * @param operation L'opcode machine (ex: negl, notl)
  */
-void IRInstr::generateUnaryOperation(const string &operation, ostream &os, CFG *cfg)
+void IRInstr::generateUnaryOperation(MOpcode operation, MachineBasicBlock &mbb,
+                                     CFG *cfg)
 {
   auto symbole = get<shared_ptr<Symbol>>(parameters[0]);
   int varRegister = cfg->getRegisterIndexForSymbol(symbole);
 
-  // Gestion des opérations d'incrémentation et de décrémentation
-  if (operation == "inc" || operation == "dec")
+  // Gestion des opérations d'incrémentation et de décrémentation (en place)
+  if (operation == MOpcode::incl || operation == MOpcode::decl)
   {
     if (varRegister == cfg->scratchRegister)
     {
-      os << "movl -" << symbole->offset << "(%rbp), %"
-         << registers32[varRegister] << endl; // Charge la variable depuis la pile
+      mbb.emit(MOpcode::movl, {stackSlot(symbole), reg32(varRegister)}); // Charge la variable depuis la pile
     }
-    os << operation << " %" << registers32[varRegister] << "\n"; // Effectue l'opération
+    mbb.emit(operation, {reg32(varRegister)}); // Effectue l'opération
     if (varRegister == cfg->scratchRegister)
     {
-      os << "movl %" << registers32[varRegister] << ", -" << symbole->offset
-         << "(%rbp)" << endl; // Sauvegarde le résultat dans la pile
+      mbb.emit(MOpcode::movl, {reg32(varRegister), stackSlot(symbole)}); // Sauvegarde le résultat dans la pile
     }
+    return;
   }
-  // Gestion des opérations de négation et NOT binaire
-  if (operation == "neg" || operation == "notl")
+
+  // Gestion des opérations de négation et NOT binaire (résultat dans un temporaire)
+  if (varRegister == cfg->scratchRegister)
   {
-    if (varRegister == cfg->scratchRegister)
-    {
-      os << "movl -" << symbole->offset << "(%rbp), %"
-         << registers32[varRegister] << endl; // Charge la variable depuis la pile
-    }
-    else
-    {
-      os << "movl %" << registers32[varRegister] << ", %"
-         << registers32[cfg->scratchRegister] << endl; // Copie dans le registre scratch
-    }
-    os << operation << " %" << registers32[cfg->scratchRegister] << "\n"; // Effectue l'opération
-    auto destSymbol = get<shared_ptr<Symbol>>(parameters[1]);
-    int destRegister = cfg->getRegisterIndexForSymbol(destSymbol);
-    if (destRegister == cfg->scratchRegister)
-    {
-      os << "movl " << registers32[cfg->scratchRegister] << ", -"
-         << destSymbol->offset << "(%rbp)" << endl; // Sauvegarde le résultat dans la pile
-    }
-    else
-    {
-      os << "movl %" << registers32[cfg->scratchRegister] << ", %"
-         << registers32[destRegister] << endl; // Sauvegarde dans le registre de destination
-    }
+    mbb.emit(MOpcode::movl, {stackSlot(symbole), reg32(varRegister)}); // Charge la variable depuis la pile
   }
-  // Gestion de l'opération NOT logique
-  else if (operation == "lnot")
+  else
   {
-    os << "cmpl $0, %" << registers32[varRegister] << endl; // Compare avec 0
-    int varRegister = cfg->getRegisterIndexForSymbol(symbole);
-    if (varRegister == cfg->scratchRegister)
-    {
-      os << "movl %" << registers32[varRegister] << ", -" << symbole->offset
-         << "(%rbp)"
-         << "\n"; // Sauvegarde dans la pile
-    }
-    auto destSymbol = get<shared_ptr<Symbol>>(parameters[1]);
-    int destRegister = cfg->getRegisterIndexForSymbol(destSymbol);
-    if (destRegister == cfg->scratchRegister)
-    {
-      os << "movl -" << symbole->offset << "(%rbp), %"
-         << registers32[destRegister] << endl; // Charge dans le registre de destination
-    }
-    os << "sete %" << registers8[destRegister] << endl; // Définit le résultat (0 ou 1)
-    os << "movzbl %" << registers8[destRegister] << ", %"
-       << registers32[destRegister] << endl; // Étend le résultat à 32 bits
-    if (destRegister == cfg->scratchRegister)
-    {
-      os << "movl %" << registers32[destRegister] << ", -" << symbole->offset
-         << "(%rbp)" << endl; // Sauvegarde dans la pile
-    }
+    mbb.emit(MOpcode::movl, {reg32(varRegister), reg32(cfg->scratchRegister)}); // Copie dans le registre scratch
+  }
+  mbb.emit(operation, {reg32(cfg->scratchRegister)}); // Effectue l'opération
+  auto destSymbol = get<shared_ptr<Symbol>>(parameters[1]);
+  int destRegister = cfg->getRegisterIndexForSymbol(destSymbol);
+  if (destRegister == cfg->scratchRegister)
+  {
+    mbb.emit(MOpcode::movl, {reg32(cfg->scratchRegister), stackSlot(destSymbol)}); // Sauvegarde le résultat dans la pile
+  }
+  else
+  {
+    mbb.emit(MOpcode::movl, {reg32(cfg->scratchRegister), reg32(destRegister)}); // Sauvegarde dans le registre de destination
+  }
+}
+
+/**
+ * Sélectionne les instructions pour un NOT logique (!x)
+ * Produit 1 si l'opérande vaut zéro, 0 sinon
+ */
+void IRInstr::generateLogicalNot(MachineBasicBlock &mbb, CFG *cfg)
+{
+  auto symbole = get<shared_ptr<Symbol>>(parameters[0]);
+  int varRegister = cfg->getRegisterIndexForSymbol(symbole);
+
+  mbb.emit(MOpcode::cmpl, {MOperand::createImm(0), reg32(varRegister)}); // Compare avec 0
+  if (varRegister == cfg->scratchRegister)
+  {
+    mbb.emit(MOpcode::movl, {reg32(varRegister), stackSlot(symbole)}); // Sauvegarde dans la pile
+  }
+  auto destSymbol = get<shared_ptr<Symbol>>(parameters[1]);
+  int destRegister = cfg->getRegisterIndexForSymbol(destSymbol);
+  if (destRegister == cfg->scratchRegister)
+  {
+    mbb.emit(MOpcode::movl, {stackSlot(symbole), reg32(destRegister)}); // Charge dans le registre de destination
+  }
+  mbb.emit(MOpcode::sete, {reg8(destRegister)}); // Définit le résultat (0 ou 1)
+  mbb.emit(MOpcode::movzbl, {reg8(destRegister), reg32(destRegister)}); // Étend le résultat à 32 bits
+  if (destRegister == cfg->scratchRegister)
+  {
+    mbb.emit(MOpcode::movl, {reg32(destRegister), stackSlot(symbole)}); // Sauvegarde dans la pile
   }
 }
 
 /**
- * Génère le code assembleur pour un appel de fonction
+ * Sélectionne les instructions pour un appel de fonction
  * Gère:
  * - L'empilement des paramètres
- * - L'appel proprement dit  
+ * - L'appel proprement dit
  * - La récupération de la valeur de retour
  * - Le nettoyage de la pile
  */
-void IRInstr::generateFunctionCall(ostream &os, CFG *cfg)
+void IRInstr::generateFunctionCall(MachineBasicBlock &mbb, CFG *cfg)
 {
   string functionName = get<string>(parameters[0]); // Nom de la fonction appelée
-  CFG *function = cfg->get_visitor()->getFunction(functionName);
-  int parameterCount = function->get_parameters_type().size(); // Nombre de paramètres
+  // Arguments : entre le nom et, sauf pour une fonction void, la destination
+  int parameterCount = parameters.size() - (outType != Type::VOID ? 2 : 1);
+  MOperand rsp = MOperand::createReg(PhysReg::RSP, 64);
 
   // Aligne la pile si nécessaire
   int value = (cfg->nextFreeSymbolIndex + 16 - 1) / 16 * 16;
   if (value)
   {
-    os << "subq $" << value << ", %rsp" << endl;
+    mbb.emit(MOpcode::subq, {MOperand::createImm(value), rsp});
   }
   // Sauvegarde les registres utilisés
   for (int i = 0; i < 8; i++)
   {
-    os << "pushq %" << registers64[i] << endl;
+    mbb.emit(MOpcode::pushq, {reg64(i)});
   }
 
-  // Gestion des échanges de registres pour les paramètres
-  bool exchange = false;
-  if (parameterCount >= 6)
+  // Empile les arguments au-delà du sixième, du dernier au premier, en
+  // gardant la pile alignée sur 16 octets au moment de l'appel
+  int stackArgumentCount = max(parameterCount - 6, 0);
+  int padding = stackArgumentCount % 2 == 1 ? 8 : 0;
+  if (padding)
   {
-    auto symbol8 = get<shared_ptr<Symbol>>(parameters[5]);
-    auto symbol9 = get<shared_ptr<Symbol>>(parameters[6]);
-    if (cfg->getRegisterIndexForSymbol(symbol8) == 1 && cfg->getRegisterIndexForSymbol(symbol9) == 0)
-    {
-      os << "xchg %r8d, %r9d" << endl;
-      exchange = true;
-    }
+    mbb.emit(MOpcode::subq, {MOperand::createImm(padding), rsp});
   }
-  // Empile les paramètres
-  for (int i = parameterCount - 1; i >= 0; i--)
+  for (int i = parameterCount - 1; i >= 6; i--)
   {
-    if ((i == 4 || i == 5) && exchange)
-    {
-      continue;
-    }
     auto symbole = get<shared_ptr<Symbol>>(parameters[i + 1]);
     int paramRegister = cfg->getRegisterIndexForSymbol(symbole);
     if (paramRegister == cfg->scratchRegister)
     {
-      os << "movl -" << symbole->offset << "(%rbp), %"
-         << registers32[paramRegister] << endl;
-    }
-    if (i < 6)
-    {
-      os << "movl %" << registers32[paramRegister] << ", %" << paramRegisters[i]
-         << endl;
-    }
-    else
-    {
-      os << "pushq %" << registers64[paramRegister] << endl;
+      mbb.emit(MOpcode::movl, {stackSlot(symbole), reg32(paramRegister)});
     }
+    mbb.emit(MOpcode::pushq, {reg64(paramRegister)});
   }
 
-  auto returnVar = get<shared_ptr<Symbol>>(*parameters.rbegin());
+  // Place les six premiers arguments dans les registres de l'ABI : certains
+  // (r8d, r9d) peuvent être à la fois source et destination
+  ParallelMove argumentMoves;
+  for (int i = 0; i < min(parameterCount, 6); i++)
+  {
+    auto symbole = get<shared_ptr<Symbol>>(parameters[i + 1]);
+    int paramRegister = cfg->getRegisterIndexForSymbol(symbole);
+    argumentMoves.add(paramRegister == cfg->scratchRegister ? stackSlot(symbole)
+                                                            : reg32(paramRegister),
+                      MOperand::createReg(paramPhysRegs[i]));
+  }
+  argumentMoves.emit(mbb, allocatableRegister(cfg->scratchRegister));
 
-  os << "call " << functionName << endl; // Appelle la fonction
-  int paramRegister = cfg->getRegisterIndexForSymbol(returnVar);
+  mbb.emit(MOpcode::call, {MOperand::createLabel(functionName)}); // Appelle la fonction
 
-  // Restaure les registres sauvegardés
-  for (int i = 0; i < 8; i++)
+  // Dépile les arguments puis restaure les registres sauvegardés
+  if (stackArgumentCount || padding)
   {
-    os << "popq %" << registers64[7 - i] << endl;
+    mbb.emit(MOpcode::addq, {MOperand::createImm(8 * stackArgumentCount + padding), rsp});
   }
-
-  for (int i = 7; i <= parameterCount; i++)
+  for (int i = 0; i < 8; i++)
   {
-    os << "popq %" << registers64[cfg->scratchRegister] << endl;
+    mbb.emit(MOpcode::popq, {reg64(7 - i)});
   }
   if (value)
   {
-    os << "addq $" << value << ", %rsp" << endl;
+    mbb.emit(MOpcode::addq, {MOperand::createImm(value), rsp});
   }
 
   // Récupère la valeur de retour si nécessaire
   if (outType != Type::VOID)
   {
-    os << "movl %eax, %" << registers32[paramRegister] << endl;
-    os << "movl %" << registers32[paramRegister] << ", -" << returnVar->offset
-       << "(%rbp)" << endl;
-  }
+    auto returnVar = get<shared_ptr<Symbol>>(*parameters.rbegin());
+    int paramRegister = cfg->getRegisterIndexForSymbol(returnVar);
 
-  if (outType != Type::VOID && paramRegister != cfg->scratchRegister)
-  {
-    os << "movl -" << returnVar->offset << "(%rbp)"
-       << ", %" << registers32[paramRegister] << endl;
+    mbb.emit(MOpcode::movl, {MOperand::createReg(PhysReg::RAX), reg32(paramRegister)});
+    if (paramRegister == cfg->scratchRegister)
+    {
+      mbb.emit(MOpcode::movl, {reg32(paramRegister), stackSlot(returnVar)});
+    }
   }
 }
 
@@ -931,7 +952,7 @@ void IRInstr::generateFunctionCall(ostream &os, CFG *cfg)
  * Prépare le passage d'un paramètre pour un appel de fonction
  * L'empilement effectif sera fait par generateFunctionCall
  */
-void IRInstr::generateFunctionParameterPassing(ostream &os, CFG *cfg)
+void IRInstr::generateFunctionParameterPassing(MachineBasicBlock &mbb, CFG *cfg)
 {
   cfg->push_parameter(get<shared_ptr<Symbol>>(parameters[0])); // Ajoute le paramètre
-}
\ No newline at end of file
+}
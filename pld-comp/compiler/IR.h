@@ -11,28 +11,24 @@
 #include <variant>
 #include <vector>
 
+#include "SmallVector.h"
 #include "Symbol.h"
 #include "Type.h"
 #include "ErrorListenerVisitor.h"
+#include "MachineIR.h"
 
 using namespace std;
 
 // Déclarations anticipées
 class BasicBlock;
 class CFG;
-class CodeGenVisitor;
-
-// Alias pour une table des symboles
-typedef map<string, shared_ptr<Symbol>> SymbolTable;
 
 // Un paramètre peut être soit un symbole (variable), soit une chaîne littérale (ex: label)
 typedef variant<shared_ptr<Symbol>, string> Parameter;
 
-// Registres utilisés pour la génération de code assembleur
-const string registers8[] = {"r8b", "r9b", "r10b", "r11b", "r12b", "r13b", "r14b", "r15b"};
-const string registers32[] = {"r8d", "r9d", "r10d", "r11d", "r12d", "r13d", "r14d", "r15d"};
-const string registers64[] = {"r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15"};
-const string paramRegisters[] = {"edi", "esi", "edx", "ecx", "r8d", "r9d"};
+// Paramètres d'une instruction : rangés dans l'instruction elle-même jusqu'à
+// trois (opérandes et destination), au-delà seulement pour les appels
+typedef SmallVector<Parameter, 3> ParameterList;
 
 // Surcharge pour l'affichage d'un paramètre (utile pour debug ou génération)
 ostream &operator<<(ostream &os, const Parameter &param);
@@ -76,34 +72,42 @@ public:
   } Operation;
 
   // Constructeur
-  IRInstr(BasicBlock *basicBlock, Operation operation, Type type, const vector<Parameter> &parameters);
+  IRInstr(BasicBlock *basicBlock, Operation operation, Type type, ParameterList parameters);
 
-  // Génère le code assembleur pour cette instruction
-  void genAsm(ostream &os, CFG *cfg);
+  // Sélectionne les instructions machine correspondant à cette instruction IR
+  void selectInstructions(MachineBasicBlock &mbb, CFG *cfg);
 
   friend ostream &operator<<(ostream &os, IRInstr &instruction);
 
   // Fonctions utilitaires pour l'allocation de registres
   set<shared_ptr<Symbol>> getUsedVariables();    // Retourne les variables utilisées
   set<shared_ptr<Symbol>> getDeclaredVariable(); // Retourne celles déclarées ici
+  shared_ptr<Symbol> getTiedOperand();          // Source à placer dans le registre de la destination
+  int getDestinationIndex() const;               // Position du paramètre écrit (-1 si aucun)
+
+  // Accesseurs utilisés pour l'affichage de l'IR
+  inline Operation getOperation() const { return operation; }
+  inline Type getType() const { return outType; }
+  inline const ParameterList &getParameters() const { return parameters; }
 
 private:
   Type outType;                  // Type de retour
-  vector<Parameter> parameters; // Paramètres de l'instruction
+  ParameterList parameters;     // Paramètres de l'instruction
   Operation operation;                  // Type de l'instruction
   BasicBlock *block;             // Basic block auquel cette instruction appartient
 
-  // Fonctions de génération d'assembleur pour les différents types d'opérations
-  void generateCompareNotZero(ostream &os, CFG *cfg);
-  void generateDivisionInstruction(ostream &os, CFG *cfg);
-  void generateModuloInstruction(ostream &os, CFG *cfg);
-  void generateReturnInstruction(ostream &os, CFG *cfg);
-  void generateVariableAssignment(ostream &os, CFG *cfg);
-  void generateLoadConstant(ostream &os, CFG *cfg);
-  void generateLoadVariable(ostream &os, CFG *cfg);
-  void generateUnaryOperation(const string &operation, ostream &os, CFG *cfg);
-  void generateFunctionCall(ostream &os, CFG *cfg);
-  void generateFunctionParameterPassing(ostream &os, CFG *cfg);
-  void generateBinaryOperation(const string &operation, ostream &os, CFG *cfg);
-  void generateComparisonOperation(const string &operation, ostream &os, CFG *cfg);
+  // Fonctions de sélection d'instructions pour les différents types d'opérations
+  void generateCompareNotZero(MachineBasicBlock &mbb, CFG *cfg);
+  void generateDivisionInstruction(MachineBasicBlock &mbb, CFG *cfg);
+  void generateModuloInstruction(MachineBasicBlock &mbb, CFG *cfg);
+  void generateReturnInstruction(MachineBasicBlock &mbb, CFG *cfg);
+  void generateVariableAssignment(MachineBasicBlock &mbb, CFG *cfg);
+  void generateLoadConstant(MachineBasicBlock &mbb, CFG *cfg);
+  void generateLoadVariable(MachineBasicBlock &mbb, CFG *cfg);
+  void generateUnaryOperation(MOpcode operation, MachineBasicBlock &mbb, CFG *cfg);
+  void generateLogicalNot(MachineBasicBlock &mbb, CFG *cfg);
+  void generateFunctionCall(MachineBasicBlock &mbb, CFG *cfg);
+  void generateFunctionParameterPassing(MachineBasicBlock &mbb, CFG *cfg);
+  void generateBinaryOperation(MOpcode operation, MachineBasicBlock &mbb, CFG *cfg);
+  void generateComparisonOperation(MOpcode operation, MachineBasicBlock &mbb, CFG *cfg);
 };
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include "IRPrinter.h"
+#include "BasicBlock.h"
+#include "CFG.h"
+#include "IR.h"
+#include "MachineIR.h"
+
+// Noms des opérations IR, indexés par IRInstr::Operation
+static const char *operationNames[] = {
+    "var_assign", "ldconst", "ldvar", "add", "sub", "mul", "div",
+    "mod", "b_and", "b_or", "b_xor", "cmpNZ", "ret", "leq",
+    "lt", "geq", "gt", "eq", "neq", "neg", "not",
+    "lnot", "inc", "dec", "nothing", "call", "param", "param_decl"};
+
+bool parseIRPass(const string &name, IRPass &pass)
+{
+  if (name == "lower")
+  {
+    pass = IRPass::Lower;
+  }
+  else if (name == "regalloc")
+  {
+    pass = IRPass::Regalloc;
+  }
+  else
+  {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Affiche une fonction : en-tête, puis chaque bloc avec ses successeurs et
+ * ses instructions
+ * @param cfg Le CFG de la fonction
+ * @param withRegisters Affiche le registre (ou "spill") de chaque symbole
+ */
+void IRPrinter::printFunction(CFG &cfg, bool withRegisters)
+{
+  vector<BasicBlock *> &blocks = cfg.getBlocks();
+  blockNames.clear();
+  for (size_t i = 0; i < blocks.size(); i++)
+  {
+    blockNames[blocks[i]] = blocks[i]->label.empty() ? "bb" + to_string(i) : blocks[i]->label;
+  }
+
+  o << "function " << cfg.get_name() << ' ' << getTypeName(cfg.get_return_type()) << '\n';
+  for (BasicBlock *block : blocks)
+  {
+    o << "block " << blockNames[block];
+    if (block->exit_true != nullptr)
+    {
+      o << " true=" << blockNames[block->exit_true];
+    }
+    if (block->exit_false != nullptr)
+    {
+      o << " false=" << blockNames[block->exit_false];
+    }
+    o << '\n';
+    for (const IRInstr *instruction : block->instructions)
+    {
+      printInstruction(cfg, *instruction, withRegisters);
+    }
+  }
+}
+
+/**
+ * Affiche une instruction : opération, type, puis ses opérandes dans l'ordre
+ * des paramètres, la variable écrite étant marquée "dst="
+ */
+void IRPrinter::printInstruction(CFG &cfg, const IRInstr &instruction, bool withRegisters)
+{
+  o << "  " << operationNames[instruction.getOperation()] << ' '
+    << getTypeName(instruction.getType());
+
+  int destinationIndex = instruction.getDestinationIndex();
+  const ParameterList &parameters = instruction.getParameters();
+  for (size_t i = 0; i < parameters.size(); i++)
+  {
+    o << ((int)i == destinationIndex ? " dst=" : " src=");
+    if (holds_alternative<shared_ptr<Symbol>>(parameters[i]))
+    {
+      shared_ptr<Symbol> symbole = get<shared_ptr<Symbol>>(parameters[i]);
+      const string &identifier = symbole->identifierName;
+      o << (identifier[0] == '!' ? "tmp:" : "var:") << identifier << '#' << symbole->offset;
+      if (withRegisters)
+      {
+        int registerIndex = cfg.getRegisterIndexForSymbol(symbole);
+        if (registerIndex == cfg.scratchRegister)
+        {
+          o << "@spill";
+        }
+        else
+        {
+          o << '@' << getRegisterName(allocatableRegister(registerIndex), 32);
+        }
+      }
+    }
+    else
+    {
+      o << (instruction.getOperation() == IRInstr::call ? "func:" : "const:")
+        << get<string>(parameters[i]);
+    }
+  }
+  o << '\n';
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "AsmWriter.h"
+
+using namespace std;
+
+class CFG;
+class BasicBlock;
+class IRInstr;
+
+// Passes après lesquelles l'IR peut être affiché (option -dump-ir)
+enum class IRPass
+{
+  None,
+  Lower,   // Après la génération de l'IR par CodeGenVisitor
+  Regalloc // Après l'allocation de registres (registres affichés)
+};
+
+// Convertit un nom de passe ("lower", "regalloc") ; false si inconnu
+bool parseIRPass(const string &name, IRPass &pass);
+
+// ========== Classe IRPrinter ==========
+// Affiche l'IR d'une fonction dans un format texte stable, une entrée par ligne :
+//   function <nom> <type>
+//   block <nom> [true=<bloc>] [false=<bloc>]
+//     <opération> <type> (dst=<opérande>|src=<opérande>)*
+// Un opérande est "var:<nom>#<case>", "tmp:<nom>#<case>" ou "const:<valeur>"
+// (suivi de "@<registre>" ou "@spill" après l'allocation), ou "func:<nom>".
+// Les blocs sans label sont nommés "bb<index>".
+class IRPrinter
+{
+public:
+  explicit IRPrinter(AsmWriter &o) : o(o) {}
+
+  void printFunction(CFG &cfg, bool withRegisters);
+
+private:
+  AsmWriter &o;
+  map<BasicBlock *, string> blockNames;
+
+  void printInstruction(CFG &cfg, const IRInstr &instruction, bool withRegisters);
+};
@@ -0,0 +1,137 @@
+#include "IncludeCache.h"
+
+#include <sys/stat.h>
+
+#include "Sha256.h"
+#include "SourceFile.h"
+
+/**
+ * Cherche la garde contre l'inclusion multiple d'un fichier : tout son
+ * contenu est compris entre "#ifndef G" (ou "#if !defined G") et le #endif
+ * correspondant, sans #else ni #elif à ce niveau. Les commentaires ne
+ * produisant pas de token, ils peuvent précéder et suivre la garde.
+ * @param file Le fichier, découpé avec ses directives
+ * @return Le nom de la macro G, ou "" si le fichier n'a pas cette forme
+ */
+static string findGuard(const IncludedFile &file)
+{
+  const vector<LexToken> &tokens = file.tokens;
+  auto spelling = [&](size_t i)
+  {
+    return string_view(file.contents).substr(tokens[i].offset, tokens[i].length);
+  };
+  auto kind = [&](size_t i)
+  {
+    return i < tokens.size() ? tokens[i].kind : TokenKind::EndOfInput;
+  };
+
+  // Première directive : #ifndef G, #if !defined G ou #if !defined(G)
+  size_t i = 2;
+  if (kind(0) != TokenKind::Hash)
+  {
+    return "";
+  }
+  if (spelling(1) == "if" && kind(2) == TokenKind::Not && spelling(3) == "defined")
+  {
+    i = 4;
+  }
+  else if (spelling(1) != "ifndef")
+  {
+    return "";
+  }
+  bool parenthesized = kind(i) == TokenKind::LeftParen;
+  i += parenthesized;
+  if (kind(i) != TokenKind::Identifier)
+  {
+    return "";
+  }
+  string guard(spelling(i++));
+  if (parenthesized && kind(i++) != TokenKind::RightParen)
+  {
+    return "";
+  }
+  if (kind(i++) != TokenKind::EndOfDirective)
+  {
+    return "";
+  }
+
+  // Le #endif qui la ferme doit être le dernier token du fichier
+  size_t depth = 1;
+  while (kind(i) != TokenKind::EndOfInput)
+  {
+    if (kind(i) != TokenKind::Hash)
+    {
+      i++;
+      continue;
+    }
+    string_view directive = kind(i + 1) != TokenKind::EndOfDirective ? spelling(i + 1) : "";
+    if (directive == "if" || directive == "ifdef" || directive == "ifndef")
+    {
+      depth++;
+    }
+    else if ((directive == "else" || directive == "elif") && depth == 1)
+    {
+      return "";
+    }
+    else if (directive == "endif" && --depth == 0)
+    {
+      while (kind(i) != TokenKind::EndOfDirective)
+      {
+        i++;
+      }
+      return kind(i + 1) == TokenKind::EndOfInput ? guard : "";
+    }
+    // Les '#' à l'intérieur de la directive n'en commencent pas une autre
+    while (kind(i) != TokenKind::EndOfDirective)
+    {
+      i++;
+    }
+  }
+  return "";
+}
+
+/**
+ * Retourne un fichier du cache, après avoir vérifié qu'il n'a pas changé
+ * depuis sa lecture ; sinon le (re)lit, calcule son empreinte, le découpe et
+ * cherche sa garde.
+ * La lecture se fait hors du verrou : deux threads qui demandent en même
+ * temps un fichier absent peuvent le lire tous les deux, sans autre effet.
+ * @param path Le chemin du fichier
+ */
+shared_ptr<const IncludedFile> IncludeCache::load(const string &path)
+{
+  struct stat status;
+  if (stat(path.c_str(), &status) != 0 || !S_ISREG(status.st_mode))
+  {
+    return nullptr;
+  }
+  {
+    lock_guard<mutex> guard(lock);
+    auto entry = entries.find(path);
+    timespec modified = modificationTime(status);
+    if (entry != entries.end() && entry->second.size == status.st_size &&
+        entry->second.modified.tv_sec == modified.tv_sec &&
+        entry->second.modified.tv_nsec == modified.tv_nsec)
+    {
+      return entry->second.file;
+    }
+  }
+
+  SourceFile source;
+  if (!source.open(path))
+  {
+    return nullptr;
+  }
+  auto file = make_shared<IncludedFile>();
+  file->path = path;
+  file->contents = string(source.contents());
+  Sha256 hash;
+  hash.update(file->contents);
+  file->digest = hash.hexDigest();
+  file->tokens = FastLexer(file->contents, true).tokenize();
+  file->guard = findGuard(*file);
+
+  lock_guard<mutex> guard(lock);
+  entries[path] = {file, modificationTime(status), status.st_size};
+  return file;
+}
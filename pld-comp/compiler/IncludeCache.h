@@ -0,0 +1,50 @@
+#pragma once
+
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <unordered_map>
+#include <vector>
+
+#include "FastLexer.h"
+
+using namespace std;
+
+// ========== Structure IncludedFile ==========
+// Fichier inclus, lu et découpé une seule fois : ses tokens (directives
+// comprises) désignent leur texte par une position dans contents
+struct IncludedFile
+{
+  string path;
+  string contents;
+  string digest; // Empreinte SHA-256 du contenu (dépendances du cache de compilation)
+  vector<LexToken> tokens;
+  // Macro de la garde contre l'inclusion multiple ("" : le fichier n'en a pas).
+  // Tant qu'elle est définie, une nouvelle inclusion ne produirait rien.
+  string guard;
+};
+
+// ========== Classe IncludeCache ==========
+// Fichiers inclus gardés en mémoire d'une compilation à l'autre (driver avec
+// plusieurs sources, serveur de compilation). Un fichier n'est relu que si sa
+// date de modification ou sa taille a changé. Peut être utilisé par
+// plusieurs threads à la fois.
+class IncludeCache
+{
+public:
+  // Le fichier path, lu si besoin ; nullptr s'il ne peut pas être lu
+  shared_ptr<const IncludedFile> load(const string &path);
+
+private:
+  struct Entry
+  {
+    shared_ptr<const IncludedFile> file;
+    timespec modified;
+    off_t size;
+  };
+
+  mutex lock;
+  unordered_map<string, Entry> entries;
+};
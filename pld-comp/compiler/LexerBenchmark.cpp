@@ -0,0 +1,124 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "antlr4-runtime.h"
+#include "generated/ifccLexer.h"
+
+#include "ErrorListenerVisitor.h"
+#include "FastLexer.h"
+#include "FastTokenSource.h"
+#include "SourceFile.h"
+
+using namespace std;
+using namespace antlr4;
+
+/**
+ * Exécute runs fois une analyse lexicale et affiche la meilleure durée,
+ * en tokens et en mégaoctets par seconde
+ * @param label Le nom du lexer mesuré
+ * @param size La taille du source, en octets
+ * @param runs Le nombre de mesures
+ * @param lex L'analyse mesurée, qui retourne le nombre de tokens produits
+ */
+static void measure(const string &label, size_t size, int runs, const function<size_t()> &lex)
+{
+  double best = 0;
+  size_t tokenCount = 0;
+  for (int i = 0; i < runs; i++)
+  {
+    auto start = chrono::steady_clock::now();
+    tokenCount = lex();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    best = i == 0 ? seconds : min(best, seconds);
+  }
+  cout << label << ": " << tokenCount << " tokens in " << best * 1000 << " ms, "
+       << tokenCount / best / 1e6 << " Mtokens/s, " << size / best / (1 << 20) << " MiB/s"
+       << endl;
+}
+
+/**
+ * Compare le débit de FastLexer (tableau de tokens compacts, puis tokens ANTLR
+ * via FastTokenSource) à celui de ifccLexer. Les sources sont concaténés et
+ * répétés jusqu'à la taille demandée.
+ * usage: lexer-bench [-size MiB] [-runs N] file.c ...
+ */
+int main(int argn, const char **argv)
+{
+  size_t targetSize = 8 << 20;
+  int runs = 5;
+  string corpus;
+  for (int i = 1; i < argn; i++)
+  {
+    string argument = argv[i];
+    if (argument == "-size" && i + 1 < argn)
+    {
+      targetSize = strtoull(argv[++i], nullptr, 10) << 20;
+    }
+    else if (argument == "-runs" && i + 1 < argn)
+    {
+      runs = max(1, atoi(argv[++i]));
+    }
+    else
+    {
+      ifstream file(argument);
+      if (!file)
+      {
+        cerr << "error: cannot read file: " << argument << endl;
+        return 1;
+      }
+      stringstream contents;
+      contents << file.rdbuf();
+      corpus += contents.str() + "\n";
+    }
+  }
+  if (corpus.empty())
+  {
+    cerr << "usage: lexer-bench [-size MiB] [-runs N] file.c ..." << endl;
+    return 1;
+  }
+
+  string source;
+  source.reserve(targetSize + corpus.size());
+  while (source.size() < targetSize)
+  {
+    source += corpus;
+  }
+  cout << "input: " << source.size() / double(1 << 20) << " MiB" << endl;
+
+  measure("FastLexer", source.size(), runs, [&]
+          { return FastLexer(source).tokenize().size() - 1; });
+
+  SyntaxErrorListener errors;
+  measure("FastTokenSource + CommonTokenStream", source.size(), runs, [&]
+          {
+            SourceCharStream input(source, "bench");
+            ifccLexer vocabularyLexer(&input);
+            FastTokenSource lexer(source, &input, vocabularyLexer.getVocabulary(), &errors);
+            CommonTokenStream tokens(&lexer);
+            tokens.fill();
+            return tokens.size() - 1;
+          });
+
+  measure("ifccLexer + CommonTokenStream", source.size(), runs, [&]
+          {
+            SourceCharStream input(source, "bench");
+            ifccLexer lexer(&input);
+            lexer.removeErrorListeners();
+            lexer.addErrorListener(&errors);
+            CommonTokenStream tokens(&lexer);
+            tokens.fill();
+            // Les espaces sont des tokens du canal caché
+            size_t count = 0;
+            for (Token *token : tokens.getTokens())
+            {
+              count += token->getChannel() == Token::DEFAULT_CHANNEL;
+            }
+            return count - 1;
+          });
+  return 0;
+}
@@ -0,0 +1,273 @@
+#include "MachineIR.h"
+
+// Noms des registres, indexés par PhysReg
+static const char *registerNames8[] = {"r8b", "r9b", "r10b", "r11b", "r12b",
+                                       "r13b", "r14b", "r15b", "al", "cl",
+                                       "dl", "sil", "dil", "bpl", "spl"};
+static const char *registerNames32[] = {"r8d", "r9d", "r10d", "r11d", "r12d",
+                                        "r13d", "r14d", "r15d", "eax", "ecx",
+                                        "edx", "esi", "edi", "ebp", "esp"};
+static const char *registerNames64[] = {"r8", "r9", "r10", "r11", "r12",
+                                        "r13", "r14", "r15", "rax", "rcx",
+                                        "rdx", "rsi", "rdi", "rbp", "rsp"};
+
+/**
+ * Retourne le nom assembleur d'un registre
+ * @param reg Le registre physique
+ * @param width La largeur souhaitée en bits (8, 32 ou 64)
+ */
+const char *getRegisterName(PhysReg reg, int width)
+{
+  int index = static_cast<int>(reg);
+  switch (width)
+  {
+  case 8:
+    return registerNames8[index];
+  case 64:
+    return registerNames64[index];
+  default:
+    return registerNames32[index];
+  }
+}
+
+/**
+ * Retourne le mnémonique AT&T d'un opcode machine
+ */
+const char *getMnemonic(MOpcode opcode)
+{
+  switch (opcode)
+  {
+  case MOpcode::movl:
+    return "movl";
+  case MOpcode::movb:
+    return "movb";
+  case MOpcode::movq:
+    return "movq";
+  case MOpcode::movzbl:
+    return "movzbl";
+  case MOpcode::addl:
+    return "addl";
+  case MOpcode::subl:
+    return "subl";
+  case MOpcode::imull:
+    return "imull";
+  case MOpcode::andl:
+    return "andl";
+  case MOpcode::orl:
+    return "orl";
+  case MOpcode::xorl:
+    return "xorl";
+  case MOpcode::negl:
+    return "negl";
+  case MOpcode::notl:
+    return "notl";
+  case MOpcode::incl:
+    return "incl";
+  case MOpcode::decl:
+    return "decl";
+  case MOpcode::cmpl:
+    return "cmpl";
+  case MOpcode::testl:
+    return "testl";
+  case MOpcode::idivl:
+    return "idivl";
+  case MOpcode::xchgl:
+    return "xchgl";
+  case MOpcode::sete:
+    return "sete";
+  case MOpcode::setne:
+    return "setne";
+  case MOpcode::setl:
+    return "setl";
+  case MOpcode::setle:
+    return "setle";
+  case MOpcode::setg:
+    return "setg";
+  case MOpcode::setge:
+    return "setge";
+  case MOpcode::pushq:
+    return "pushq";
+  case MOpcode::popq:
+    return "popq";
+  case MOpcode::addq:
+    return "addq";
+  case MOpcode::subq:
+    return "subq";
+  case MOpcode::call:
+    return "call";
+  case MOpcode::jmp:
+    return "jmp";
+  case MOpcode::je:
+    return "je";
+  case MOpcode::ret:
+    return "ret";
+  }
+  return "";
+}
+
+MOperand MOperand::createReg(PhysReg reg, int width)
+{
+  return MOperand{Reg, reg, width, 0, ""};
+}
+
+MOperand MOperand::createImm(long long value)
+{
+  return MOperand{Imm, PhysReg::RAX, 0, value, ""};
+}
+
+MOperand MOperand::createMem(PhysReg base, long long displacement)
+{
+  return MOperand{Mem, base, 64, displacement, ""};
+}
+
+MOperand MOperand::createLabel(const string &label)
+{
+  return MOperand{Label, PhysReg::RAX, 0, 0, label};
+}
+
+/**
+ * Deux opérandes sont égaux s'ils désignent le même emplacement ou la même valeur
+ */
+bool MOperand::operator==(const MOperand &other) const
+{
+  if (kind != other.kind)
+  {
+    return false;
+  }
+  switch (kind)
+  {
+  case Reg:
+    return reg == other.reg && width == other.width;
+  case Imm:
+    return value == other.value;
+  case Mem:
+    return reg == other.reg && value == other.value;
+  case Label:
+    return label == other.label;
+  }
+  return false;
+}
+
+/**
+ * Indique si un opcode modifie les drapeaux du processeur
+ * Un appel est considéré comme les modifiant
+ */
+bool writesFlags(MOpcode opcode)
+{
+  switch (opcode)
+  {
+  case MOpcode::addl:
+  case MOpcode::subl:
+  case MOpcode::imull:
+  case MOpcode::andl:
+  case MOpcode::orl:
+  case MOpcode::xorl:
+  case MOpcode::negl:
+  case MOpcode::incl:
+  case MOpcode::decl:
+  case MOpcode::cmpl:
+  case MOpcode::testl:
+  case MOpcode::idivl:
+  case MOpcode::addq:
+  case MOpcode::subq:
+  case MOpcode::call:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/**
+ * Indique si un opcode lit les drapeaux du processeur
+ */
+bool readsFlags(MOpcode opcode)
+{
+  switch (opcode)
+  {
+  case MOpcode::je:
+  case MOpcode::sete:
+  case MOpcode::setne:
+  case MOpcode::setl:
+  case MOpcode::setle:
+  case MOpcode::setg:
+  case MOpcode::setge:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/**
+ * Indique si un opcode transfère le contrôle (saut, appel ou retour)
+ */
+bool isControlFlow(MOpcode opcode)
+{
+  return opcode == MOpcode::jmp || opcode == MOpcode::je ||
+         opcode == MOpcode::call || opcode == MOpcode::ret;
+}
+
+/**
+ * Indique si une opération binaire est commutative
+ */
+bool isCommutative(MOpcode opcode)
+{
+  return opcode == MOpcode::addl || opcode == MOpcode::imull ||
+         opcode == MOpcode::andl || opcode == MOpcode::orl ||
+         opcode == MOpcode::xorl;
+}
+
+/**
+ * Indique si l'instruction peut modifier un registre physique
+ * La destination est le dernier opérande, sauf pour les comparaisons et
+ * les instructions aux effets implicites (idivl, xchgl, call)
+ */
+bool MachineInstr::mayWriteRegister(PhysReg reg) const
+{
+  switch (opcode)
+  {
+  case MOpcode::call:
+    return true;
+  case MOpcode::idivl:
+    return reg == PhysReg::RAX || reg == PhysReg::RDX;
+  case MOpcode::xchgl:
+    return (operands[0].isReg() && operands[0].reg == reg) ||
+           (operands[1].isReg() && operands[1].reg == reg);
+  case MOpcode::cmpl:
+  case MOpcode::testl:
+  case MOpcode::pushq:
+  case MOpcode::jmp:
+  case MOpcode::je:
+  case MOpcode::ret:
+    return false;
+  default:
+    return !operands.empty() && operands.back().isReg() &&
+           operands.back().reg == reg;
+  }
+}
+
+/**
+ * Indique si l'instruction peut écrire dans une case mémoire relative à %rbp
+ * Toute écriture à moins de 8 octets de la case est considérée comme un
+ * recouvrement ; les appels et les push/pop sont conservateurs
+ */
+bool MachineInstr::mayWriteMemory(const MOperand &slot) const
+{
+  switch (opcode)
+  {
+  case MOpcode::call:
+  case MOpcode::pushq:
+  case MOpcode::popq:
+    return true;
+  case MOpcode::cmpl:
+  case MOpcode::testl:
+    return false;
+  default:
+    if (operands.empty() || !operands.back().isMem() ||
+        operands.back().reg != slot.reg)
+    {
+      return false;
+    }
+    return operands.back().value > slot.value - 8 &&
+           operands.back().value < slot.value + 8;
+  }
+}
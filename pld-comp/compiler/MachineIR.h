@@ -0,0 +1,168 @@
+#pragma once
+
+// Inclusions nécessaires
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// ========== Registres physiques ==========
+// Les huit premiers registres (r8 à r15) sont ceux distribués par l'allocateur :
+// l'index d'allocation i correspond directement à PhysReg(i)
+enum class PhysReg
+{
+  R8,
+  R9,
+  R10,
+  R11,
+  R12,
+  R13,
+  R14,
+  R15,
+  RAX,
+  RCX,
+  RDX,
+  RSI,
+  RDI,
+  RBP,
+  RSP
+};
+
+// Registres utilisés pour le passage des six premiers arguments (ABI System V)
+const PhysReg paramPhysRegs[] = {PhysReg::RDI, PhysReg::RSI, PhysReg::RDX,
+                                 PhysReg::RCX, PhysReg::R8, PhysReg::R9};
+
+// Convertit un index de l'allocateur de registres en registre physique
+inline PhysReg allocatableRegister(int index) { return static_cast<PhysReg>(index); }
+
+// Nom assembleur d'un registre pour une largeur donnée (8, 32 ou 64 bits)
+const char *getRegisterName(PhysReg reg, int width);
+
+// ========== Opcodes machine ==========
+enum class MOpcode
+{
+  movl,
+  movb,
+  movq,
+  movzbl,
+  addl,
+  subl,
+  imull,
+  andl,
+  orl,
+  xorl,
+  negl,
+  notl,
+  incl,
+  decl,
+  cmpl,
+  testl,
+  idivl,
+  xchgl,
+  sete,
+  setne,
+  setl,
+  setle,
+  setg,
+  setge,
+  pushq,
+  popq,
+  addq,
+  subq,
+  call,
+  jmp,
+  je,
+  ret
+};
+
+// Mnémonique assembleur (syntaxe AT&T) d'un opcode
+const char *getMnemonic(MOpcode opcode);
+
+// Propriétés des opcodes utilisées par les passes sur le code machine
+bool writesFlags(MOpcode opcode); // Modifie (ou rend indéfinis) les drapeaux
+bool readsFlags(MOpcode opcode);  // Lit les drapeaux (sauts et setcc)
+bool isControlFlow(MOpcode opcode); // Saut, appel ou retour
+bool isCommutative(MOpcode opcode); // Opération binaire dont les opérandes s'échangent
+
+// ========== Classe MOperand ==========
+// Opérande d'une instruction machine : registre, immédiat, case mémoire ou label
+struct MOperand
+{
+  enum Kind
+  {
+    Reg,
+    Imm,
+    Mem,
+    Label
+  };
+
+  Kind kind;
+  PhysReg reg;     // Registre (Reg) ou registre de base (Mem)
+  int width;       // Largeur du registre en bits (Reg)
+  long long value; // Valeur (Imm) ou déplacement (Mem)
+  string label;    // Nom du label ou de la fonction (Label)
+
+  static MOperand createReg(PhysReg reg, int width = 32);
+  static MOperand createImm(long long value);
+  static MOperand createMem(PhysReg base, long long displacement);
+  static MOperand createLabel(const string &label);
+
+  inline bool isReg() const { return kind == Reg; }
+  inline bool isImm() const { return kind == Imm; }
+  inline bool isMem() const { return kind == Mem; }
+  inline bool isLabel() const { return kind == Label; }
+
+  bool operator==(const MOperand &other) const;
+  bool operator!=(const MOperand &other) const { return !(*this == other); }
+};
+
+// ========== Classe MachineInstr ==========
+// Instruction machine après allocation de registres.
+// Les opérandes suivent l'ordre AT&T : source(s) d'abord, destination en dernier.
+struct MachineInstr
+{
+  MOpcode opcode;
+  vector<MOperand> operands;
+
+  MachineInstr(MOpcode opcode, initializer_list<MOperand> operands)
+      : opcode(opcode), operands(operands) {}
+
+  // Indique si l'instruction peut modifier le registre physique donné (toutes largeurs)
+  bool mayWriteRegister(PhysReg reg) const;
+  // Indique si l'instruction peut écrire dans la case mémoire donnée
+  bool mayWriteMemory(const MOperand &slot) const;
+};
+
+// ========== Classe MachineBasicBlock ==========
+// Suite d'instructions machine précédée d'un label optionnel
+struct MachineBasicBlock
+{
+  string label; // Label du bloc (vide pour un bloc atteint uniquement en séquence)
+  vector<MachineInstr> instructions;
+
+  explicit MachineBasicBlock(const string &label) : label(label) {}
+
+  // Ajoute une instruction à la fin du bloc
+  inline void emit(MOpcode opcode, initializer_list<MOperand> operands = {})
+  {
+    instructions.emplace_back(opcode, operands);
+  }
+};
+
+// ========== Classe MachineFunction ==========
+// Code machine complet d'une fonction, dans l'ordre d'émission des blocs
+struct MachineFunction
+{
+  string name;
+  vector<MachineBasicBlock> blocks;
+
+  explicit MachineFunction(const string &name) : name(name) {}
+
+  // Ajoute un nouveau bloc à la fin de la fonction et le retourne
+  inline MachineBasicBlock &addBlock(const string &label)
+  {
+    blocks.emplace_back(label);
+    return blocks.back();
+  }
+};
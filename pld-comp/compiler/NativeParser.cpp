@@ -0,0 +1,536 @@
+#include "NativeParser.h"
+
+#include <algorithm>
+
+// Précédence des opérateurs binaires, dans l'ordre des alternatives de la
+// règle expr de ifcc.g4 (la première l'emporte) ; tous sont associatifs à
+// gauche. 0 : le token n'est pas un opérateur binaire.
+static int binaryPrecedence(TokenKind kind)
+{
+  switch (kind)
+  {
+  case TokenKind::Star:
+  case TokenKind::Slash:
+  case TokenKind::Percent:
+    return 10; // multdiv
+  case TokenKind::Plus:
+  case TokenKind::Minus:
+    return 9; // addsub
+  case TokenKind::Less:
+  case TokenKind::LessEqual:
+  case TokenKind::Greater:
+  case TokenKind::GreaterEqual:
+    return 8; // cmp
+  case TokenKind::Equal:
+  case TokenKind::NotEqual:
+    return 7; // eq
+  case TokenKind::BitAnd:
+    return 6;
+  case TokenKind::BitXor:
+    return 5;
+  case TokenKind::BitOr:
+    return 4;
+  case TokenKind::LogicalOr:
+    return 3;
+  case TokenKind::LogicalAnd:
+    return 2;
+  default:
+    return 0;
+  }
+}
+
+// L'opérande d'un opérateur unaire (alternative unaryOp, placée avant tous
+// les opérateurs binaires) ne contient aucun opérateur binaire
+static const int unaryOperandPrecedence = 11;
+
+static bool isType(TokenKind kind)
+{
+  return kind == TokenKind::Int || kind == TokenKind::Char || kind == TokenKind::Void;
+}
+
+static bool isAssignment(TokenKind kind)
+{
+  return kind == TokenKind::Assign || kind == TokenKind::PlusAssign ||
+         kind == TokenKind::MinusAssign || kind == TokenKind::StarAssign ||
+         kind == TokenKind::SlashAssign;
+}
+
+// Type désigné par un token TYPE
+static Type typeOf(TokenKind kind)
+{
+  return kind == TokenKind::Int ? Type::INT : kind == TokenKind::Char ? Type::CHAR : Type::VOID;
+}
+
+// Opérateur d'une expression binaire (binaryPrecedence(kind) != 0)
+static BinaryOperator binaryOperator(TokenKind kind)
+{
+  switch (kind)
+  {
+  case TokenKind::Star: return BinaryOperator::Mul;
+  case TokenKind::Slash: return BinaryOperator::Div;
+  case TokenKind::Percent: return BinaryOperator::Mod;
+  case TokenKind::Plus: return BinaryOperator::Add;
+  case TokenKind::Minus: return BinaryOperator::Sub;
+  case TokenKind::Less: return BinaryOperator::Less;
+  case TokenKind::LessEqual: return BinaryOperator::LessEqual;
+  case TokenKind::Greater: return BinaryOperator::Greater;
+  case TokenKind::GreaterEqual: return BinaryOperator::GreaterEqual;
+  case TokenKind::Equal: return BinaryOperator::Equal;
+  case TokenKind::NotEqual: return BinaryOperator::NotEqual;
+  case TokenKind::BitAnd: return BinaryOperator::BitAnd;
+  case TokenKind::BitXor: return BinaryOperator::BitXor;
+  case TokenKind::BitOr: return BinaryOperator::BitOr;
+  case TokenKind::LogicalAnd: return BinaryOperator::LogicalAnd;
+  default: return BinaryOperator::LogicalOr;
+  }
+}
+
+// Opérateur d'une affectation (isAssignment(kind))
+static AssignOperator assignOperator(TokenKind kind)
+{
+  switch (kind)
+  {
+  case TokenKind::PlusAssign: return AssignOperator::Add;
+  case TokenKind::MinusAssign: return AssignOperator::Sub;
+  case TokenKind::StarAssign: return AssignOperator::Mul;
+  case TokenKind::SlashAssign: return AssignOperator::Div;
+  default: return AssignOperator::Assign;
+  }
+}
+
+// Opérateur d'une expression unaire ('-', '~', '!', '+', '++' ou '--')
+static UnaryOperator unaryOperator(TokenKind kind)
+{
+  switch (kind)
+  {
+  case TokenKind::Minus: return UnaryOperator::Negate;
+  case TokenKind::Tilde: return UnaryOperator::BitNot;
+  case TokenKind::Not: return UnaryOperator::LogicalNot;
+  case TokenKind::Plus: return UnaryOperator::Plus;
+  case TokenKind::PlusPlus: return UnaryOperator::Increment;
+  default: return UnaryOperator::Decrement;
+  }
+}
+
+/**
+ * Lit les tokens du programme en entier ; les textes non reconnus sont
+ * signalés avec le message de ifccLexer, puis ignorés
+ * @param preprocessor Le préprocesseur du programme
+ */
+NativeParser::NativeParser(Preprocessor &preprocessor) : preprocessor(preprocessor)
+{
+  PreprocessedToken token;
+  do
+  {
+    token = preprocessor.next();
+    if (token.token.kind == TokenKind::Invalid)
+    {
+      lexicalErrors++;
+      DiagnosticEngine::current().report(ErrorType::Error, token.token.line, token.column + 1,
+                                         FastLexer::recognitionError(spelling(token)));
+      continue;
+    }
+    tokens.push_back(token);
+  } while (token.token.kind != TokenKind::EndOfInput);
+}
+
+TokenKind NativeParser::lookahead(size_t offset) const
+{
+  return position + offset < tokens.size() ? tokens[position + offset].token.kind
+                                           : TokenKind::EndOfInput;
+}
+
+// Passe au token suivant et retourne le token courant
+const PreprocessedToken &NativeParser::consume()
+{
+  const PreprocessedToken &token = tokens[position];
+  if (token.token.kind != TokenKind::EndOfInput)
+  {
+    position++;
+  }
+  return token;
+}
+
+/**
+ * Consomme le token courant s'il est de la catégorie attendue, sinon signale
+ * une erreur de syntaxe
+ * @param kind La catégorie attendue
+ * @param expected Sa description dans le message d'erreur (ex : "';'")
+ */
+const PreprocessedToken &NativeParser::expect(TokenKind kind, const char *expected)
+{
+  if (current() != kind)
+  {
+    reportError(expected);
+  }
+  return consume();
+}
+
+// Signale le token courant comme inattendu, avec le message de ifccParser
+void NativeParser::reportError(const string &expected)
+{
+  const PreprocessedToken &token = tokens[position];
+  string text = current() == TokenKind::EndOfInput ? "<EOF>" : string(spelling(token));
+  syntaxErrors++;
+  DiagnosticEngine::current().report(ErrorType::Error, token.token.line, token.column + 1,
+                                     "mismatched input '" + text + "' expecting " + expected);
+  throw SyntaxError();
+}
+
+string_view NativeParser::spelling(const PreprocessedToken &token) const
+{
+  return preprocessor.getSourceMap().text(token.token.offset, token.token.length);
+}
+
+Identifier NativeParser::identifier(const PreprocessedToken &token)
+{
+  return program->strings.intern(spelling(token));
+}
+
+// Alloue un nœud dans l'arène, à la position de son premier token
+template <class Node, class Kind>
+Node *NativeParser::create(Kind kind, const PreprocessedToken &start)
+{
+  Node *node = program->arena.make<Node>();
+  node->kind = kind;
+  node->location = {start.token.line, start.column + 1};
+  return node;
+}
+
+/**
+ * axiom : prog EOF ; prog : func+
+ * @return Le programme, qui ne dépend plus du source ni du préprocesseur
+ */
+unique_ptr<Program> NativeParser::parse()
+{
+  program = make_unique<Program>();
+  try
+  {
+    do
+    {
+      program->functions.push_back(function());
+    } while (isType(current()));
+    expect(TokenKind::EndOfInput, "{<EOF>, TYPE}");
+  }
+  catch (const SyntaxError &)
+  {
+    return nullptr;
+  }
+  if (lexicalErrors != 0 || preprocessor.getNumberOfErrors() != 0)
+  {
+    return nullptr;
+  }
+  return move(program);
+}
+
+// func : TYPE ID '(' (TYPE ID (',' TYPE ID)*)? ')' block
+FunctionDecl *NativeParser::function()
+{
+  if (!isType(current()))
+  {
+    reportError("TYPE");
+  }
+  const PreprocessedToken &start = consume();
+  FunctionDecl *function = program->arena.make<FunctionDecl>();
+  function->returnType = typeOf(start.token.kind);
+  function->name = identifier(expect(TokenKind::Identifier, "ID"));
+  expect(TokenKind::LeftParen, "'('");
+  vector<ParameterDecl> parameters;
+  if (current() != TokenKind::RightParen)
+  {
+    while (true)
+    {
+      if (!isType(current()))
+      {
+        reportError("{')', TYPE}");
+      }
+      Type type = typeOf(consume().token.kind);
+      parameters.push_back({type, identifier(expect(TokenKind::Identifier, "ID"))});
+      if (current() != TokenKind::Comma)
+      {
+        break;
+      }
+      consume();
+    }
+  }
+  expect(TokenKind::RightParen, "')'");
+  function->parameters = ArenaArray<ParameterDecl>(program->arena, parameters);
+
+  callees.clear();
+  function->body = block();
+  function->callees = ArenaArray<Identifier>(program->arena, callees);
+
+  const PreprocessedToken &stop = tokens[position - 1]; // '}' du corps
+  function->location = {start.token.line, start.column + 1};
+  function->lastLine = stop.token.line;
+  function->sourceStart = start.token.offset;
+  function->sourceEnd = static_cast<size_t>(stop.token.offset) + stop.token.length;
+  return function;
+}
+
+// block : '{' stmt* '}'
+BlockStmt *NativeParser::block()
+{
+  if (current() != TokenKind::LeftBrace)
+  {
+    reportError("'{'");
+  }
+  BlockStmt *block = create<BlockStmt>(StmtKind::Block, consume());
+  vector<Stmt *> statements;
+  while (current() != TokenKind::RightBrace && current() != TokenKind::EndOfInput)
+  {
+    statements.push_back(statement());
+  }
+  expect(TokenKind::RightBrace, "'}'");
+  block->statements = ArenaArray<Stmt *>(program->arena, statements);
+  return block;
+}
+
+// stmt : var_decl_stmt | var_assign_stmt | if_stmt | while_stmt | block
+//      | expr ';' | return_stmt
+Stmt *NativeParser::statement()
+{
+  if (isType(current()))
+  {
+    return declaration();
+  }
+  if (current() == TokenKind::Identifier && isAssignment(lookahead(1)))
+  {
+    return assignment();
+  }
+  switch (current())
+  {
+  case TokenKind::If:
+    return ifStatement();
+  case TokenKind::While:
+    return whileStatement();
+  case TokenKind::LeftBrace:
+    return block();
+  case TokenKind::Return:
+    return returnStatement();
+  default:
+  {
+    ExpressionStmt *statement = create<ExpressionStmt>(StmtKind::Expression, tokens[position]);
+    statement->expr = expression();
+    expect(TokenKind::Semicolon, "';'");
+    return statement;
+  }
+  }
+}
+
+// var_decl_stmt : TYPE var_decl_member (',' var_decl_member)* ';'
+// var_decl_member : ID ('=' expr)?
+Stmt *NativeParser::declaration()
+{
+  const PreprocessedToken &type = consume();
+  DeclarationStmt *declaration = create<DeclarationStmt>(StmtKind::Declaration, type);
+  declaration->type = typeOf(type.token.kind);
+  vector<Declarator> variables;
+  while (true)
+  {
+    const PreprocessedToken &name = expect(TokenKind::Identifier, "ID");
+    Declarator variable = {identifier(name), {name.token.line, name.column + 1}, nullptr};
+    if (current() == TokenKind::Assign)
+    {
+      consume();
+      variable.initializer = expression();
+    }
+    variables.push_back(variable);
+    if (current() != TokenKind::Comma)
+    {
+      break;
+    }
+    consume();
+  }
+  expect(TokenKind::Semicolon, "{',', ';'}");
+  declaration->variables = ArenaArray<Declarator>(program->arena, variables);
+  return declaration;
+}
+
+// var_assign_stmt : ID ('=' | '+=' | '-=' | '*=' | '/=') expr ';'
+Stmt *NativeParser::assignment()
+{
+  const PreprocessedToken &name = consume();
+  AssignmentStmt *assignment = create<AssignmentStmt>(StmtKind::Assignment, name);
+  assignment->name = identifier(name);
+  assignment->op = assignOperator(consume().token.kind);
+  assignment->value = expression();
+  expect(TokenKind::Semicolon, "';'");
+  return assignment;
+}
+
+// if_stmt : IF '(' expr ')' block (ELSE block)?
+Stmt *NativeParser::ifStatement()
+{
+  IfStmt *statement = create<IfStmt>(StmtKind::If, consume());
+  expect(TokenKind::LeftParen, "'('");
+  statement->condition = expression();
+  expect(TokenKind::RightParen, "')'");
+  statement->thenBlock = block();
+  statement->elseBlock = nullptr;
+  if (current() == TokenKind::Else)
+  {
+    consume();
+    statement->elseBlock = block();
+  }
+  return statement;
+}
+
+// while_stmt : WHILE '(' expr ')' block
+Stmt *NativeParser::whileStatement()
+{
+  WhileStmt *statement = create<WhileStmt>(StmtKind::While, consume());
+  expect(TokenKind::LeftParen, "'('");
+  statement->condition = expression();
+  expect(TokenKind::RightParen, "')'");
+  statement->body = block();
+  return statement;
+}
+
+// return_stmt : RETURN (expr)? ';'
+Stmt *NativeParser::returnStatement()
+{
+  ReturnStmt *statement = create<ReturnStmt>(StmtKind::Return, consume());
+  statement->value = current() != TokenKind::Semicolon ? expression() : nullptr;
+  expect(TokenKind::Semicolon, "';'");
+  return statement;
+}
+
+/**
+ * Analyse une expression par précédence des opérateurs : un opérande, puis
+ * tant que l'opérateur suivant est assez prioritaire, l'opération qu'il forme
+ * avec l'expression déjà lue (associativité à gauche, sans récursion le long
+ * des opérandes gauches). Chaque opération est placée, comme dans l'arbre
+ * d'ANTLR, au premier token de son opérande gauche, parenthèses comprises.
+ * @param minPrecedence Seuls les opérateurs de précédence supérieure sont acceptés
+ */
+Expr *NativeParser::expression(int minPrecedence)
+{
+  const PreprocessedToken &start = tokens[position];
+  Expr *left = primary();
+  int precedence;
+  while ((precedence = binaryPrecedence(current())) > minPrecedence)
+  {
+    BinaryExpr *expr = create<BinaryExpr>(ExprKind::Binary, start);
+    expr->op = binaryOperator(consume().token.kind);
+    expr->left = left;
+    expr->right = expression(precedence);
+    left = expr;
+  }
+  return left;
+}
+
+/**
+ * Analyse un opérande : alternatives postIncDec, preIncDec, par, unaryOp,
+ * func_call et val de la règle expr. Les parenthèses disparaissent : seul
+ * leur contenu est conservé.
+ */
+Expr *NativeParser::primary()
+{
+  switch (current())
+  {
+  case TokenKind::Identifier:
+    if (lookahead(1) == TokenKind::PlusPlus || lookahead(1) == TokenKind::MinusMinus)
+    {
+      // ID ('++' | '--') #postIncDec
+      const PreprocessedToken &name = consume();
+      IncDecExpr *expr = create<IncDecExpr>(ExprKind::PostIncDec, name);
+      expr->name = identifier(name);
+      expr->increment = consume().token.kind == TokenKind::PlusPlus;
+      return expr;
+    }
+    if (lookahead(1) == TokenKind::LeftParen)
+    {
+      // ID '(' (expr (',' expr)*)? ')' #func_call
+      const PreprocessedToken &name = consume();
+      CallExpr *expr = create<CallExpr>(ExprKind::Call, name);
+      expr->callee = identifier(name);
+      if (find(callees.begin(), callees.end(), expr->callee) == callees.end())
+      {
+        callees.push_back(expr->callee);
+      }
+      consume();
+      vector<Expr *> arguments;
+      if (current() != TokenKind::RightParen)
+      {
+        arguments.push_back(expression());
+        while (current() == TokenKind::Comma)
+        {
+          consume();
+          arguments.push_back(expression());
+        }
+      }
+      expect(TokenKind::RightParen, "')'");
+      expr->arguments = ArenaArray<Expr *>(program->arena, arguments);
+      return expr;
+    }
+    {
+      // ID #val
+      const PreprocessedToken &name = consume();
+      VariableExpr *expr = create<VariableExpr>(ExprKind::Variable, name);
+      expr->name = identifier(name);
+      return expr;
+    }
+
+  case TokenKind::IntegerLiteral:
+  {
+    // INTEGER_LITERAL #val
+    const PreprocessedToken &literal = consume();
+    ConstantExpr *expr = create<ConstantExpr>(ExprKind::Constant, literal);
+    expr->type = Type::INT;
+    expr->value = identifier(literal);
+    return expr;
+  }
+
+  case TokenKind::CharLiteral:
+  {
+    // CHAR_LITERAL #val : code du caractère entre les apostrophes
+    const PreprocessedToken &literal = consume();
+    ConstantExpr *expr = create<ConstantExpr>(ExprKind::Constant, literal);
+    expr->type = Type::CHAR;
+    expr->value = program->strings.intern(to_string(static_cast<int>(spelling(literal)[1])));
+    return expr;
+  }
+
+  case TokenKind::LeftParen:
+  {
+    // '(' expr ')' #par
+    consume();
+    Expr *expr = expression();
+    expect(TokenKind::RightParen, "')'");
+    return expr;
+  }
+
+  case TokenKind::PlusPlus:
+  case TokenKind::MinusMinus:
+    // "++x" est à la fois preIncDec et unaryOp appliqué à x : comme ifccParser,
+    // on retient preIncDec (première alternative), sauf si la suite de x
+    // ("++x++", "++f()") n'est possible qu'avec unaryOp
+    if (lookahead(1) == TokenKind::Identifier && lookahead(2) != TokenKind::PlusPlus &&
+        lookahead(2) != TokenKind::MinusMinus && lookahead(2) != TokenKind::LeftParen)
+    {
+      // ('++' | '--') ID #preIncDec
+      const PreprocessedToken &op = consume();
+      IncDecExpr *expr = create<IncDecExpr>(ExprKind::PreIncDec, op);
+      expr->increment = op.token.kind == TokenKind::PlusPlus;
+      expr->name = identifier(consume());
+      return expr;
+    }
+    [[fallthrough]];
+  case TokenKind::Minus:
+  case TokenKind::Tilde:
+  case TokenKind::Not:
+  case TokenKind::Plus:
+  {
+    // op=('-' | '~' | '!' | '++' | '--' | '+') expr #unaryOp
+    const PreprocessedToken &op = consume();
+    UnaryExpr *expr = create<UnaryExpr>(ExprKind::Unary, op);
+    expr->op = unaryOperator(op.token.kind);
+    expr->operand = expression(unaryOperandPrecedence);
+    return expr;
+  }
+
+  default:
+    reportError("{'(', '-', '~', '!', '++', '--', '+', INTEGER_LITERAL, CHAR_LITERAL, ID}");
+  }
+}
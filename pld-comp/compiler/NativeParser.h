@@ -0,0 +1,70 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Ast.h"
+#include "Preprocessor.h"
+
+using namespace std;
+
+// ========== Classe NativeParser ==========
+// Analyseur syntaxique écrit à la main pour ifcc.g4, utilisé à la place de
+// ifccParser avec -fparser=native : descente récursive pour les fonctions et
+// les instructions, précédence des opérateurs (Pratt) pour les expressions,
+// sans prédiction ALL(*). Il lit les tokens du préprocesseur et construit
+// directement l'arbre abstrait (Ast.h), le même que celui qu'AstBuilder tire
+// de l'arbre d'ANTLR, sans créer aucun token ni contexte d'ANTLR. Il
+// s'arrête à la première erreur de syntaxe.
+class NativeParser
+{
+public:
+  // Lit tous les tokens du préprocesseur, en signalant les erreurs lexicales
+  explicit NativeParser(Preprocessor &preprocessor);
+  NativeParser(const NativeParser &) = delete;
+  NativeParser &operator=(const NativeParser &) = delete;
+
+  // Analyse le programme ; nullptr si une erreur (lexicale, de prétraitement
+  // ou de syntaxe) a été signalée
+  unique_ptr<Program> parse();
+
+  size_t getNumberOfSyntaxErrors() const { return syntaxErrors; }
+
+private:
+  Preprocessor &preprocessor;
+  vector<PreprocessedToken> tokens;
+  size_t position = 0; // Indice du token courant
+  unique_ptr<Program> program;
+  vector<Identifier> callees; // Fonctions appelées par la fonction en cours
+  size_t lexicalErrors = 0;
+  size_t syntaxErrors = 0;
+
+  // Exception interne : remonte jusqu'à parse() après une erreur signalée
+  struct SyntaxError
+  {
+  };
+
+  TokenKind current() const { return tokens[position].token.kind; }
+  TokenKind lookahead(size_t offset) const;
+  const PreprocessedToken &consume();
+  const PreprocessedToken &expect(TokenKind kind, const char *expected);
+  [[noreturn]] void reportError(const string &expected);
+
+  string_view spelling(const PreprocessedToken &token) const;
+  Identifier identifier(const PreprocessedToken &token);
+  template <class Node, class Kind>
+  Node *create(Kind kind, const PreprocessedToken &start);
+
+  FunctionDecl *function();
+  BlockStmt *block();
+  Stmt *statement();
+  Stmt *declaration();
+  Stmt *assignment();
+  Stmt *ifStatement();
+  Stmt *whileStatement();
+  Stmt *returnStatement();
+  Expr *expression(int minPrecedence = 0);
+  Expr *primary();
+};
@@ -0,0 +1,135 @@
+#include "ParallelMove.h"
+
+/**
+ * Retourne l'opérande à la largeur demandée s'il s'agit d'un registre
+ */
+static MOperand withWidth(MOperand operand, int width)
+{
+  if (operand.isReg())
+  {
+    operand.width = width;
+  }
+  return operand;
+}
+
+/**
+ * Indique si un opérande lit le registre physique donné
+ */
+static bool readsRegister(const MOperand &operand, PhysReg reg)
+{
+  return operand.isReg() && operand.reg == reg;
+}
+
+/**
+ * Ajoute une copie à effectuer
+ * @param source Registre, case mémoire ou immédiat à copier
+ * @param destination Registre ou case mémoire à écrire
+ * @param width La largeur de la copie en bits (8 ou 32)
+ */
+void ParallelMove::add(const MOperand &source, const MOperand &destination, int width)
+{
+  moves.push_back({source, destination, width});
+}
+
+/**
+ * Séquentialise les copies :
+ * 1. les copies inutiles (source == destination) sont supprimées ;
+ * 2. les copies vers la mémoire sont émises d'abord, tant que tous les
+ *    registres sources ont encore leur valeur d'origine ;
+ * 3. une copie vers un registre est émise dès que ce registre n'est plus la
+ *    source d'aucune copie en attente ;
+ * 4. s'il ne reste que des cycles, un xchgl fixe une destination et les
+ *    copies qui lisaient celle-ci lisent désormais l'autre registre échangé.
+ * @param mbb Le bloc machine dans lequel ajouter les instructions
+ * @param scratch Registre libre utilisé pour les copies mémoire -> mémoire
+ */
+void ParallelMove::emit(MachineBasicBlock &mbb, PhysReg scratch)
+{
+  vector<Move> pending;
+  for (auto &move : moves)
+  {
+    if (move.source.isReg() && move.destination.isReg()
+            ? move.source.reg != move.destination.reg
+            : move.source != move.destination)
+    {
+      pending.push_back(move);
+    }
+  }
+  moves.clear();
+
+  // Copies vers la mémoire
+  for (size_t i = 0; i < pending.size();)
+  {
+    Move &move = pending[i];
+    if (!move.destination.isMem())
+    {
+      i++;
+      continue;
+    }
+    MOpcode opcode = move.width == 8 ? MOpcode::movb : MOpcode::movl;
+    if (move.source.isMem())
+    {
+      mbb.emit(MOpcode::movl, {move.source, MOperand::createReg(scratch)});
+      mbb.emit(opcode, {MOperand::createReg(scratch, move.width), move.destination});
+    }
+    else
+    {
+      mbb.emit(opcode, {withWidth(move.source, move.width), move.destination});
+    }
+    pending.erase(pending.begin() + i);
+  }
+
+  // Copies entre registres
+  while (!pending.empty())
+  {
+    bool progress = false;
+    for (size_t i = 0; i < pending.size(); i++)
+    {
+      PhysReg destination = pending[i].destination.reg;
+      bool isRead = false;
+      for (size_t j = 0; j < pending.size(); j++)
+      {
+        if (j != i && readsRegister(pending[j].source, destination))
+        {
+          isRead = true;
+          break;
+        }
+      }
+      if (!isRead)
+      {
+        mbb.emit(MOpcode::movl, {withWidth(pending[i].source, 32),
+                                 withWidth(pending[i].destination, 32)});
+        pending.erase(pending.begin() + i);
+        progress = true;
+        break;
+      }
+    }
+    if (progress)
+    {
+      continue;
+    }
+
+    // Toutes les copies restantes forment des cycles : en casse un
+    Move cycleMove = pending.front();
+    pending.erase(pending.begin());
+    PhysReg source = cycleMove.source.reg;
+    PhysReg destination = cycleMove.destination.reg;
+    mbb.emit(MOpcode::xchgl, {MOperand::createReg(source), MOperand::createReg(destination)});
+    for (size_t i = 0; i < pending.size();)
+    {
+      if (readsRegister(pending[i].source, destination))
+      {
+        pending[i].source.reg = source;
+      }
+      // La dernière copie d'un cycle est réalisée par l'échange
+      if (readsRegister(pending[i].source, pending[i].destination.reg))
+      {
+        pending.erase(pending.begin() + i);
+      }
+      else
+      {
+        i++;
+      }
+    }
+  }
+}
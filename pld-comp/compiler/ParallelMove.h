@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+
+#include "MachineIR.h"
+
+using namespace std;
+
+// ========== Classe ParallelMove ==========
+// Ensemble de copies à effectuer simultanément : chaque source est lue avant
+// qu'aucune destination ne soit écrite. Utilisé pour placer les paramètres
+// dans le prologue et les arguments avant un appel.
+// Les destinations sont distinctes ; une destination en mémoire n'est la
+// source d'aucune autre copie.
+class ParallelMove
+{
+public:
+  // Ajoute la copie source -> destination (width : 8 ou 32 bits)
+  void add(const MOperand &source, const MOperand &destination, int width = 32);
+
+  // Émet une suite de mov/xchg équivalente ; scratch sert aux copies mémoire -> mémoire
+  void emit(MachineBasicBlock &mbb, PhysReg scratch);
+
+private:
+  struct Move
+  {
+    MOperand source;
+    MOperand destination;
+    int width;
+  };
+
+  vector<Move> moves;
+};
@@ -0,0 +1,137 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "antlr4-runtime.h"
+#include "generated/ifccLexer.h"
+#include "generated/ifccParser.h"
+
+#include "AstBuilder.h"
+#include "ErrorListenerVisitor.h"
+#include "FastTokenSource.h"
+#include "NativeParser.h"
+#include "SourceFile.h"
+#include "TwoStageParse.h"
+
+using namespace std;
+using namespace antlr4;
+
+/**
+ * Exécute runs fois une analyse syntaxique et affiche la meilleure durée, en
+ * fonctions et en mégaoctets par seconde
+ * @param label Le nom de l'analyseur mesuré
+ * @param size La taille du source, en octets
+ * @param runs Le nombre de mesures
+ * @param parse L'analyse mesurée, qui retourne le nombre de fonctions reconnues
+ */
+static void measure(const string &label, size_t size, int runs, const function<size_t()> &parse)
+{
+  double best = 0;
+  size_t functionCount = 0;
+  for (int i = 0; i < runs; i++)
+  {
+    auto start = chrono::steady_clock::now();
+    functionCount = parse();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    best = i == 0 ? seconds : min(best, seconds);
+  }
+  cout << label << ": " << functionCount << " functions in " << best * 1000 << " ms, "
+       << size / best / (1 << 20) << " MiB/s" << endl;
+}
+
+/**
+ * Compare le débit de NativeParser à celui de ifccParser, en LL complet et en
+ * deux temps (SLL, puis LL en cas d'échec), tous alimentés par FastLexer
+ * (l'analyse lexicale est comprise dans la mesure). Chaque mesure va jusqu'à
+ * l'arbre abstrait : NativeParser le construit directement, l'arbre
+ * d'ifccParser passe par AstBuilder. Le cache DFA d'ANTLR est
+ * partagé entre les mesures : la meilleure durée est celle d'un cache chaud.
+ * Les sources sont concaténés et répétés jusqu'à la taille demandée ; ils
+ * doivent être syntaxiquement corrects (les fonctions répétées ne gênent pas :
+ * aucune analyse sémantique n'est faite).
+ * usage: parser-bench [-size MiB] [-runs N] file.c ...
+ */
+int main(int argn, const char **argv)
+{
+  size_t targetSize = 2 << 20;
+  int runs = 3;
+  string corpus;
+  for (int i = 1; i < argn; i++)
+  {
+    string argument = argv[i];
+    if (argument == "-size" && i + 1 < argn)
+    {
+      targetSize = strtoull(argv[++i], nullptr, 10) << 20;
+    }
+    else if (argument == "-runs" && i + 1 < argn)
+    {
+      runs = max(1, atoi(argv[++i]));
+    }
+    else
+    {
+      ifstream file(argument);
+      if (!file)
+      {
+        cerr << "error: cannot read file: " << argument << endl;
+        return 1;
+      }
+      stringstream contents;
+      contents << file.rdbuf();
+      corpus += contents.str() + "\n";
+    }
+  }
+  if (corpus.empty())
+  {
+    cerr << "usage: parser-bench [-size MiB] [-runs N] file.c ..." << endl;
+    return 1;
+  }
+
+  string source;
+  source.reserve(targetSize + corpus.size());
+  while (source.size() < targetSize)
+  {
+    source += corpus;
+  }
+  cout << "input: " << source.size() / double(1 << 20) << " MiB" << endl;
+
+  SyntaxErrorListener errors;
+  measure("NativeParser", source.size(), runs, [&]
+          {
+            Preprocessor preprocessor(source, "bench");
+            unique_ptr<Program> program = NativeParser(preprocessor).parse();
+            return program != nullptr ? program->functions.size() : 0;
+          });
+
+  measure("ifccParser (LL)", source.size(), runs, [&]
+          {
+            SourceCharStream input(source, "bench");
+            ifccLexer vocabularyLexer(&input);
+            FastTokenSource lexer(source, &input, vocabularyLexer.getVocabulary(), &errors);
+            CommonTokenStream tokens(&lexer);
+            tokens.fill();
+            ifccParser parser(&tokens);
+            parser.removeErrorListeners();
+            parser.addErrorListener(&errors);
+            return AstBuilder::build(parser.axiom())->functions.size();
+          });
+
+  size_t fullLLRuns = 0;
+  measure("ifccParser (SLL, then LL)", source.size(), runs, [&]
+          {
+            SourceCharStream input(source, "bench");
+            ifccLexer vocabularyLexer(&input);
+            FastTokenSource lexer(source, &input, vocabularyLexer.getVocabulary(), &errors);
+            CommonTokenStream tokens(&lexer);
+            tokens.fill();
+            ifccParser parser(&tokens);
+            TwoStageParseResult parsed = parseTwoStage(parser, &errors);
+            fullLLRuns += parsed.usedFullLL;
+            return AstBuilder::build(parsed.tree)->functions.size();
+          });
+  cout << "  fell back to full LL in " << fullLLRuns << "/" << runs << " runs" << endl;
+  return 0;
+}
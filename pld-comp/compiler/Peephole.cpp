@@ -0,0 +1,214 @@
+#include "Peephole.h"
+
+// Une règle tente une réécriture à la position index du bloc blockIndex.
+// Elle retourne true si le code a été modifié.
+typedef bool (*PeepholeRule)(MachineFunction &function, size_t blockIndex,
+                             size_t index);
+
+/**
+ * Transfert store -> load : "movl %rX, M" suivi (sans écriture de M ni de %rX
+ * entre les deux) de "movl M, %rY" devient "movl %rX, %rY"
+ */
+static bool forwardStoreToLoad(MachineFunction &function, size_t blockIndex,
+                               size_t index)
+{
+  vector<MachineInstr> &instructions = function.blocks[blockIndex].instructions;
+  const MachineInstr &store = instructions[index];
+  if (store.opcode != MOpcode::movl || !store.operands[0].isReg() ||
+      !store.operands[1].isMem())
+  {
+    return false;
+  }
+  PhysReg source = store.operands[0].reg;
+  const MOperand &slot = store.operands[1];
+
+  for (size_t i = index + 1; i < instructions.size(); i++)
+  {
+    MachineInstr &load = instructions[i];
+    if (load.opcode == MOpcode::movl && load.operands[0] == slot &&
+        load.operands[1].isReg())
+    {
+      load.operands[0] = store.operands[0];
+      return true;
+    }
+    if (isControlFlow(load.opcode) || load.mayWriteRegister(source) ||
+        load.mayWriteMemory(slot))
+    {
+      return false;
+    }
+  }
+  return false;
+}
+
+/**
+ * Suppression des copies inutiles : "movl %rX, %rX", ou "movl %rY, %rX"
+ * juste après "movl %rX, %rY"
+ */
+static bool removeRedundantMove(MachineFunction &function, size_t blockIndex,
+                                size_t index)
+{
+  vector<MachineInstr> &instructions = function.blocks[blockIndex].instructions;
+  const MachineInstr &move = instructions[index];
+  if (move.opcode != MOpcode::movl || !move.operands[0].isReg() ||
+      !move.operands[1].isReg())
+  {
+    return false;
+  }
+  bool redundant = move.operands[0] == move.operands[1];
+  if (!redundant && index > 0)
+  {
+    const MachineInstr &previous = instructions[index - 1];
+    redundant = previous.opcode == MOpcode::movl &&
+                previous.operands[0] == move.operands[1] &&
+                previous.operands[1] == move.operands[0];
+  }
+  if (redundant)
+  {
+    instructions.erase(instructions.begin() + index);
+  }
+  return redundant;
+}
+
+/**
+ * Suppression d'un "jmp .Lx" placé juste avant le label .Lx
+ */
+static bool removeJumpToNext(MachineFunction &function, size_t blockIndex,
+                             size_t index)
+{
+  vector<MachineInstr> &instructions = function.blocks[blockIndex].instructions;
+  if (instructions[index].opcode != MOpcode::jmp ||
+      index + 1 != instructions.size())
+  {
+    return false;
+  }
+  // Le prochain bloc non vide ou étiqueté est celui atteint en séquence
+  for (size_t next = blockIndex + 1; next < function.blocks.size(); next++)
+  {
+    const MachineBasicBlock &block = function.blocks[next];
+    if (!block.label.empty())
+    {
+      if (block.label != instructions[index].operands[0].label)
+      {
+        return false;
+      }
+      instructions.pop_back();
+      return true;
+    }
+    if (!block.instructions.empty())
+    {
+      return false;
+    }
+  }
+  return false;
+}
+
+/**
+ * Indique si les drapeaux peuvent être lus après la position index avant
+ * d'être redéfinis. La recherche suit l'ordre d'émission des blocs.
+ */
+static bool flagsMayBeRead(const MachineFunction &function, size_t blockIndex,
+                           size_t index)
+{
+  for (size_t b = blockIndex; b < function.blocks.size(); b++)
+  {
+    const vector<MachineInstr> &instructions = function.blocks[b].instructions;
+    for (size_t i = (b == blockIndex ? index + 1 : 0); i < instructions.size(); i++)
+    {
+      if (readsFlags(instructions[i].opcode))
+      {
+        return true;
+      }
+      if (writesFlags(instructions[i].opcode) || isControlFlow(instructions[i].opcode))
+      {
+        return false;
+      }
+    }
+  }
+  return false;
+}
+
+/**
+ * Idiome de mise à zéro : "movl $0, %rX" devient "xorl %rX, %rX" lorsque
+ * les drapeaux ne sont pas lus ensuite
+ */
+static bool useZeroIdiom(MachineFunction &function, size_t blockIndex,
+                         size_t index)
+{
+  MachineInstr &move = function.blocks[blockIndex].instructions[index];
+  if (move.opcode != MOpcode::movl || !move.operands[0].isImm() ||
+      move.operands[0].value != 0 || !move.operands[1].isReg() ||
+      flagsMayBeRead(function, blockIndex, index))
+  {
+    return false;
+  }
+  MOperand target = move.operands[1];
+  move = MachineInstr(MOpcode::xorl, {target, target});
+  return true;
+}
+
+// Table des règles, dans l'ordre où elles sont essayées
+static const struct
+{
+  const char *name;
+  PeepholeRule apply;
+} peepholeRules[] = {
+    {"store-to-load-forwarding", forwardStoreToLoad},
+    {"redundant-move", removeRedundantMove},
+    {"jump-to-next", removeJumpToNext},
+    {"zero-idiom", useZeroIdiom},
+};
+
+static const size_t peepholeRuleCount = sizeof(peepholeRules) / sizeof(peepholeRules[0]);
+
+PeepholeStats::PeepholeStats() : hits(peepholeRuleCount, 0) {}
+
+void PeepholeStats::merge(const PeepholeStats &other)
+{
+  for (size_t i = 0; i < hits.size(); i++)
+  {
+    hits[i] += other.hits[i];
+  }
+}
+
+void PeepholeStats::print(ostream &o) const
+{
+  for (size_t i = 0; i < hits.size(); i++)
+  {
+    o << "peephole: " << peepholeRules[i].name << ": " << hits[i] << "\n";
+  }
+}
+
+/**
+ * Applique les règles sur chaque instruction de la fonction.
+ * Après une réécriture, on recule d'une instruction pour que les motifs
+ * nouvellement formés avec la précédente soient aussi examinés.
+ * @param function La fonction machine à optimiser (modifiée en place)
+ */
+void PeepholeOptimizer::run(MachineFunction &function)
+{
+  for (size_t blockIndex = 0; blockIndex < function.blocks.size(); blockIndex++)
+  {
+    vector<MachineInstr> &instructions = function.blocks[blockIndex].instructions;
+    size_t index = 0;
+    while (index < instructions.size())
+    {
+      bool changed = false;
+      for (size_t rule = 0; rule < peepholeRuleCount && !changed; rule++)
+      {
+        if (peepholeRules[rule].apply(function, blockIndex, index))
+        {
+          stats.hits[rule]++;
+          changed = true;
+        }
+      }
+      if (!changed)
+      {
+        index++;
+      }
+      else if (index > 0)
+      {
+        index--;
+      }
+    }
+  }
+}
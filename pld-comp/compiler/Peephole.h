@@ -0,0 +1,33 @@
+#pragma once
+
+#include <ostream>
+#include <vector>
+
+#include "MachineIR.h"
+
+using namespace std;
+
+// ========== Structure PeepholeStats ==========
+// Nombre d'applications de chaque règle, indexé comme la table des règles
+struct PeepholeStats
+{
+  vector<unsigned> hits;
+
+  PeepholeStats();
+  void merge(const PeepholeStats &other); // Ajoute les compteurs d'une autre passe
+  void print(ostream &o) const;            // Affiche "peephole: <règle>: <compte>"
+};
+
+// ========== Classe PeepholeOptimizer ==========
+// Réécrit localement le code machine d'une fonction après l'allocation de
+// registres, à l'aide d'une table de règles appliquées jusqu'à point fixe
+class PeepholeOptimizer
+{
+public:
+  explicit PeepholeOptimizer(PeepholeStats &stats) : stats(stats) {}
+
+  void run(MachineFunction &function);
+
+private:
+  PeepholeStats &stats;
+};
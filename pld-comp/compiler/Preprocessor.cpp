@@ -0,0 +1,1008 @@
+#include "Preprocessor.h"
+
+#include <algorithm>
+
+// Profondeur maximale des #include imbriqués (inclusion récursive)
+static const size_t maxIncludeDepth = 200;
+
+// En-têtes de la bibliothèque standard du C : introuvables, ils sont ignorés
+// (getchar et putchar sont prédéfinies)
+static const unordered_set<string> standardHeaders = {
+    "assert.h", "ctype.h", "errno.h", "float.h", "inttypes.h", "iso646.h", "limits.h",
+    "locale.h", "math.h", "setjmp.h", "signal.h", "stdarg.h", "stdbool.h", "stddef.h",
+    "stdint.h", "stdio.h", "stdlib.h", "string.h", "time.h", "wchar.h", "wctype.h"};
+
+// Identifiant, ou mot-clé : une macro peut porter le nom d'un mot-clé
+static bool isName(TokenKind kind)
+{
+  return kind == TokenKind::Identifier ||
+         (kind >= TokenKind::Int && kind <= TokenKind::ReservedKeyword);
+}
+
+// Répertoire d'un chemin ("" pour un nom sans répertoire)
+static string directoryOf(const string &path)
+{
+  size_t slash = path.find_last_of('/');
+  return slash == string::npos ? "" : slash == 0 ? "/" : path.substr(0, slash);
+}
+
+// ========== Classe SourceMap ==========
+
+uint32_t SourceMap::add(string_view text)
+{
+  size_t base = extent;
+  bases.push_back(base);
+  texts.push_back(text);
+  // Un caractère d'écart : la fin d'un texte n'est pas le début du suivant
+  extent = base + text.size() + 1;
+  return static_cast<uint32_t>(base);
+}
+
+string_view SourceMap::text(size_t offset, size_t length) const
+{
+  size_t segment = bases.size() == 1 ? 0
+                                     : upper_bound(bases.begin(), bases.end(), offset) -
+                                           bases.begin() - 1;
+  string_view text = texts[segment];
+  size_t start = offset - bases[segment];
+  return start <= text.size() ? text.substr(start, length) : string_view();
+}
+
+// ========== Évaluation des conditions de #if ==========
+
+// Précédence des opérateurs binaires dans une condition de #if (celle du C) ;
+// 0 : le token n'en est pas un
+static int conditionPrecedence(TokenKind kind)
+{
+  switch (kind)
+  {
+  case TokenKind::Star:
+  case TokenKind::Slash:
+  case TokenKind::Percent:
+    return 9;
+  case TokenKind::Plus:
+  case TokenKind::Minus:
+    return 8;
+  case TokenKind::Less:
+  case TokenKind::LessEqual:
+  case TokenKind::Greater:
+  case TokenKind::GreaterEqual:
+    return 7;
+  case TokenKind::Equal:
+  case TokenKind::NotEqual:
+    return 6;
+  case TokenKind::BitAnd:
+    return 5;
+  case TokenKind::BitXor:
+    return 4;
+  case TokenKind::BitOr:
+    return 3;
+  case TokenKind::LogicalAnd:
+    return 2;
+  case TokenKind::LogicalOr:
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+// Analyse et évalue une condition de #if déjà développée, sur des entiers de
+// 64 bits. Les opérandes non évalués (après && ou || décidé, branche écartée
+// de ?:) ne produisent pas d'erreur de division par zéro.
+class ConditionEvaluator
+{
+public:
+  ConditionEvaluator(const vector<PreprocessedToken> &tokens, const SourceMap &sourceMap)
+      : tokens(tokens), sourceMap(sourceMap) {}
+
+  // Valeur de la condition ; error n'est pas vide si elle est invalide
+  int64_t evaluate()
+  {
+    int64_t value = conditional(true);
+    if (position < tokens.size())
+    {
+      fail("missing binary operator before token '" + string(spelling(position)) + "'");
+    }
+    return error.empty() ? value : 0;
+  }
+
+  string error;
+
+private:
+  const vector<PreprocessedToken> &tokens;
+  const SourceMap &sourceMap;
+  size_t position = 0;
+
+  string_view spelling(size_t i) const
+  {
+    return sourceMap.text(tokens[i].token.offset, tokens[i].token.length);
+  }
+
+  // '?' et ':' ne sont pas des tokens du langage (Invalid)
+  bool nextIs(string_view text) const
+  {
+    return position < tokens.size() && tokens[position].token.kind == TokenKind::Invalid &&
+           spelling(position) == text;
+  }
+
+  void fail(const string &message)
+  {
+    if (error.empty())
+    {
+      error = message;
+    }
+    position = tokens.size();
+  }
+
+  int64_t conditional(bool live)
+  {
+    int64_t condition = binary(1, live);
+    if (!nextIs("?"))
+    {
+      return condition;
+    }
+    position++;
+    int64_t then = conditional(live && condition != 0);
+    if (!nextIs(":"))
+    {
+      fail("expected ':' in preprocessor expression");
+      return 0;
+    }
+    position++;
+    int64_t otherwise = conditional(live && condition == 0);
+    return condition != 0 ? then : otherwise;
+  }
+
+  int64_t binary(int minPrecedence, bool live)
+  {
+    int64_t left = unary(live);
+    while (position < tokens.size())
+    {
+      TokenKind op = tokens[position].token.kind;
+      int precedence = conditionPrecedence(op);
+      if (precedence == 0 || precedence < minPrecedence)
+      {
+        break;
+      }
+      position++;
+      if (op == TokenKind::LogicalAnd || op == TokenKind::LogicalOr)
+      {
+        bool decided = (op == TokenKind::LogicalAnd) == (left == 0);
+        int64_t right = binary(precedence + 1, live && !decided);
+        left = op == TokenKind::LogicalAnd ? left != 0 && right != 0 : left != 0 || right != 0;
+        continue;
+      }
+      int64_t right = binary(precedence + 1, live);
+      // Arithmétique modulo 2^64, comme celle du code généré
+      uint64_t a = static_cast<uint64_t>(left), b = static_cast<uint64_t>(right);
+      switch (op)
+      {
+      case TokenKind::Star: left = static_cast<int64_t>(a * b); break;
+      case TokenKind::Plus: left = static_cast<int64_t>(a + b); break;
+      case TokenKind::Minus: left = static_cast<int64_t>(a - b); break;
+      case TokenKind::Slash:
+      case TokenKind::Percent:
+        if (right == 0)
+        {
+          if (live)
+          {
+            fail("division by zero in #if");
+          }
+          left = 0;
+        }
+        else if (right == -1)
+        {
+          left = op == TokenKind::Slash ? static_cast<int64_t>(0 - a) : 0;
+        }
+        else
+        {
+          left = op == TokenKind::Slash ? left / right : left % right;
+        }
+        break;
+      case TokenKind::Less: left = left < right; break;
+      case TokenKind::LessEqual: left = left <= right; break;
+      case TokenKind::Greater: left = left > right; break;
+      case TokenKind::GreaterEqual: left = left >= right; break;
+      case TokenKind::Equal: left = left == right; break;
+      case TokenKind::NotEqual: left = left != right; break;
+      case TokenKind::BitAnd: left = left & right; break;
+      case TokenKind::BitXor: left = left ^ right; break;
+      case TokenKind::BitOr: left = left | right; break;
+      default: break;
+      }
+    }
+    return left;
+  }
+
+  int64_t unary(bool live)
+  {
+    if (position >= tokens.size())
+    {
+      fail("missing expression in #if");
+      return 0;
+    }
+    const LexToken &token = tokens[position].token;
+    string_view text = spelling(position++);
+    switch (token.kind)
+    {
+    case TokenKind::Plus:
+      return unary(live);
+    case TokenKind::Minus:
+      return static_cast<int64_t>(0 - static_cast<uint64_t>(unary(live)));
+    case TokenKind::Tilde:
+      return ~unary(live);
+    case TokenKind::Not:
+      return unary(live) == 0;
+    case TokenKind::LeftParen:
+    {
+      int64_t value = conditional(live);
+      if (position >= tokens.size() || tokens[position].token.kind != TokenKind::RightParen)
+      {
+        fail("missing ')' in expression");
+        return 0;
+      }
+      position++;
+      return value;
+    }
+    case TokenKind::IntegerLiteral:
+    {
+      // Résultat de defined : littéral sans texte, de valeur offset
+      if (token.length == 0)
+      {
+        return token.offset;
+      }
+      uint64_t value = 0;
+      for (char digit : text)
+      {
+        value = value * 10 + (digit - '0');
+      }
+      return static_cast<int64_t>(value);
+    }
+    case TokenKind::CharLiteral:
+      return static_cast<int>(text[1]); // Comme AstBuilder
+    default:
+      if (isName(token.kind))
+      {
+        return 0; // Identifiant qui n'est pas une macro
+      }
+      fail("token '" + string(text) + "' is not valid in preprocessor expressions");
+      return 0;
+    }
+  }
+};
+
+// ========== Classe Preprocessor ==========
+
+/**
+ * Découpe le fichier principal ; il est ensuite lu au fur et à mesure des
+ * appels à next.
+ * @param source Le texte du programme
+ * @param sourceName Son chemin : ses #include "..." sont cherchés dans son répertoire
+ * @param includePaths Les répertoires de -I, dans l'ordre
+ * @param cache Les fichiers inclus déjà lus (nullptr : cache propre)
+ * @param workingDirectory Le répertoire par rapport auquel les chemins
+ *                         relatifs sont ouverts (serveur de compilation) ;
+ *                         les diagnostics gardent les chemins relatifs
+ */
+Preprocessor::Preprocessor(string_view source, const string &sourceName,
+                           const vector<string> &includePaths, IncludeCache *cache,
+                           const string &workingDirectory)
+    : source(source), sourceTokens(FastLexer(source, true).tokenize()),
+      includePaths(includePaths), workingDirectory(workingDirectory), cache(cache)
+{
+  if (cache == nullptr)
+  {
+    ownCache = make_unique<IncludeCache>();
+    this->cache = ownCache.get();
+  }
+  sourceMap.add(source);
+  Frame main;
+  main.fileTokens = &sourceTokens;
+  main.text = source;
+  main.path = sourceName;
+  main.directory = directoryOf(sourceName);
+  frames.push_back(move(main));
+}
+
+/**
+ * Place un token d'un fichier dans la SourceMap. Un token d'un fichier
+ * inclus est signalé au #include du fichier principal ; pour le fichier
+ * principal, le début de la ligne courante est conservé, les tokens étant
+ * lus dans l'ordre.
+ */
+PreprocessedToken Preprocessor::locate(const Frame &frame, const LexToken &token)
+{
+  PreprocessedToken located{token, 0};
+  located.token.offset += frame.base;
+  if (frame.includeLine != 0)
+  {
+    located.token.line = frame.includeLine;
+    located.column = frame.includeColumn;
+    return located;
+  }
+  if (token.line != currentLine)
+  {
+    currentLine = token.line;
+    currentLineStart = token.offset - FastLexer::columnOf(frame.text, token.offset);
+  }
+  located.column = token.offset - currentLineStart;
+  return located;
+}
+
+// Signale une erreur ou un avertissement, suivi de la position dans le
+// fichier inclus de la directive en cours
+void Preprocessor::report(ErrorType severity, const PreprocessedToken &location,
+                          const string &message)
+{
+  errors += severity == ErrorType::Error;
+  DiagnosticEngine::current().report(severity, location.token.line, location.column + 1,
+                                     message + directiveOrigin);
+}
+
+void Preprocessor::popFrame()
+{
+  if (frames.back().macro != nullptr)
+  {
+    frames.back().macro->active = false;
+  }
+  frames.pop_back();
+}
+
+/**
+ * Lit le token suivant des frames au-dessus de floor, sans développer les
+ * macros : les directives des fichiers sont exécutées au passage, et les
+ * portions exclues par la compilation conditionnelle sautées.
+ * @param token Reçoit le token
+ * @param floor Nombre de frames du bas de la pile à ne pas lire
+ * @param withinFile true pour s'arrêter à la fin du fichier courant au lieu
+ *                   de revenir au fichier qui l'inclut
+ * @return false quand il n'y a plus de token à lire
+ */
+bool Preprocessor::readToken(PreprocessedToken &token, size_t floor, bool withinFile)
+{
+  while (frames.size() > floor)
+  {
+    Frame &frame = frames.back();
+    if (!frame.isFile())
+    {
+      if (frame.position < frame.expansion.size())
+      {
+        token = frame.expansion[frame.position++];
+        return true;
+      }
+      popFrame();
+      continue;
+    }
+
+    const vector<LexToken> &tokens = *frame.fileTokens;
+    if (!conditionals.empty() && !conditionals.back().active)
+    {
+      // Portion exclue : seules ses directives sont lues
+      while (tokens[frame.position].kind != TokenKind::Hash &&
+             tokens[frame.position].kind != TokenKind::EndOfInput)
+      {
+        frame.position++;
+      }
+    }
+    const LexToken &lexed = tokens[frame.position];
+    if (lexed.kind == TokenKind::EndOfInput)
+    {
+      if (withinFile)
+      {
+        return false;
+      }
+      endOfFile(locate(frame, lexed));
+      continue;
+    }
+    frame.position++;
+    if (lexed.kind != TokenKind::Hash)
+    {
+      token = locate(frame, lexed);
+      return true;
+    }
+
+    // Directive : ses tokens vont jusqu'à la fin de sa ligne
+    PreprocessedToken hash = locate(frame, lexed);
+    vector<PreprocessedToken> directive;
+    while (tokens[frame.position].kind != TokenKind::EndOfDirective)
+    {
+      directive.push_back(locate(frame, tokens[frame.position++]));
+    }
+    size_t endOffset = frame.base + tokens[frame.position++].offset;
+    if (frame.includeLine == 0)
+    {
+      rewrittenSpans.push_back({hash.token.offset, endOffset});
+    }
+    else
+    {
+      directiveOrigin = " (" + frame.path + ":" + to_string(lexed.line) + ")";
+    }
+    runDirective(frames.size() - 1, hash, directive, endOffset);
+    directiveOrigin.clear();
+  }
+  return false;
+}
+
+// Macro désignée par un token, si elle peut être développée
+shared_ptr<Preprocessor::Macro> Preprocessor::findMacro(const PreprocessedToken &token) const
+{
+  if (macros.empty() || !isName(token.token.kind))
+  {
+    return nullptr;
+  }
+  auto macro = macros.find(spelling(token));
+  return macro != macros.end() && !macro->second->active ? macro->second : nullptr;
+}
+
+/**
+ * Lit le token suivant en développant les macros : le développement d'une
+ * macro est relu à son tour, la macro étant désactivée jusqu'à sa fin.
+ * @param token Reçoit le token
+ * @param floor Nombre de frames du bas de la pile à ne pas lire
+ * @return false quand il n'y a plus de token à lire
+ */
+bool Preprocessor::expandToken(PreprocessedToken &token, size_t floor)
+{
+  while (readToken(token, floor))
+  {
+    shared_ptr<Macro> macro = findMacro(token);
+    if (macro == nullptr)
+    {
+      return true;
+    }
+    vector<vector<PreprocessedToken>> arguments;
+    size_t end = token.token.offset + token.token.length;
+    if (macro->functionLike)
+    {
+      // Sans parenthèse, le nom d'une macro avec paramètres reste un identifiant
+      if (!nextIsLeftParen(floor))
+      {
+        return true;
+      }
+      PreprocessedToken closing;
+      if (!readArguments(*macro, token, floor, arguments, closing))
+      {
+        continue;
+      }
+      end = max<size_t>(end, closing.token.offset + closing.token.length);
+    }
+    if (token.token.offset < source.size())
+    {
+      rewrittenSpans.push_back({token.token.offset, end});
+    }
+    pushExpansion(macro, token, arguments);
+  }
+  return false;
+}
+
+/**
+ * Développe entièrement une suite de tokens, isolée du reste du texte (les
+ * arguments d'une macro, la condition d'un #if)
+ */
+vector<PreprocessedToken> Preprocessor::expandTokens(vector<PreprocessedToken> tokens)
+{
+  size_t floor = frames.size();
+  Frame list;
+  list.expansion = move(tokens);
+  frames.push_back(move(list));
+  vector<PreprocessedToken> expanded;
+  PreprocessedToken token;
+  while (expandToken(token, floor))
+  {
+    expanded.push_back(token);
+  }
+  return expanded;
+}
+
+/**
+ * true si le prochain token est '(' ; les développements de macros épuisés
+ * sont retirés pour regarder au-delà, mais pas la fin d'un fichier ni une
+ * directive
+ */
+bool Preprocessor::nextIsLeftParen(size_t floor)
+{
+  while (frames.size() > floor)
+  {
+    Frame &frame = frames.back();
+    if (frame.isFile())
+    {
+      return (*frame.fileTokens)[frame.position].kind == TokenKind::LeftParen;
+    }
+    if (frame.position < frame.expansion.size())
+    {
+      return frame.expansion[frame.position].token.kind == TokenKind::LeftParen;
+    }
+    popFrame();
+  }
+  return false;
+}
+
+/**
+ * Lit les arguments d'un appel de macro, de '(' à la ')' correspondante ;
+ * les virgules entre parenthèses imbriquées ne séparent pas les arguments
+ * @param macro La macro appelée
+ * @param name Son nom dans l'appel
+ * @param floor Nombre de frames du bas de la pile à ne pas lire
+ * @param arguments Reçoit les tokens de chaque argument, non développés
+ * @param closing Reçoit la ')' finale
+ * @return false en cas d'erreur (déjà signalée)
+ */
+bool Preprocessor::readArguments(const Macro &macro, const PreprocessedToken &name, size_t floor,
+                                 vector<vector<PreprocessedToken>> &arguments,
+                                 PreprocessedToken &closing)
+{
+  PreprocessedToken token;
+  readToken(token, floor, true); // '('
+  arguments.assign(1, {});
+  size_t depth = 0;
+  while (true)
+  {
+    if (!readToken(token, floor, true))
+    {
+      report(ErrorType::Error, name,
+             "unterminated argument list invoking macro '" + string(spelling(name)) + "'");
+      return false;
+    }
+    TokenKind kind = token.token.kind;
+    if (kind == TokenKind::RightParen && depth == 0)
+    {
+      break;
+    }
+    if (kind == TokenKind::Comma && depth == 0)
+    {
+      arguments.emplace_back();
+      continue;
+    }
+    depth += kind == TokenKind::LeftParen;
+    depth -= kind == TokenKind::RightParen;
+    arguments.back().push_back(token);
+  }
+  closing = token;
+
+  // f() n'a aucun argument si f n'a aucun paramètre, sinon un argument vide
+  if (macro.parameters.empty() && arguments.size() == 1 && arguments[0].empty())
+  {
+    arguments.clear();
+  }
+  if (arguments.size() != macro.parameters.size())
+  {
+    report(ErrorType::Error, name,
+           "macro '" + string(spelling(name)) + "' requires " +
+               to_string(macro.parameters.size()) + " argument(s), but " +
+               to_string(arguments.size()) + " given");
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Remplace un appel de macro par son corps, à relire : chaque paramètre
+ * devient son argument développé (une seule fois, même s'il est utilisé
+ * plusieurs fois). Les tokens du corps sont signalés à l'appel.
+ */
+void Preprocessor::pushExpansion(const shared_ptr<Macro> &macro, const PreprocessedToken &name,
+                                 vector<vector<PreprocessedToken>> &arguments)
+{
+  Frame frame;
+  vector<bool> expanded(arguments.size(), false);
+  for (size_t i = 0; i < macro->body.size(); i++)
+  {
+    int parameter = macro->parameterOf[i];
+    if (parameter < 0)
+    {
+      PreprocessedToken token = macro->body[i];
+      token.token.line = name.token.line;
+      token.column = name.column;
+      frame.expansion.push_back(token);
+      continue;
+    }
+    if (!expanded[parameter])
+    {
+      arguments[parameter] = expandTokens(move(arguments[parameter]));
+      expanded[parameter] = true;
+    }
+    frame.expansion.insert(frame.expansion.end(), arguments[parameter].begin(),
+                           arguments[parameter].end());
+  }
+  // Désactivée seulement maintenant : ses arguments peuvent l'appeler
+  macro->active = true;
+  frame.macro = macro;
+  frames.push_back(move(frame));
+}
+
+// Fin d'un fichier : ses #if doivent y être fermés
+void Preprocessor::endOfFile(const PreprocessedToken &end)
+{
+  while (conditionals.size() > frames.back().conditionalDepth)
+  {
+    report(ErrorType::Error, conditionals.back().location, "unterminated conditional directive");
+    conditionals.pop_back();
+  }
+  if (frames.size() == 1)
+  {
+    endOfInput = end;
+  }
+  frames.pop_back();
+}
+
+/**
+ * Exécute une directive. Dans une portion exclue, seules les directives
+ * conditionnelles sont prises en compte, pour retrouver la fin de la portion.
+ * @param frameIndex Le fichier de la directive dans la pile
+ * @param hash Le '#' qui la commence
+ * @param tokens Ses tokens, nom de la directive compris
+ * @param endOffset Position de sa fin de ligne dans la SourceMap
+ */
+void Preprocessor::runDirective(size_t frameIndex, const PreprocessedToken &hash,
+                                const vector<PreprocessedToken> &tokens, size_t endOffset)
+{
+  string name = tokens.empty() ? "" : string(spelling(tokens[0]));
+  bool skipping = !conditionals.empty() && !conditionals.back().active;
+
+  if (name == "if" || name == "ifdef" || name == "ifndef")
+  {
+    bool value = false;
+    if (!skipping && name == "if")
+    {
+      value = evaluateCondition(hash, tokens);
+    }
+    else if (!skipping && (tokens.size() < 2 || !isName(tokens[1].token.kind)))
+    {
+      report(ErrorType::Error, hash, "no macro name given in #" + name + " directive");
+    }
+    else if (!skipping)
+    {
+      value = (macros.count(spelling(tokens[1])) != 0) == (name == "ifdef");
+    }
+    // Dans une portion exclue, aucune branche n'est compilée
+    conditionals.push_back({value, value || skipping, false, hash});
+    return;
+  }
+
+  if (name == "elif" || name == "else" || name == "endif")
+  {
+    if (conditionals.size() <= frames[frameIndex].conditionalDepth)
+    {
+      report(ErrorType::Error, hash, "#" + name + " without #if");
+      return;
+    }
+    if (name == "endif")
+    {
+      conditionals.pop_back();
+      return;
+    }
+    if (conditionals.back().seenElse)
+    {
+      report(ErrorType::Error, hash, "#" + name + " after #else");
+      return;
+    }
+    bool taken = conditionals.back().taken;
+    bool value = !taken && (name == "else" || evaluateCondition(hash, tokens));
+    Conditional &conditional = conditionals.back();
+    conditional.seenElse = name == "else";
+    conditional.active = value;
+    conditional.taken = taken || value;
+    return;
+  }
+
+  if (skipping || tokens.empty())
+  {
+    return; // Directive exclue, ou directive nulle ("#" seul)
+  }
+  if (name == "define")
+  {
+    defineMacro(hash, tokens);
+  }
+  else if (name == "undef")
+  {
+    if (tokens.size() < 2 || !isName(tokens[1].token.kind))
+    {
+      report(ErrorType::Error, hash, "macro names must be identifiers");
+      return;
+    }
+    macros.erase(spelling(tokens[1]));
+  }
+  else if (name == "include")
+  {
+    include(frameIndex, hash, tokens, endOffset);
+  }
+  else if (name == "pragma")
+  {
+    // Les autres pragmas sont ignorés, comme le ferait gcc
+    if (tokens.size() > 1 && spelling(tokens[1]) == "once")
+    {
+      onceFiles.insert(frames[frameIndex].path);
+    }
+  }
+  else if (name == "error" || name == "warning")
+  {
+    size_t start = tokens[0].token.offset + tokens[0].token.length;
+    string_view text = sourceMap.text(start, endOffset - start);
+    size_t first = text.find_first_not_of(" \t");
+    size_t last = text.find_last_not_of(" \t\r");
+    string message = first == string_view::npos ? "" : string(text.substr(first, last - first + 1));
+    report(name == "error" ? ErrorType::Error : ErrorType::Warning, hash,
+           "#" + name + (message.empty() ? "" : " " + message));
+  }
+  else
+  {
+    report(ErrorType::Error, hash, "invalid preprocessing directive #" + name);
+  }
+}
+
+/**
+ * #define : macro sans paramètres, ou avec si '(' suit immédiatement le nom
+ * @param hash Le '#' de la directive
+ * @param tokens Les tokens de la directive ("define", le nom, puis la suite)
+ */
+void Preprocessor::defineMacro(const PreprocessedToken &hash,
+                               const vector<PreprocessedToken> &tokens)
+{
+  if (tokens.size() < 2 || !isName(tokens[1].token.kind))
+  {
+    report(ErrorType::Error, hash, "macro names must be identifiers");
+    return;
+  }
+  const PreprocessedToken &name = tokens[1];
+  auto macro = make_shared<Macro>();
+  size_t i = 2;
+  if (i < tokens.size() && tokens[i].token.kind == TokenKind::LeftParen &&
+      tokens[i].token.offset == name.token.offset + name.token.length)
+  {
+    macro->functionLike = true;
+    i++;
+    bool closed = i < tokens.size() && tokens[i].token.kind == TokenKind::RightParen;
+    while (!closed && i < tokens.size() && tokens[i].token.kind == TokenKind::Identifier)
+    {
+      string_view parameter = spelling(tokens[i++]);
+      if (find(macro->parameters.begin(), macro->parameters.end(), parameter) !=
+          macro->parameters.end())
+      {
+        report(ErrorType::Error, hash, "duplicate macro parameter '" + string(parameter) + "'");
+        return;
+      }
+      macro->parameters.push_back(parameter);
+      if (i < tokens.size() && tokens[i].token.kind == TokenKind::RightParen)
+      {
+        closed = true;
+      }
+      else if (i >= tokens.size() || tokens[i++].token.kind != TokenKind::Comma)
+      {
+        break;
+      }
+    }
+    if (!closed)
+    {
+      report(ErrorType::Error, hash, "expected parameter name or ')' in macro parameter list");
+      return;
+    }
+    i++;
+  }
+
+  for (; i < tokens.size(); i++)
+  {
+    if (tokens[i].token.kind == TokenKind::Hash)
+    {
+      report(ErrorType::Error, tokens[i], "'#' and '##' operators are not supported");
+      return;
+    }
+    auto parameter = find(macro->parameters.begin(), macro->parameters.end(), spelling(tokens[i]));
+    macro->body.push_back(tokens[i]);
+    macro->parameterOf.push_back(tokens[i].token.kind == TokenKind::Identifier &&
+                                         parameter != macro->parameters.end()
+                                     ? static_cast<int>(parameter - macro->parameters.begin())
+                                     : -1);
+  }
+
+  // Une redéfinition identique est permise
+  auto previous = macros.find(spelling(name));
+  if (previous != macros.end())
+  {
+    const Macro &old = *previous->second;
+    bool same = old.functionLike == macro->functionLike && old.parameters == macro->parameters &&
+                old.body.size() == macro->body.size();
+    for (size_t j = 0; same && j < old.body.size(); j++)
+    {
+      same = spelling(old.body[j]) == spelling(macro->body[j]);
+    }
+    if (!same)
+    {
+      report(ErrorType::Warning, hash, "'" + string(spelling(name)) + "' macro redefined");
+    }
+    previous->second = macro;
+    return;
+  }
+  macros.emplace(spelling(name), macro);
+}
+
+/**
+ * Évalue la condition d'un #if ou d'un #elif : defined est appliqué avant le
+ * développement des macros, puis les identifiants restants valent 0
+ * @return La valeur de la condition (false si elle est invalide, erreur signalée)
+ */
+bool Preprocessor::evaluateCondition(const PreprocessedToken &hash,
+                                     const vector<PreprocessedToken> &tokens)
+{
+  vector<PreprocessedToken> condition;
+  for (size_t i = 1; i < tokens.size(); i++)
+  {
+    if (spelling(tokens[i]) != "defined")
+    {
+      condition.push_back(tokens[i]);
+      continue;
+    }
+    bool parenthesized = i + 1 < tokens.size() && tokens[i + 1].token.kind == TokenKind::LeftParen;
+    size_t name = i + 1 + parenthesized;
+    if (name >= tokens.size() || !isName(tokens[name].token.kind))
+    {
+      report(ErrorType::Error, hash, "operator 'defined' requires an identifier");
+      return false;
+    }
+    if (parenthesized &&
+        (name + 1 >= tokens.size() || tokens[name + 1].token.kind != TokenKind::RightParen))
+    {
+      report(ErrorType::Error, hash, "missing ')' after 'defined'");
+      return false;
+    }
+    // Littéral sans texte, dont la valeur est portée par offset
+    PreprocessedToken value = tokens[i];
+    value.token.kind = TokenKind::IntegerLiteral;
+    value.token.offset = macros.count(spelling(tokens[name])) != 0;
+    value.token.length = 0;
+    condition.push_back(value);
+    i = name + parenthesized;
+  }
+
+  condition = expandTokens(move(condition));
+  ConditionEvaluator evaluator(condition, sourceMap);
+  int64_t value = evaluator.evaluate();
+  if (!evaluator.error.empty())
+  {
+    report(ErrorType::Error, hash, evaluator.error);
+    return false;
+  }
+  return value != 0;
+}
+
+/**
+ * #include "fichier" ou <fichier>. Le nom n'étant pas fait de tokens du
+ * langage, il est lu dans le texte de la directive. Un fichier dont la garde
+ * est définie, ou marqué #pragma once, n'est pas relu.
+ */
+void Preprocessor::include(size_t frameIndex, const PreprocessedToken &hash,
+                           const vector<PreprocessedToken> &tokens, size_t endOffset)
+{
+  size_t start = tokens[0].token.offset + tokens[0].token.length;
+  string_view text = sourceMap.text(start, endOffset - start);
+  text.remove_prefix(min(text.size(), text.find_first_not_of(" \t")));
+  char close = text.empty() ? '\0' : text[0] == '"' ? '"' : text[0] == '<' ? '>' : '\0';
+  size_t end = close != '\0' ? text.find(close, 1) : string_view::npos;
+  if (end == string_view::npos || end == 1)
+  {
+    report(ErrorType::Error, hash, "#include expects \"FILENAME\" or <FILENAME>");
+    return;
+  }
+  if (frames.size() > maxIncludeDepth)
+  {
+    report(ErrorType::Error, hash, "#include nested too deeply");
+    return;
+  }
+
+  string name(text.substr(1, end - 1));
+  bool angled = close == '>';
+  const Segment *segment = findInclude(frames[frameIndex].directory, name, angled);
+  if (segment == nullptr)
+  {
+    // Seuls les en-têtes standard introuvables sont ignorés
+    if (!angled || standardHeaders.count(name) == 0)
+    {
+      report(ErrorType::Error, hash, "'" + name + "' file not found");
+    }
+    return;
+  }
+  const IncludedFile &file = *segment->file;
+  if ((!file.guard.empty() && macros.count(file.guard) != 0) || onceFiles.count(file.path) != 0)
+  {
+    return;
+  }
+
+  Frame frame;
+  frame.fileTokens = &file.tokens;
+  frame.text = file.contents;
+  frame.base = segment->base;
+  frame.path = segment->path;
+  frame.directory = directoryOf(segment->path);
+  frame.conditionalDepth = conditionals.size();
+  // Le '#' est déjà placé au #include du fichier principal
+  frame.includeLine = hash.token.line;
+  frame.includeColumn = hash.column;
+  frames.push_back(move(frame));
+}
+
+/**
+ * Cherche le fichier d'un #include : "..." dans le répertoire du fichier qui
+ * l'inclut puis dans ceux de -I, <...> seulement dans ceux de -I. Le chemin
+ * trouvé est retenu pour ne plus le chercher ; chaque fichier essayé, trouvé
+ * ou non, est noté parmi les dépendances de la compilation.
+ * @return Le fichier et sa place dans la SourceMap, ou nullptr
+ */
+const Preprocessor::Segment *Preprocessor::findInclude(const string &directory,
+                                                       const string &name, bool angled)
+{
+  string key = (angled ? "<" : "\"" + directory + "\"") + name;
+  auto resolved = resolvedIncludes.find(key);
+  if (resolved != resolvedIncludes.end())
+  {
+    return resolved->second.empty() ? nullptr : &segments[resolved->second];
+  }
+
+  vector<string> candidates;
+  if (!name.empty() && name[0] == '/')
+  {
+    candidates.push_back(name);
+  }
+  else
+  {
+    if (!angled)
+    {
+      candidates.push_back(directory.empty() ? name : directory + "/" + name);
+    }
+    for (const string &path : includePaths)
+    {
+      candidates.push_back(path + "/" + name);
+    }
+  }
+
+  for (const string &candidate : candidates)
+  {
+    auto known = segments.find(candidate);
+    if (known == segments.end())
+    {
+      bool relative = !workingDirectory.empty() && candidate[0] != '/';
+      string path = relative ? workingDirectory + "/" + candidate : candidate;
+      shared_ptr<const IncludedFile> file = cache->load(path);
+      probedFiles[path] = file != nullptr ? file->digest : "";
+      if (file == nullptr)
+      {
+        continue;
+      }
+      known = segments.emplace(candidate, Segment{file, sourceMap.add(file->contents), candidate})
+                  .first;
+    }
+    resolvedIncludes[key] = candidate;
+    return &known->second;
+  }
+  resolvedIncludes[key] = "";
+  return nullptr;
+}
+
+PreprocessedToken Preprocessor::next()
+{
+  PreprocessedToken token;
+  return expandToken(token, 0) ? token : endOfInput;
+}
+
+/**
+ * @param start Début de l'intervalle dans la SourceMap
+ * @param end Fin de l'intervalle (exclue)
+ */
+bool Preprocessor::isVerbatim(size_t start, size_t end) const
+{
+  if (start > end || end > source.size())
+  {
+    return false;
+  }
+  if (rewrittenEnds.size() != rewrittenSpans.size())
+  {
+    sort(rewrittenSpans.begin(), rewrittenSpans.end());
+    rewrittenEnds.clear();
+    for (const auto &span : rewrittenSpans)
+    {
+      rewrittenEnds.push_back(max(span.second, rewrittenEnds.empty() ? 0 : rewrittenEnds.back()));
+    }
+  }
+  // Portions qui commencent avant end : aucune ne doit finir après start
+  size_t before = lower_bound(rewrittenSpans.begin(), rewrittenSpans.end(), make_pair(end, size_t(0))) -
+                  rewrittenSpans.begin();
+  return before == 0 || rewrittenEnds[before - 1] <= start;
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Diagnostics.h"
+#include "FastLexer.h"
+#include "IncludeCache.h"
+
+using namespace std;
+
+// ========== Classe SourceMap ==========
+// Textes de tous les fichiers lus par une compilation, mis bout à bout dans
+// un espace de positions virtuel : le fichier principal commence à 0, chaque
+// fichier inclus à la suite du précédent. Les tokens prétraités désignent
+// leur texte par une position dans cet espace.
+class SourceMap
+{
+public:
+  // Ajoute un texte, qui doit rester valide, et retourne sa position virtuelle
+  uint32_t add(string_view text);
+
+  // Texte de length caractères à partir de la position virtuelle offset
+  string_view text(size_t offset, size_t length) const;
+
+  // Fin de l'espace virtuel
+  inline size_t size() const { return extent; }
+
+private:
+  vector<size_t> bases;
+  vector<string_view> texts;
+  size_t extent = 0;
+};
+
+// ========== Structure PreprocessedToken ==========
+// Token produit par le préprocesseur : token.offset est sa position dans la
+// SourceMap ; token.line et column donnent où le signaler dans le fichier
+// principal (l'appel de la macro, ou le #include, s'il n'y est pas écrit)
+struct PreprocessedToken
+{
+  LexToken token;
+  uint32_t column; // À partir de 0
+};
+
+// ========== Classe Preprocessor ==========
+// Préprocesseur intégré, entre FastLexer et le parser : exécute les
+// directives (#define, #undef, #if, #ifdef, #ifndef, #elif, #else, #endif,
+// #include, #pragma once, #error, #warning) et développe les macros, avec
+// ou sans paramètres, en produisant les tokens un par un. Les fichiers
+// inclus sont découpés une seule fois (IncludeCache) et ceux protégés par une
+// garde déjà définie ne sont même pas relus.
+class Preprocessor
+{
+public:
+  // Le source doit rester valide tant que les tokens sont utilisés ;
+  // cache : fichiers inclus partagés (nullptr : cache propre à l'instance) ;
+  // workingDirectory : où sont lus les chemins relatifs ("" : répertoire courant)
+  Preprocessor(string_view source, const string &sourceName,
+               const vector<string> &includePaths = {}, IncludeCache *cache = nullptr,
+               const string &workingDirectory = "");
+
+  // Token suivant ; EndOfInput à la fin, indéfiniment
+  PreprocessedToken next();
+
+  inline const SourceMap &getSourceMap() const { return sourceMap; }
+
+  // Nombre d'erreurs signalées jusqu'ici (directives et macros)
+  inline size_t getNumberOfErrors() const { return errors; }
+
+  // true si les tokens de [start, end[ sont le texte même du fichier
+  // principal : ni directive ni appel de macro dans l'intervalle
+  bool isVerbatim(size_t start, size_t end) const;
+
+  // Chaque fichier cherché pour un #include, tel qu'il a été ouvert, et
+  // l'empreinte de son contenu ("" : absent)
+  inline const map<string, string> &getProbedFiles() const { return probedFiles; }
+
+private:
+  struct Macro
+  {
+    bool functionLike = false;
+    vector<string_view> parameters;
+    vector<PreprocessedToken> body;
+    vector<int> parameterOf; // Pour chaque token du corps : indice du paramètre, ou -1
+    bool active = false;     // En cours de développement (pas de récursion)
+  };
+
+  // Fichier en cours de lecture, ou tokens produits par une macro
+  struct Frame
+  {
+    // Fichier : ses tokens, positions relatives à base dans la SourceMap
+    const vector<LexToken> *fileTokens = nullptr;
+    string_view text;
+    uint32_t base = 0;
+    string path;
+    string directory; // Où chercher ses #include "..."
+    size_t conditionalDepth = 0;
+    // Position du #include dans le fichier principal (0 : fichier principal)
+    uint32_t includeLine = 0;
+    uint32_t includeColumn = 0;
+    // Macro : tokens de son développement, à relire
+    vector<PreprocessedToken> expansion;
+    shared_ptr<Macro> macro; // Réactivée quand la frame est retirée
+    size_t position = 0;
+
+    inline bool isFile() const { return fileTokens != nullptr; }
+  };
+
+  struct Conditional
+  {
+    bool active;   // La branche courante est compilée
+    bool taken;    // Une branche a été ou est compilée : les suivantes sont exclues
+    bool seenElse;
+    PreprocessedToken location; // Position du #if
+  };
+
+  // Fichier inclus, avec sa position dans la SourceMap
+  struct Segment
+  {
+    shared_ptr<const IncludedFile> file;
+    uint32_t base;
+    string path; // Chemin tel qu'il a été cherché, pour les diagnostics
+  };
+
+  SourceMap sourceMap;
+  string_view source;
+  vector<LexToken> sourceTokens;
+  vector<string> includePaths;
+  string workingDirectory;
+  IncludeCache *cache;
+  unique_ptr<IncludeCache> ownCache;
+
+  vector<Frame> frames;
+  vector<Conditional> conditionals;
+  unordered_map<string_view, shared_ptr<Macro>> macros;
+  unordered_map<string, Segment> segments;       // Fichiers inclus, par chemin
+  unordered_map<string, string> resolvedIncludes; // Chemin de chaque #include déjà vu
+  unordered_set<string> onceFiles;                // Fichiers marqués #pragma once
+  map<string, string> probedFiles;                // Fichiers essayés, et leur empreinte
+  PreprocessedToken endOfInput{};
+  size_t errors = 0;
+  string directiveOrigin; // " (fichier:ligne)" de la directive en cours d'un fichier inclus
+
+  // Portions du fichier principal qui ne sont pas son texte même
+  // (directives, appels de macro), triées à la demande par isVerbatim
+  mutable vector<pair<size_t, size_t>> rewrittenSpans;
+  mutable vector<size_t> rewrittenEnds; // Fin maximale des portions 0..i
+  uint32_t currentLine = 0;      // Ligne du dernier token du fichier principal
+  uint32_t currentLineStart = 0; // Position du début de cette ligne
+
+  inline string_view spelling(const PreprocessedToken &token) const
+  {
+    return sourceMap.text(token.token.offset, token.token.length);
+  }
+  PreprocessedToken locate(const Frame &frame, const LexToken &token);
+  void report(ErrorType severity, const PreprocessedToken &location, const string &message);
+
+  bool readToken(PreprocessedToken &token, size_t floor, bool withinFile = false);
+  bool expandToken(PreprocessedToken &token, size_t floor);
+  vector<PreprocessedToken> expandTokens(vector<PreprocessedToken> tokens);
+  shared_ptr<Macro> findMacro(const PreprocessedToken &token) const;
+  bool nextIsLeftParen(size_t floor);
+  bool readArguments(const Macro &macro, const PreprocessedToken &name, size_t floor,
+                     vector<vector<PreprocessedToken>> &arguments, PreprocessedToken &closing);
+  void pushExpansion(const shared_ptr<Macro> &macro, const PreprocessedToken &name,
+                     vector<vector<PreprocessedToken>> &arguments);
+  void popFrame();
+
+  void runDirective(size_t frameIndex, const PreprocessedToken &hash,
+                    const vector<PreprocessedToken> &tokens, size_t endOffset);
+  void defineMacro(const PreprocessedToken &hash, const vector<PreprocessedToken> &tokens);
+  bool evaluateCondition(const PreprocessedToken &hash, const vector<PreprocessedToken> &tokens);
+  void include(size_t frameIndex, const PreprocessedToken &hash,
+               const vector<PreprocessedToken> &tokens, size_t endOffset);
+  const Segment *findInclude(const string &directory, const string &name, bool angled);
+  void endOfFile(const PreprocessedToken &end);
+};
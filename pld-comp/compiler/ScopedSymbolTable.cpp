@@ -0,0 +1,55 @@
+#include "ScopedSymbolTable.h"
+
+/**
+ * Ferme la portée courante : les liaisons qu'elle a créées sont retirées du
+ * sommet de leur pile, ce qui rend de nouveau visibles celles qu'elles
+ * masquaient.
+ * @return Les symboles déclarés dans la portée, dans l'ordre de déclaration
+ */
+vector<shared_ptr<Symbol>> ScopedSymbolTable::popScope()
+{
+  vector<shared_ptr<Symbol>> symbols;
+  size_t start = scopeStarts.back();
+  symbols.reserve(undoLog.size() - start);
+  for (size_t i = start; i < undoLog.size(); i++)
+  {
+    // La pile reste dans la table une fois vide : l'identifiant sera
+    // vraisemblablement lié de nouveau par une portée voisine
+    vector<Binding> &stack = bindings.find(undoLog[i])->second;
+    symbols.push_back(move(stack.back().symbol));
+    stack.pop_back();
+  }
+  undoLog.resize(start);
+  scopeStarts.pop_back();
+  return symbols;
+}
+
+/**
+ * Lie un identifiant dans la portée courante, en masquant ses liaisons des
+ * portées englobantes.
+ * @param id L'identifiant interné de la variable
+ * @param symbol Le symbole à lier
+ * @return false si id est déjà lié dans la portée courante
+ */
+bool ScopedSymbolTable::declare(Identifier id, shared_ptr<Symbol> symbol)
+{
+  size_t scope = scopeStarts.size();
+  vector<Binding> &stack = bindings[id];
+  if (!stack.empty() && stack.back().scope == scope)
+  {
+    return false;
+  }
+  stack.push_back({move(symbol), scope});
+  undoLog.push_back(id);
+  return true;
+}
+
+shared_ptr<Symbol> ScopedSymbolTable::lookup(Identifier id) const
+{
+  auto it = bindings.find(id);
+  if (it == bindings.end() || it->second.empty())
+  {
+    return nullptr;
+  }
+  return it->second.back().symbol;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "StringInterner.h"
+#include "Symbol.h"
+
+using namespace std;
+
+// ========== Classe ScopedSymbolTable ==========
+// Table des variables nommées d'une fonction, à plat pour toutes les portées :
+// chaque identifiant interné désigne la pile de ses liaisons (la plus interne
+// au sommet), et chaque portée retient dans un journal les identifiants
+// qu'elle a liés pour les défaire à sa fermeture. Déclaration et recherche se
+// font en O(1), quelle que soit la profondeur d'imbrication
+class ScopedSymbolTable
+{
+public:
+  // Ouvre une nouvelle portée
+  inline void pushScope() { scopeStarts.push_back(undoLog.size()); }
+
+  // Ferme la portée courante et retourne ses symboles, dans l'ordre de déclaration
+  vector<shared_ptr<Symbol>> popScope();
+
+  inline bool empty() const { return scopeStarts.empty(); }
+
+  // Lie id dans la portée courante (false s'il y est déjà lié)
+  bool declare(Identifier id, shared_ptr<Symbol> symbol);
+
+  // Liaison visible de id (nullptr s'il n'est lié dans aucune portée ouverte)
+  shared_ptr<Symbol> lookup(Identifier id) const;
+
+private:
+  struct Binding
+  {
+    shared_ptr<Symbol> symbol;
+    size_t scope; // Profondeur de la portée qui l'a déclarée
+  };
+
+  unordered_map<Identifier, vector<Binding>> bindings;
+  vector<Identifier> undoLog;  // Identifiants liés, portée par portée
+  vector<size_t> scopeStarts;  // Début de chaque portée ouverte dans undoLog
+};
@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <spawn.h>
+#include <sstream>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+#include "CompileProtocol.h"
+
+using namespace std;
+
+extern char **environ;
+
+// Affiche le minimum, la médiane, le 99e centile et la moyenne, en microsecondes
+static void printLatencies(const string &label, vector<double> latencies)
+{
+  sort(latencies.begin(), latencies.end());
+  double total = 0;
+  for (double latency : latencies)
+  {
+    total += latency;
+  }
+  cout << label << ": min " << latencies.front() << " us, median "
+       << latencies[latencies.size() / 2] << " us, p99 "
+       << latencies[latencies.size() * 99 / 100] << " us, mean "
+       << total / latencies.size() << " us (" << latencies.size() << " compilations)"
+       << endl;
+}
+
+/**
+ * Mesure la latence d'une compilation par ifcc --server : chaque requête
+ * est envoyée sur une connexion déjà ouverte, comme le ferait un système de
+ * build. Avec --spawn, mesure aussi le lancement d'un processus ifcc par
+ * fichier pour comparaison.
+ * usage: ifcc-bench socket file.c [count] [--spawn path/to/ifcc]
+ */
+int main(int argn, const char **argv)
+{
+  if (argn < 3)
+  {
+    cerr << "usage: ifcc-bench socket file.c [count] [--spawn path/to/ifcc]" << endl;
+    return 1;
+  }
+  string socketPath = argv[1];
+  string sourceName = argv[2];
+  int count = 1000;
+  const char *ifccPath = nullptr;
+  for (int i = 3; i < argn; i++)
+  {
+    if (string(argv[i]) == "--spawn" && i + 1 < argn)
+    {
+      ifccPath = argv[++i];
+    }
+    else
+    {
+      count = max(1, atoi(argv[i]));
+    }
+  }
+
+  ifstream file(sourceName);
+  if (!file)
+  {
+    cerr << "error: cannot read file: " << sourceName << endl;
+    return 1;
+  }
+  stringstream contents;
+  contents << file.rdbuf();
+
+  int connection = connectToSocket(socketPath);
+  if (connection < 0)
+  {
+    cerr << "error: cannot connect to compile server: " << socketPath << endl;
+    return 1;
+  }
+  ServerRequest request;
+  request.sourceName = sourceName;
+  request.source = contents.str();
+  ServerReply reply;
+  vector<double> latencies;
+  for (int i = 0; i < count; i++)
+  {
+    auto start = chrono::steady_clock::now();
+    if (!sendRequest(connection, request) || !receiveReply(connection, reply))
+    {
+      cerr << "error: lost connection to compile server" << endl;
+      return 1;
+    }
+    latencies.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - start).count());
+  }
+  close(connection);
+  if (!reply.success)
+  {
+    cerr << reply.diagnostics;
+    return 1;
+  }
+  printLatencies("server", latencies);
+
+  if (ifccPath != nullptr)
+  {
+    latencies.clear();
+    const char *arguments[] = {ifccPath, "-o", "/dev/null", sourceName.c_str(), nullptr};
+    for (int i = 0; i < min(count, 200); i++)
+    {
+      auto start = chrono::steady_clock::now();
+      pid_t child;
+      int status = 0;
+      if (posix_spawn(&child, ifccPath, nullptr, nullptr, (char *const *)arguments, environ) != 0 ||
+          waitpid(child, &status, 0) < 0)
+      {
+        cerr << "error: cannot run " << ifccPath << endl;
+        return 1;
+      }
+      latencies.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - start).count());
+    }
+    printLatencies("process", latencies);
+  }
+  return 0;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// ========== Classe Sha256 ==========
+// Empreinte SHA-256 (FIPS 180-4), calculée par morceaux
+class Sha256
+{
+public:
+  Sha256();
+
+  void update(string_view data);
+  // Termine le calcul et retourne l'empreinte en hexadécimal (64 caractères)
+  string hexDigest();
+
+private:
+  uint32_t state[8];
+  unsigned char block[64];
+  size_t blockLength = 0;
+  uint64_t totalLength = 0;
+
+  void processBlock(const unsigned char *data);
+};
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <utility>
+
+using namespace std;
+
+// ========== Classe SmallVector ==========
+// Tableau dynamique dont les N premiers éléments sont rangés dans l'objet
+// lui-même : tant qu'il n'en contient pas plus, aucune allocation n'est faite.
+// Au-delà, les éléments passent dans un tampon alloué qui double à chaque
+// agrandissement, comme pour vector.
+template <class T, size_t N>
+class SmallVector
+{
+public:
+  typedef T value_type;
+  typedef T *iterator;
+  typedef const T *const_iterator;
+  typedef std::reverse_iterator<T *> reverse_iterator;
+  typedef std::reverse_iterator<const T *> const_reverse_iterator;
+
+  SmallVector() = default;
+
+  SmallVector(initializer_list<T> values)
+  {
+    reserve(values.size());
+    for (const T &value : values)
+    {
+      new (items + count++) T(value);
+    }
+  }
+
+  SmallVector(const SmallVector &other)
+  {
+    reserve(other.count);
+    for (const T &value : other)
+    {
+      new (items + count++) T(value);
+    }
+  }
+
+  SmallVector(SmallVector &&other) noexcept { take(other); }
+
+  SmallVector &operator=(const SmallVector &other)
+  {
+    if (this != &other)
+    {
+      clear();
+      reserve(other.count);
+      for (const T &value : other)
+      {
+        new (items + count++) T(value);
+      }
+    }
+    return *this;
+  }
+
+  SmallVector &operator=(SmallVector &&other) noexcept
+  {
+    if (this != &other)
+    {
+      clear();
+      release();
+      take(other);
+    }
+    return *this;
+  }
+
+  ~SmallVector()
+  {
+    clear();
+    release();
+  }
+
+  inline size_t size() const { return count; }
+  inline bool empty() const { return count == 0; }
+  inline T &operator[](size_t i) { return items[i]; }
+  inline const T &operator[](size_t i) const { return items[i]; }
+  inline T &back() { return items[count - 1]; }
+  inline const T &back() const { return items[count - 1]; }
+
+  inline iterator begin() { return items; }
+  inline iterator end() { return items + count; }
+  inline const_iterator begin() const { return items; }
+  inline const_iterator end() const { return items + count; }
+  inline reverse_iterator rbegin() { return reverse_iterator(end()); }
+  inline reverse_iterator rend() { return reverse_iterator(begin()); }
+  inline const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+  inline const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+  void push_back(const T &value)
+  {
+    if (count == capacity)
+    {
+      // value peut désigner un élément du tableau : copié avant l'agrandissement
+      T copy(value);
+      grow(count + 1);
+      new (items + count++) T(move(copy));
+      return;
+    }
+    new (items + count++) T(value);
+  }
+
+  void push_back(T &&value)
+  {
+    if (count == capacity)
+    {
+      T moved(move(value));
+      grow(count + 1);
+      new (items + count++) T(move(moved));
+      return;
+    }
+    new (items + count++) T(move(value));
+  }
+
+  void reserve(size_t minimum)
+  {
+    if (minimum > capacity)
+    {
+      grow(minimum);
+    }
+  }
+
+  void clear()
+  {
+    for (size_t i = 0; i < count; i++)
+    {
+      items[i].~T();
+    }
+    count = 0;
+  }
+
+private:
+  alignas(T) unsigned char storage[N * sizeof(T)];
+  T *items = reinterpret_cast<T *>(storage);
+  uint32_t count = 0;
+  uint32_t capacity = N;
+
+  inline bool isInline() const { return items == reinterpret_cast<const T *>(storage); }
+
+  // Déplace les éléments dans un tampon d'au moins minimum places
+  void grow(size_t minimum)
+  {
+    size_t newCapacity = max<size_t>(minimum, 2 * capacity);
+    T *buffer = static_cast<T *>(::operator new(newCapacity * sizeof(T)));
+    for (size_t i = 0; i < count; i++)
+    {
+      new (buffer + i) T(move(items[i]));
+      items[i].~T();
+    }
+    release();
+    items = buffer;
+    capacity = static_cast<uint32_t>(newCapacity);
+  }
+
+  // Rend le tampon alloué (les éléments doivent déjà être détruits ou déplacés)
+  void release()
+  {
+    if (!isInline())
+    {
+      ::operator delete(items);
+      items = reinterpret_cast<T *>(storage);
+      capacity = N;
+    }
+  }
+
+  // Reprend les éléments de other, qui est laissé vide
+  void take(SmallVector &other)
+  {
+    if (other.isInline())
+    {
+      for (size_t i = 0; i < other.count; i++)
+      {
+        new (items + count++) T(move(other.items[i]));
+      }
+      other.clear();
+      return;
+    }
+    items = other.items;
+    count = other.count;
+    capacity = other.capacity;
+    other.items = reinterpret_cast<T *>(other.storage);
+    other.count = 0;
+    other.capacity = N;
+  }
+};
@@ -0,0 +1,138 @@
+#include "SourceFile.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Preprocessor.h"
+
+// Valeur de fin de flux attendue par ANTLR (IntStream::EOF)
+static const size_t END_OF_INPUT = static_cast<size_t>(-1);
+
+SourceFile::~SourceFile()
+{
+  if (mapped)
+  {
+    munmap(const_cast<char *>(data), length);
+  }
+}
+
+/**
+ * Ouvre un fichier source. Un fichier régulier non vide est projeté en
+ * mémoire en lecture seule ; sinon (entrée standard, tube, fichier vide ou
+ * échec de mmap) son contenu est lu par blocs dans un tampon
+ * @param path Le chemin du fichier, ou "-" pour l'entrée standard
+ * @return false si le fichier ne peut pas être ouvert ou lu
+ */
+bool SourceFile::open(const string &path)
+{
+  name = path == "-" ? "<stdin>" : path;
+  if (path == "-")
+  {
+    return readAll(STDIN_FILENO);
+  }
+
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    return false;
+  }
+
+  struct stat status;
+  if (fstat(fd, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0)
+  {
+    void *address = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (address != MAP_FAILED)
+    {
+      madvise(address, status.st_size, MADV_SEQUENTIAL);
+      data = static_cast<const char *>(address);
+      length = status.st_size;
+      mapped = true;
+      close(fd);
+      return true;
+    }
+  }
+
+  bool success = readAll(fd);
+  close(fd);
+  return success;
+}
+
+/**
+ * Lit tout le contenu d'un descripteur dans le tampon interne
+ */
+bool SourceFile::readAll(int fd)
+{
+  char chunk[1 << 16];
+  ssize_t count;
+  while ((count = read(fd, chunk, sizeof(chunk))) != 0)
+  {
+    if (count < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      return false;
+    }
+    buffer.append(chunk, count);
+  }
+  data = buffer.data();
+  length = buffer.size();
+  return true;
+}
+
+void SourceCharStream::consume()
+{
+  if (position < text.size())
+  {
+    position++;
+  }
+}
+
+/**
+ * Caractère à la position relative i (1 : caractère courant, -1 : précédent)
+ */
+size_t SourceCharStream::LA(ssize_t i)
+{
+  if (i == 0)
+  {
+    return 0;
+  }
+  ssize_t index = (ssize_t)position + (i > 0 ? i - 1 : i);
+  if (index < 0 || index >= (ssize_t)text.size())
+  {
+    return END_OF_INPUT;
+  }
+  return static_cast<unsigned char>(text[index]);
+}
+
+void SourceCharStream::seek(size_t index)
+{
+  position = min(index, text.size());
+}
+
+size_t SourceCharStream::size()
+{
+  return sourceMap != nullptr ? sourceMap->size() : text.size();
+}
+
+/**
+ * Texte compris entre deux positions incluses (utilisé pour le texte des tokens)
+ */
+string SourceCharStream::getText(const antlr4::misc::Interval &interval)
+{
+  if (interval.a < 0 || interval.b < interval.a || (size_t)interval.a >= size())
+  {
+    return "";
+  }
+  if (sourceMap != nullptr)
+  {
+    return string(sourceMap->text(interval.a, interval.b - interval.a + 1));
+  }
+  size_t stop = min((size_t)interval.b, text.size() - 1);
+  return string(text.substr(interval.a, stop - interval.a + 1));
+}
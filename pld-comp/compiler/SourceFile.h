@@ -0,0 +1,85 @@
+#pragma once
+
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <sys/stat.h>
+
+#include "antlr4-runtime.h"
+
+using namespace std;
+
+class SourceMap;
+
+// Date de modification d'un fichier (st_mtim sous Linux, st_mtimespec sous macOS)
+inline timespec modificationTime(const struct stat &status)
+{
+#ifdef __APPLE__
+  return status.st_mtimespec;
+#else
+  return status.st_mtim;
+#endif
+}
+
+// ========== Classe SourceFile ==========
+// Contenu d'un fichier source, projeté en mémoire (mmap) sans copie lorsque
+// c'est possible ; l'entrée standard ("-"), les tubes et les fichiers spéciaux
+// sont lus dans un tampon
+class SourceFile
+{
+public:
+  SourceFile() = default;
+  ~SourceFile();
+  SourceFile(const SourceFile &) = delete;
+  SourceFile &operator=(const SourceFile &) = delete;
+
+  // Ouvre le fichier path ("-" pour l'entrée standard) ; false en cas d'erreur
+  bool open(const string &path);
+
+  inline string_view contents() const { return string_view(data, length); }
+  inline const string &getName() const { return name; }
+
+private:
+  string name;
+  const char *data = nullptr;
+  size_t length = 0;
+  bool mapped = false; // true si data provient de mmap
+  string buffer;       // Contenu lu lorsque la projection est impossible
+
+  bool readAll(int fd);
+};
+
+// ========== Classe SourceCharStream ==========
+// Flux de caractères ANTLR lisant directement les octets d'un SourceFile
+// (ou d'un texte en mémoire), sans le décodage en UTF-32 ni la copie
+// d'ANTLRInputStream. La grammaire étant ASCII, chaque octet est un caractère.
+// Avec une SourceMap, le texte des tokens est lu dans ses positions
+// virtuelles (fichiers inclus compris).
+class SourceCharStream : public antlr4::CharStream
+{
+public:
+  explicit SourceCharStream(const SourceFile &source)
+      : text(source.contents()), name(source.getName()) {}
+  // Le texte doit rester valide tant que le flux est utilisé
+  SourceCharStream(string_view text, const string &name) : text(text), name(name) {}
+
+  void consume() override;
+  size_t LA(ssize_t i) override;
+  ssize_t mark() override { return -1; }
+  void release(ssize_t) override {}
+  size_t index() override { return position; }
+  void seek(size_t index) override;
+  size_t size() override;
+  string getSourceName() const override { return name; }
+  string getText(const antlr4::misc::Interval &interval) override;
+  string toString() const override { return string(text); }
+
+  // Le texte des tokens du préprocesseur (nullptr : seulement le texte lu)
+  inline void setSourceMap(const SourceMap *map) { sourceMap = map; }
+
+private:
+  string_view text;
+  string name;
+  size_t position = 0;
+  const SourceMap *sourceMap = nullptr;
+};
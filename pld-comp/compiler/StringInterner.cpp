@@ -0,0 +1,19 @@
+#include "StringInterner.h"
+
+#include <cstring>
+
+Identifier StringInterner::intern(string_view text)
+{
+  auto existing = ids.find(text);
+  if (existing != ids.end())
+  {
+    return existing->second;
+  }
+  char *copy = static_cast<char *>(storage.allocate(text.size() + 1, 1));
+  memcpy(copy, text.data(), text.size());
+  copy[text.size()] = '\0';
+  Identifier id = strings.size();
+  strings.emplace_back(copy, text.size());
+  ids.emplace(strings.back(), id);
+  return id;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Arena.h"
+
+using namespace std;
+
+// Identifiant d'une chaîne internée : deux chaînes égales ont le même
+typedef uint32_t Identifier;
+
+// ========== Classe StringInterner ==========
+// Table des chaînes (identifiants, littéraux) : chaque texte distinct n'est
+// copié qu'une fois, et désigné ensuite par un entier comparable en O(1)
+class StringInterner
+{
+public:
+  // Identifiant de text, ajouté s'il est nouveau
+  Identifier intern(string_view text);
+
+  // Texte d'un identifiant (valable aussi longtemps que la table)
+  inline string_view spelling(Identifier id) const { return strings[id]; }
+
+  inline size_t size() const { return strings.size(); }
+
+private:
+  Arena storage{16 * 1024};
+  vector<string_view> strings;
+  unordered_map<string_view, Identifier> ids;
+};
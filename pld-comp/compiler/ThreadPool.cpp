@@ -0,0 +1,180 @@
+#include "ThreadPool.h"
+
+// File du thread courant : le pool dont il est un thread, et l'index de sa
+// file dans ce pool (0 hors des threads du pool)
+struct ThreadQueue
+{
+  const ThreadPool *pool = nullptr;
+  size_t index = 0;
+};
+static thread_local ThreadQueue threadQueue;
+
+// Groupe de la tâche en cours d'exécution sur ce thread (nullptr : aucune)
+static thread_local const TaskGroup *runningGroup = nullptr;
+
+TaskGroup::TaskGroup() : parent(runningGroup) {}
+
+// true si group est within ou l'un de ses sous-groupes
+static bool isWithin(const TaskGroup *group, const TaskGroup *within)
+{
+  for (; group != nullptr; group = group->parent)
+  {
+    if (group == within)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Crée le pool. Le thread appelant compte comme l'un des threads : il
+ * participe au travail pendant ThreadPool::wait
+ * @param threadCount Le nombre total de threads (au moins 1)
+ */
+ThreadPool::ThreadPool(unsigned threadCount)
+{
+  if (threadCount == 0)
+  {
+    threadCount = 1;
+  }
+  for (unsigned i = 0; i < threadCount; i++)
+  {
+    queues.push_back(make_unique<WorkQueue>());
+  }
+  for (unsigned i = 1; i < threadCount; i++)
+  {
+    workers.emplace_back(&ThreadPool::workerLoop, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    lock_guard<mutex> guard(sleepLock);
+    stopping = true;
+  }
+  wakeUp.notify_all();
+  for (thread &worker : workers)
+  {
+    worker.join();
+  }
+}
+
+size_t ThreadPool::currentQueue() const
+{
+  return threadQueue.pool == this ? threadQueue.index : 0;
+}
+
+/**
+ * Ajoute une tâche : depuis un thread du pool elle va dans sa propre file,
+ * sinon les files sont remplies à tour de rôle
+ */
+void ThreadPool::submit(TaskGroup &group, function<void()> task)
+{
+  group.pending++;
+  size_t queueIndex = currentQueue() != 0 ? currentQueue() : nextQueue++ % queues.size();
+  {
+    lock_guard<mutex> guard(queues[queueIndex]->lock);
+    queues[queueIndex]->tasks.push_back({move(task), &group});
+  }
+  {
+    lock_guard<mutex> guard(sleepLock);
+    queuedTasks++;
+    submittedTasks++;
+  }
+  // Tous les threads : seul l'un de ceux qui attendent un groupe peut être
+  // autorisé à exécuter cette tâche
+  wakeUp.notify_all();
+}
+
+/**
+ * Exécute une tâche : d'abord la plus récente de la file du thread, sinon la
+ * plus ancienne d'une autre file
+ * @param within Si non nul, seules les tâches de ce groupe ou de ses
+ *               sous-groupes sont exécutées
+ * @return false si aucune tâche n'était disponible
+ */
+bool ThreadPool::runOneTask(size_t queueIndex, const TaskGroup *within)
+{
+  Task task;
+  bool found = false;
+  for (size_t offset = 0; !found && offset < queues.size(); offset++)
+  {
+    WorkQueue &queue = *queues[(queueIndex + offset) % queues.size()];
+    lock_guard<mutex> guard(queue.lock);
+    // Sa propre file se dépile par la fin, les autres par le début
+    for (size_t i = 0; !found && i < queue.tasks.size(); i++)
+    {
+      size_t position = offset == 0 ? queue.tasks.size() - 1 - i : i;
+      if (within == nullptr || isWithin(queue.tasks[position].group, within))
+      {
+        task = move(queue.tasks[position]);
+        queue.tasks.erase(queue.tasks.begin() + position);
+        found = true;
+      }
+    }
+  }
+  if (!found)
+  {
+    return false;
+  }
+
+  queuedTasks--;
+  const TaskGroup *previous = runningGroup;
+  runningGroup = task.group;
+  task.run();
+  runningGroup = previous;
+  if (--task.group->pending == 0)
+  {
+    lock_guard<mutex> guard(sleepLock);
+    wakeUp.notify_all();
+  }
+  return true;
+}
+
+void ThreadPool::workerLoop(size_t queueIndex)
+{
+  threadQueue = {this, queueIndex};
+  while (true)
+  {
+    if (runOneTask(queueIndex))
+    {
+      continue;
+    }
+    unique_lock<mutex> guard(sleepLock);
+    wakeUp.wait(guard, [this]
+                { return stopping || queuedTasks > 0; });
+    if (stopping)
+    {
+      return;
+    }
+  }
+}
+
+/**
+ * Attend la fin des tâches du groupe en exécutant celles du groupe et de ses
+ * sous-groupes plutôt que de bloquer le thread. Les tâches d'autres groupes
+ * sont laissées aux autres threads : exécutées ici, elles pourraient elles
+ * aussi attendre, et empiler des compilations entières sur la même pile.
+ */
+void ThreadPool::wait(TaskGroup &group)
+{
+  size_t queueIndex = currentQueue();
+  while (group.pending > 0)
+  {
+    size_t submitted;
+    {
+      lock_guard<mutex> guard(sleepLock);
+      submitted = submittedTasks;
+    }
+    if (runOneTask(queueIndex, &group))
+    {
+      continue;
+    }
+    // Dort jusqu'à la fin du groupe ou l'arrivée d'une nouvelle tâche
+    unique_lock<mutex> guard(sleepLock);
+    wakeUp.wait(guard, [this, &group, submitted]
+                { return group.pending == 0 || submittedTasks != submitted; });
+  }
+}
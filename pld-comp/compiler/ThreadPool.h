@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// ========== Classe TaskGroup ==========
+// Ensemble de tâches dont on attend la fin avec ThreadPool::wait. Un groupe
+// créé pendant une tâche est un sous-groupe du groupe de cette tâche.
+struct TaskGroup
+{
+  TaskGroup();
+
+  atomic<size_t> pending{0};
+  const TaskGroup *parent; // Groupe de la tâche qui l'a créé (nullptr : aucune)
+};
+
+// ========== Classe ThreadPool ==========
+// Pool de threads à vol de tâches : chaque thread possède sa file, dépile ses
+// propres tâches par la fin (LIFO) et vole celles des autres par le début.
+// Un thread qui attend un groupe exécute les tâches de ce groupe et de ses
+// sous-groupes en attendant, ce qui permet de soumettre et d'attendre des
+// tâches depuis une tâche sans empiler sur sa pile des tâches sans rapport.
+class ThreadPool
+{
+public:
+  // Crée un pool de threadCount threads (le thread appelant compris)
+  explicit ThreadPool(unsigned threadCount);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  // Ajoute une tâche au groupe et la rend disponible pour les threads
+  void submit(TaskGroup &group, function<void()> task);
+  // Exécute des tâches jusqu'à ce que toutes celles du groupe soient terminées
+  void wait(TaskGroup &group);
+
+  inline unsigned size() const { return queues.size(); }
+
+private:
+  struct Task
+  {
+    function<void()> run;
+    TaskGroup *group;
+  };
+
+  struct WorkQueue
+  {
+    mutex lock;
+    deque<Task> tasks;
+  };
+
+  vector<unique_ptr<WorkQueue>> queues; // Une file par thread, la 0 pour le thread appelant
+  vector<thread> workers;
+  atomic<size_t> nextQueue{0};
+  atomic<bool> stopping{false};
+  mutex sleepLock;
+  condition_variable wakeUp;
+  atomic<size_t> queuedTasks{0};
+  size_t submittedTasks = 0; // Protégé par sleepLock : réveille les attentes de wait
+
+  bool runOneTask(size_t queueIndex, const TaskGroup *within = nullptr);
+  void workerLoop(size_t queueIndex);
+  size_t currentQueue() const;
+};
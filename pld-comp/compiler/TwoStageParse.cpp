@@ -0,0 +1,40 @@
+#include "TwoStageParse.h"
+
+using namespace antlr4;
+
+/**
+ * Analyse le programme en prédiction SLL, puis en LL complet si l'analyse SLL
+ * échoue (erreur de syntaxe, ou ambiguïté que SLL ne sait pas trancher)
+ * @param parser Le parser, dont le flux de tokens est au début
+ * @param errorListener Reçoit les erreurs de syntaxe, signalées seulement
+ *                      pendant l'analyse LL
+ * @return L'arbre syntaxique et l'analyse qui l'a produit
+ */
+TwoStageParseResult parseTwoStage(ifccParser &parser, ANTLRErrorListener *errorListener)
+{
+  TwoStageParseResult result;
+  auto *interpreter = parser.getInterpreter<atn::ParserATNSimulator>();
+
+  // Premier temps : SLL, abandon à la première erreur, sans message
+  interpreter->setPredictionMode(atn::PredictionMode::SLL);
+  parser.setErrorHandler(make_shared<BailErrorStrategy>());
+  parser.removeErrorListeners();
+  try
+  {
+    result.tree = parser.axiom();
+    return result;
+  }
+  catch (ParseCancellationException &)
+  {
+  }
+
+  // Second temps : rembobine les tokens (reset) et réanalyse en LL complet,
+  // avec le rattrapage et les messages de l'analyse par défaut
+  parser.setErrorHandler(make_shared<DefaultErrorStrategy>());
+  parser.reset();
+  parser.addErrorListener(errorListener);
+  interpreter->setPredictionMode(atn::PredictionMode::LL);
+  result.tree = parser.axiom();
+  result.usedFullLL = true;
+  return result;
+}
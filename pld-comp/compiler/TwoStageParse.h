@@ -0,0 +1,24 @@
+#pragma once
+
+#include "antlr4-runtime.h"
+#include "generated/ifccParser.h"
+
+using namespace std;
+
+// ========== Analyse en deux temps avec ifccParser ==========
+// Stratégie recommandée par ANTLR : une première analyse en prédiction SLL,
+// sans rattrapage d'erreur (BailErrorStrategy) ni affichage, suffit pour
+// presque tous les programmes corrects ; en cas d'échec seulement, le flux de
+// tokens est rembobiné et le programme réanalysé en LL complet avec la
+// stratégie d'erreur par défaut, qui signale les mêmes erreurs qu'une
+// analyse LL directe.
+
+// Résultat d'une analyse en deux temps
+struct TwoStageParseResult
+{
+  ifccParser::AxiomContext *tree = nullptr; // Appartient au parser
+  bool usedFullLL = false;                  // true si la première analyse a échoué
+};
+
+// Analyse le programme du flux de tokens de parser (erreurs vers errorListener)
+TwoStageParseResult parseTwoStage(ifccParser &parser, antlr4::ANTLRErrorListener *errorListener);
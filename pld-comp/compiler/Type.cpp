@@ -10,4 +10,16 @@ unsigned int getSize(Type t) {
     return 0;
   }
   return 0;
+}
+
+const char *getTypeName(Type t) {
+  switch (t) {
+  case Type::INT:
+    return "int";
+  case Type::CHAR:
+    return "char";
+  case Type::VOID:
+    return "void";
+  }
+  return "";
 }
\ No newline at end of file
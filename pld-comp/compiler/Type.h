@@ -1,4 +1,5 @@
 #pragma once
 enum class Type { INT, CHAR, VOID };
 
-unsigned int getSize(Type t);
\ No newline at end of file
+unsigned int getSize(Type t);
+const char *getTypeName(Type t);
\ No newline at end of file
@@ -1,82 +1,366 @@
+#include <csignal>
 #include <cstdlib>
-#include <fstream>
 #include <iostream>
-#include <sstream>
+#include <memory>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
 
-// Inclusion des fichiers nécessaires pour ANTLR et le générateur de code
-#include "antlr4-runtime.h"
-#include "generated/ifccLexer.h"
-#include "generated/ifccParser.h"
+// Le driver ne fait que lire les fichiers, appeler libifcc et écrire le résultat
+#include "Compiler.h"
+#include "CompileCache.h"
+#include "CompileProtocol.h"
+#include "CompileServer.h"
+#include "IncludeCache.h"
+#include "SourceFile.h"
+#include "ThreadPool.h"
 
-#include "CodeGenVisitor.h"
-#include "CFG.h"
-#include "BasicBlock.h"
-#include "IR.h"
-
-using namespace antlr4;
 using namespace std;
 
-int main(int argn, const char **argv) {
-  stringstream in;
-
-  // Vérifie si un fichier a été passé en argument
-  if (argn == 2) {
-    ifstream lecture(argv[1]); // Ouvre le fichier en lecture
-    if (!lecture.good()) { // Vérifie si le fichier est lisible
-      cerr << "error: cannot read file: " << argv[1] << endl;
-      exit(1); // Quitte le programme en cas d'erreur
+// Compilation d'un fichier de la ligne de commande : le résultat est conservé
+// jusqu'à l'affichage final pour que les sorties apparaissent dans l'ordre
+// des fichiers donnés
+struct FileCompilation {
+  string sourceName;
+  string outputName; // Fichier assembleur produit (vide pour la sortie standard)
+  CompileResult result;
+};
+
+// Répertoire courant du processus ("" s'il ne peut pas être lu)
+static string currentDirectory() {
+  char *path = getcwd(nullptr, 0);
+  if (path == nullptr) {
+    return "";
+  }
+  string directory = path;
+  free(path);
+  return directory;
+}
+
+/**
+ * Lit un fichier source, le compile avec libifcc et écrit l'assembleur.
+ * Les fichiers sont indépendants et peuvent être traités en parallèle.
+ * @param file Le fichier à compiler ("-" pour l'entrée standard) ; reçoit le résultat
+ * @param options Les options de la ligne de commande
+ * @param cache Le cache des compilations (nullptr s'il est désactivé)
+ */
+static void compileFile(FileCompilation &file, const CompileOptions &options,
+                        CompileCache *cache) {
+  SourceFile source; // Projette le fichier en mémoire
+  if (!source.open(file.sourceName)) { // Vérifie si le fichier est lisible
+    file.result.diagnostics.push_back(
+        {ErrorType::Error, 0, 0, "cannot read file: " + file.sourceName});
+    return;
+  }
+
+  // Un source déjà compilé est repris du cache, sans analyse, tant que ses
+  // #include trouvent les mêmes fichiers. Les #include "..." étant cherchés à
+  // partir de son répertoire, celui-ci fait partie de la clé
+  string key;
+  CachedCompilation cached;
+  if (cache != nullptr) {
+    size_t slash = file.sourceName.find_last_of('/');
+    string directory = slash == string::npos ? "." : file.sourceName.substr(0, slash + 1);
+    if (directory[0] != '/') {
+      directory = options.workingDirectory + "/" + directory;
     }
-    in << lecture.rdbuf(); // Charge le contenu du fichier dans un flux
+    key = CompileCache::computeKey(source.contents(),
+                                   canonicalOptions(options) + "dir=" + directory + ";");
+  }
+  if (cache != nullptr && cache->lookup(key, cached, options.includeCache)) {
+    file.result.success = true;
+    file.result.assembly << cached.assembly;
+    file.result.diagnostics = move(cached.diagnostics);
   } else {
-    // Affiche un message d'utilisation si aucun fichier n'est fourni
-    cerr << "usage: ifcc path/to/file.c" << endl;
-    exit(1);
+    CompileOptions fileOptions = options;
+    fileOptions.sourceName = source.getName();
+    file.result = compile(source.contents(), fileOptions);
+    if (!file.result.success) {
+      return;
+    }
+    if (cache != nullptr) {
+      cached.assembly.assign(file.result.assembly.data(), file.result.assembly.size());
+      cached.diagnostics = file.result.diagnostics;
+      cached.includes = file.result.includes;
+      cache->store(key, cached);
+    }
   }
 
-  // Crée un flux d'entrée pour ANTLR à partir du contenu du fichier
-  ANTLRInputStream input(in.str());
+  // Écrit le code assembleur dans le fichier demandé ou sur la sortie standard
+  bool written = !file.outputName.empty() ? file.result.assembly.writeToFile(file.outputName)
+                                          : file.result.assembly.writeTo(STDOUT_FILENO);
+  if (!written) {
+    file.result.diagnostics.push_back(
+        {ErrorType::Error, 0, 0,
+         "cannot write output: " + (!file.outputName.empty() ? file.outputName : string("stdout"))});
+    file.result.success = false;
+  }
+}
 
-  // Initialise le lexer pour analyser les tokens
-  ifccLexer lexer(&input);
-  CommonTokenStream tokens(&lexer);
+/**
+ * Mode client : fait compiler chaque fichier par un serveur ifcc --server et
+ * reproduit la sortie qu'aurait eue la compilation locale
+ * @param socketPath La socket du serveur
+ * @param files Les fichiers à compiler et leurs fichiers assembleur
+ * @param options Les options de la ligne de commande (analyseurs, -I)
+ * @param dumpIR La passe demandée avec -dump-ir ("" : aucune)
+ * @param showStats true si -stats est demandé
+ * @return Le code de retour du programme
+ */
+static int compileWithServer(const string &socketPath, vector<FileCompilation> &files,
+                             const CompileOptions &options, const string &dumpIR,
+                             bool showStats) {
+  int connection = connectToSocket(socketPath);
+  if (connection < 0) {
+    cerr << "error: cannot connect to compile server: " << socketPath << endl;
+    return 1;
+  }
+  signal(SIGPIPE, SIG_IGN); // Une connexion perdue est signalée par sendRequest
 
-  tokens.fill(); // Remplit le flux de tokens
+  int status = 0;
+  ServerRequest request;
+  request.dumpIR = dumpIR;
+  request.stats = showStats;
+  request.nativeLexer = options.nativeLexer;
+  request.nativeParser = options.nativeParser;
+  request.includePaths = options.includePaths;
+  // Le serveur lit les fichiers inclus par rapport au répertoire du client
+  request.workingDirectory = options.workingDirectory;
+  for (FileCompilation &file : files) {
+    SourceFile source; // Projette le fichier en mémoire
+    ServerReply reply;
+    if (!source.open(file.sourceName)) { // Vérifie si le fichier est lisible
+      AsmWriter messages(0);
+      printDiagnostics(messages,
+                       {{ErrorType::Error, 0, 0, "cannot read file: " + file.sourceName}});
+      reply.diagnostics.assign(messages.data(), messages.size());
+    } else {
+      request.sourceName = source.getName();
+      request.source = source.contents();
+      if (!sendRequest(connection, request) || !receiveReply(connection, reply)) {
+        cerr << "error: lost connection to compile server" << endl;
+        close(connection);
+        return 1;
+      }
+    }
+    cerr << reply.diagnostics << reply.irDump << reply.stats << flush;
 
-  // Initialise le parser pour analyser la grammaire
-  ifccParser parser(&tokens);
-  tree::ParseTree *tree = parser.axiom(); // Analyse l'arbre syntaxique
+    // Écrit le code assembleur dans le fichier demandé ou sur la sortie standard
+    AsmWriter output(0);
+    output << reply.assembly;
+    bool written = reply.success && (!file.outputName.empty() ? output.writeToFile(file.outputName)
+                                                              : output.writeTo(STDOUT_FILENO));
+    if (reply.success && !written) {
+      cerr << "error: cannot write output: "
+           << (!file.outputName.empty() ? file.outputName : "stdout") << endl;
+    }
+    status |= written ? 0 : 1;
+  }
+  close(connection);
+  return status;
+}
 
-  // Vérifie s'il y a des erreurs de syntaxe
-  if (lexer.getNumberOfSyntaxErrors() != 0 ||
-      parser.getNumberOfSyntaxErrors() != 0) {
-    cerr << "error: syntax error during parsing" << endl;
-    exit(1); // Quitte le programme en cas d'erreur
+// Nom du fichier assembleur correspondant à un source : "dir/a.c" -> "a.s"
+static string assemblyName(const string &sourceName) {
+  size_t slash = sourceName.find_last_of('/');
+  string base = slash == string::npos ? sourceName : sourceName.substr(slash + 1);
+  size_t dot = base.find_last_of('.');
+  if (dot != string::npos && dot != 0) {
+    base.erase(dot);
   }
+  return base + ".s";
+}
 
-  // Crée un visiteur pour générer le code
-  CodeGenVisitor v;
-  v.visit(tree); // Visite l'arbre syntaxique
+static bool isDirectory(const string &path) {
+  struct stat info;
+  return stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
 
-  // Récupère la liste des CFG (Control Flow Graphs) générés
-  auto functionCFGs = v.getCfgList();
-  for (auto cfg : functionCFGs) {
-    // Ignore les fonctions spéciales "putchar" et "getchar"
-    if (cfg->get_name() == "putchar" || cfg->get_name() == "getchar") {
-      continue;
+int main(int argn, const char **argv) {
+  vector<string> sourceNames;
+  string outputName; // -o : fichier assembleur produit, ou répertoire avec plusieurs sources
+  bool showStats = false; // -stats : affiche les statistiques des passes
+  unsigned jobs = 1; // -j N : nombre de threads (fichiers et fonctions compilés en parallèle)
+  CompileOptions options;
+  string dumpIR; // Nom de la passe de -dump-ir, transmis tel quel au serveur
+  string serverSocket; // --server : socket sur laquelle attendre les requêtes
+  string clientSocket; // --client : socket du serveur qui compile à notre place
+  // -cache-dir ou IFCC_CACHE_DIR : répertoire du cache ("" : pas de cache). Le cache
+  // n'est utilisé que s'il est demandé, pour que les tests compilent vraiment
+  const char *cacheDirectorySetting = getenv("IFCC_CACHE_DIR");
+  string cacheDirectory = cacheDirectorySetting != nullptr ? cacheDirectorySetting : "";
+  const char *cacheSetting = getenv("IFCC_CACHE"); // IFCC_CACHE=0 : comme -no-cache
+  bool useCache = cacheSetting == nullptr || string(cacheSetting) != "0";
+  bool incremental = false; // -incremental : réutilise le code des fonctions inchangées
+  string cacheOption; // Dernière option du cache donnée (le serveur ne s'en sert pas)
+  const char *cacheSizeSetting = getenv("IFCC_CACHE_SIZE"); // Taille maximale en Mio
+  uint64_t cacheSize =
+      (cacheSizeSetting != nullptr ? strtoull(cacheSizeSetting, nullptr, 10) : 256) << 20;
+  bool validArguments = true;
+  IncludeCache includeCache; // Fichiers inclus, lus une fois pour tous les sources
+  options.includeCache = &includeCache;
+  // Les fichiers inclus sont désignés par un chemin absolu, dans les
+  // dépendances du cache comme pour le serveur
+  options.workingDirectory = currentDirectory();
+
+  // Analyse les options de la ligne de commande
+  for (int i = 1; i < argn && validArguments; i++) {
+    string argument = argv[i];
+    if (argument == "-stats") {
+      showStats = true;
+    } else if (argument == "-dump-ir") {
+      options.dumpAfter = IRPass::Lower;
+      dumpIR = "lower";
+    } else if (argument.rfind("-dump-ir=", 0) == 0) {
+      dumpIR = argument.substr(9);
+      if (!parseIRPass(dumpIR, options.dumpAfter)) {
+        cerr << "error: unknown pass for -dump-ir: " << argument.substr(9)
+             << " (expected lower or regalloc)" << endl;
+        exit(1);
+      }
+    } else if (argument == "-flexer=native" || argument == "-flexer=antlr") {
+      options.nativeLexer = argument == "-flexer=native";
+    } else if (argument == "-fparser=native" || argument == "-fparser=antlr") {
+      options.nativeParser = argument == "-fparser=native";
+    } else if (argument == "-no-cache") {
+      useCache = false;
+      cacheOption = argument;
+    } else if (argument == "-incremental") {
+      incremental = true;
+      cacheOption = argument;
+    } else if (argument == "-cache-dir" && i + 1 < argn) {
+      cacheDirectory = argv[++i];
+      cacheOption = argument;
+    } else if (argument == "--server" && i + 1 < argn) {
+      serverSocket = argv[++i];
+    } else if (argument == "--client" && i + 1 < argn) {
+      clientSocket = argv[++i];
+    } else if (argument.rfind("-I", 0) == 0) {
+      // "-I dir" ou "-Idir" : répertoire où chercher les #include
+      string directory = argument.size() > 2 ? argument.substr(2)
+                         : i + 1 < argn      ? string(argv[++i])
+                                             : string();
+      validArguments = !directory.empty();
+      options.includePaths.push_back(directory);
+    } else if (argument == "-o" && i + 1 < argn) {
+      outputName = argv[++i];
+    } else if (argument.rfind("-j", 0) == 0) {
+      // "-j N" ou "-jN" ; "-j0" utilise tous les cœurs disponibles
+      string count = argument.size() > 2 ? argument.substr(2)
+                     : i + 1 < argn      ? string(argv[++i])
+                                         : string();
+      char *end = nullptr;
+      long value = strtol(count.c_str(), &end, 10);
+      validArguments = !count.empty() && *end == '\0' && value >= 0;
+      jobs = value == 0 ? max(1u, thread::hardware_concurrency()) : value;
+    } else if (argument[0] != '-' || argument == "-") {
+      sourceNames.push_back(argument);
+    } else {
+      validArguments = false;
     }
-    // Génère le code assembleur pour chaque CFG
-    cfg->gen_asm(cout);
+  }
 
-    // Affiche le nom de la fonction sur la sortie d'erreur standard
-    cerr << cfg->get_name() << endl;
+  // Mode serveur : aucun fichier sur la ligne de commande
+  if (!serverSocket.empty() && validArguments && sourceNames.empty()) {
+    return runCompileServer(serverSocket, jobs);
+  }
 
-    // Affiche les instructions de chaque bloc du CFG
-    for (auto block : cfg->getBlocks()) {
-      for (auto instruction : block->instructions) {
-        cerr << instruction << endl;
-      }
+  // Vérifie si un fichier a été passé en argument ("-" pour l'entrée standard)
+  if (sourceNames.empty() || !validArguments || !serverSocket.empty()) {
+    // Affiche un message d'utilisation si aucun fichier n'est fourni
+    cerr << "usage: ifcc [--client socket] [-stats] [-dump-ir[=pass]] [-j N] "
+            "[-flexer=native|antlr] [-fparser=native|antlr] [-I dir]\n"
+            "            [-no-cache] [-cache-dir dir] [-incremental] [-o file.s|outdir/] "
+            "path/to/file.c|- ...\n"
+            "       ifcc --server socket [-j N]"
+         << endl;
+    exit(1);
+  }
+
+  // Avec plusieurs sources (ou un répertoire pour -o), chaque fichier produit
+  // son propre <nom>.s ; un seul source sans -o écrit sur la sortie standard
+  bool batch = sourceNames.size() > 1 ||
+               (!outputName.empty() && (outputName.back() == '/' || isDirectory(outputName)));
+  vector<string> outputNames;
+  for (const string &sourceName : sourceNames) {
+    if (!batch) {
+      outputNames.push_back(outputName);
+    } else if (sourceName == "-") {
+      cerr << "error: standard input cannot be compiled with other files" << endl;
+      exit(1);
+    } else if (outputName.empty()) {
+      outputNames.push_back(assemblyName(sourceName));
+    } else {
+      outputNames.push_back(outputName + (outputName.back() == '/' ? "" : "/") +
+                            assemblyName(sourceName));
+    }
+  }
+  if (batch && !outputName.empty() && !isDirectory(outputName) &&
+      mkdir(outputName.c_str(), 0755) != 0) {
+    cerr << "error: cannot create output directory: " << outputName << endl;
+    exit(1);
+  }
+
+  vector<FileCompilation> files(sourceNames.size());
+  for (size_t i = 0; i < files.size(); i++) {
+    files[i].sourceName = sourceNames[i];
+    files[i].outputName = outputNames[i];
+  }
+  if (!clientSocket.empty()) {
+    // Le serveur compile toujours sans le cache : ses options sont refusées
+    // plutôt qu'ignorées
+    if (!cacheOption.empty()) {
+      cerr << "error: " << cacheOption << " cannot be used with --client" << endl;
+      exit(1);
+    }
+    return compileWithServer(clientSocket, files, options, dumpIR, showStats);
+  }
+
+  if (incremental && cacheDirectory.empty()) {
+    cerr << "error: -incremental needs a cache directory (-cache-dir or IFCC_CACHE_DIR)" << endl;
+    exit(1);
+  }
+
+  // L'IR affiché n'étant pas conservé, -dump-ir passe outre le cache
+  unique_ptr<CompileCache> cache;
+  if (useCache && !cacheDirectory.empty() && options.dumpAfter == IRPass::None) {
+    cache = make_unique<CompileCache>(cacheDirectory, cacheSize);
+  }
+  if (incremental) {
+    options.functionCache = cache.get();
+  }
+
+  // Compile les fichiers, en parallèle avec -j ; le même pool sert aussi à
+  // répartir les fonctions de chaque fichier
+  ThreadPool pool(jobs);
+  options.pool = &pool;
+  TaskGroup group;
+  for (size_t i = 0; i < files.size(); i++) {
+    pool.submit(group, [&, i] { compileFile(files[i], options, cache.get()); });
+  }
+  pool.wait(group);
+
+  // Affiche les diagnostics, l'IR et les statistiques dans l'ordre des fichiers
+  int status = 0;
+  PeepholeStats peepholeStats;
+  for (const FileCompilation &file : files) {
+    AsmWriter messages(0);
+    printDiagnostics(messages, file.result.diagnostics);
+    messages.writeTo(STDERR_FILENO);
+    if (options.dumpAfter != IRPass::None) {
+      file.result.irDump.writeTo(STDERR_FILENO);
+    }
+    peepholeStats.merge(file.result.peepholeStats);
+    status |= file.result.success ? 0 : 1;
+  }
+
+  if (showStats) {
+    peepholeStats.print(cerr);
+    if (cache != nullptr) {
+      cache->printStats(cerr);
     }
   }
 
-  return 0; // Fin du programme
-}
\ No newline at end of file
+  return status; // Fin du programme
+}
@@ -0,0 +1,70 @@
+#!/bin/sh
+
+# Checks the compile cache: a second compile of an unchanged source is a hit
+# and gives the same output, a compile after one of its headers changed is a
+# miss and gives the output of a compile without cache.
+
+cd $(dirname $0)
+IFCC=$(pwd)/../compiler/ifcc
+work=$(mktemp -d)
+trap 'rm -rf $work' EXIT
+status=0
+
+# compile N: compiles $work/prog.c with the cache into $work/N.s
+compile() {
+    $IFCC -cache-dir $work/cache -stats -o $work/$1.s $work/prog.c 2>$work/$1.err
+}
+
+# expect N STAT COUNT: compile N must have counted COUNT cache STAT
+expect() {
+    if ! grep -q "^cache: $2: $3\$" $work/$1.err; then
+        echo "TEST FAIL ($1): expected $3 cache $2"
+        status=1
+    fi
+}
+
+# same A B: compiles A and B must have given the same assembly
+same() {
+    if ! cmp -s $work/$1.s $work/$2.s; then
+        echo "TEST FAIL ($2): output differs from $1"
+        status=1
+    fi
+}
+
+cat >$work/defs.h <<EOF
+#define LIMIT 10
+EOF
+cat >$work/prog.c <<EOF
+#include "defs.h"
+
+int main()
+{
+    int i = 0;
+    int sum = 0;
+    while (i < LIMIT)
+    {
+        sum = sum + i;
+        i = i + 1;
+    }
+    return sum;
+}
+EOF
+
+compile first
+expect first misses 1
+compile second
+expect second hits 1
+same first second
+
+# the entry is validated against the content of the header
+echo "#define LIMIT 20" >$work/defs.h
+compile header
+expect header misses 1
+expect header hits 0
+$IFCC -no-cache -o $work/clean.s $work/prog.c
+same clean header
+
+if [ $status -eq 0 ]; then
+    echo "TEST OK"
+fi
+exit $status
@@ -0,0 +1,17 @@
+#!/bin/sh
+
+# Variant of ifcc-wrapper.sh that has the program compiled by a running
+# `ifcc --server` (see server-test.sh), through `ifcc --client`.
+#
+#     ifcc-wrapper-client.sh DESTNAME SOURCENAME
+#
+# The socket of the server is $IFCC_SOCKET (default: /tmp/ifcc-test.sock).
+
+DESTNAME=$1
+SOURCENAME=$2
+
+$(dirname $0)/../compiler/ifcc --client ${IFCC_SOCKET:-/tmp/ifcc-test.sock} -o $DESTNAME $SOURCENAME
+retcode=$?
+
+# forward exit status of the compiler
+exit $retcode
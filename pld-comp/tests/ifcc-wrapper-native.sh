@@ -0,0 +1,17 @@
+#!/bin/sh
+
+# Variant of ifcc-wrapper.sh that has the program parsed by the hand-written
+# NativeParser (-fparser=native) instead of the ANTLR-generated parser:
+#
+#     python3 ifcc-test.py --wrapper ifcc-wrapper-native.sh testfiles new_tests
+#
+#     ifcc-wrapper-native.sh DESTNAME SOURCENAME
+
+DESTNAME=$1
+SOURCENAME=$2
+
+$(dirname $0)/../compiler/ifcc -fparser=native -o $DESTNAME $SOURCENAME
+retcode=$?
+
+# forward exit status of the compiler
+exit $retcode
@@ -0,0 +1,90 @@
+#!/bin/sh
+
+# Checks that `ifcc -incremental` gives the same assembly and the same
+# messages as a clean compile: compiles a program, edits it, recompiles it
+# incrementally (reusing the unchanged functions) and diffs the result with
+# a compile without cache. The edits move a function with a warning (replayed
+# from the cache at its new line), change a function body and change the
+# signature of a callee.
+
+cd $(dirname $0)
+IFCC=$(pwd)/../compiler/ifcc
+work=$(mktemp -d)
+trap 'rm -rf $work' EXIT
+status=0
+
+# compile STEP: incremental compile of $work/prog.c, compared to a clean one
+compile() {
+    $IFCC -incremental -cache-dir $work/cache -stats -o $work/inc.s $work/prog.c \
+        2>$work/inc.err
+    $IFCC -no-cache -o $work/clean.s $work/prog.c 2>$work/clean.err
+    grep -v "^cache:\|^peephole" $work/inc.err >$work/inc.msg
+    if ! diff -u $work/clean.s $work/inc.s || ! diff -u $work/clean.err $work/inc.msg; then
+        echo "TEST FAIL ($1): incremental output differs from a clean compile"
+        status=1
+    else
+        echo "TEST OK ($1)"
+    fi
+}
+
+# reused STEP: the previous compile must have reused some functions
+reused() {
+    if ! grep -q "^cache: hits: [1-9]" $work/inc.err; then
+        echo "TEST FAIL ($1): no function was reused"
+        status=1
+    fi
+}
+
+cat >$work/prog.c <<EOF
+int unusedParameter(int a)
+{
+    return 1;
+}
+
+int twice(int x)
+{
+    return x + x;
+}
+
+int main()
+{
+    int v = twice(20);
+    return v + unusedParameter(0);
+}
+EOF
+compile "first compile"
+
+# new lines before every function, a new body for main
+cat >$work/prog.c <<EOF
+int three()
+{
+    return 3;
+}
+
+int unusedParameter(int a)
+{
+    return 1;
+}
+
+int twice(int x)
+{
+    return x + x;
+}
+
+int main()
+{
+    int v = twice(20) + three();
+    return v - unusedParameter(0);
+}
+EOF
+compile "edited body"
+reused "edited body"
+grep -q "Line 6 Variable a not used" $work/inc.msg ||
+    { echo "TEST FAIL (edited body): warning not replayed at its new line"; status=1; }
+
+# a callee changes its signature, its caller does not change
+sed -i.bak 's/^int twice(int x)$/char twice(int x)/' $work/prog.c
+compile "callee signature"
+reused "callee signature"
+
+exit $status
@@ -0,0 +1,33 @@
+#!/bin/sh
+
+# Runs the test corpus through a compile server: starts `ifcc --server`,
+# compiles every test-case with `ifcc --client` (ifcc-wrapper-client.sh) and
+# stops the server. Fails if any test-case fails.
+#
+#     ./server-test.sh [PATH...]      (default: testfiles new_tests)
+
+cd $(dirname $0)
+IFCC_SOCKET=${IFCC_SOCKET:-/tmp/ifcc-test-$$.sock}
+export IFCC_SOCKET
+
+../compiler/ifcc --server $IFCC_SOCKET -j 4 &
+server=$!
+log=$(mktemp)
+trap 'kill $server 2>/dev/null; rm -f $log' EXIT
+
+# wait until the server listens
+tries=0
+while [ ! -S $IFCC_SOCKET ]; do
+    tries=$((tries + 1))
+    if [ $tries -gt 50 ] || ! kill -0 $server 2>/dev/null; then
+        echo "error: compile server did not start" >&2
+        exit 1
+    fi
+    sleep 0.1
+done
+
+if [ $# -eq 0 ]; then
+    set -- testfiles new_tests
+fi
+python3 ifcc-test.py --wrapper ifcc-wrapper-client.sh "$@" | tee $log
+! grep -q "TEST FAIL" $log
@@ -0,0 +1,18 @@
+int main() {
+    int somme = 0;
+    int produit = 1;
+    int i = 1;
+    int a = 1, b = 2, c = 3, d = 4, e = 5, f = 6, g = 7, h = 8;
+
+    while (i < 6) {
+        somme += i;
+        produit *= i;
+        somme = somme - 1;
+        a += b; b -= c; c *= 2; d += e;
+        e = f - e; f = g + f; g = h - g; h -= a;
+        i = i + 1;
+    }
+    somme /= 2;
+
+    return somme + produit + a + b + c + d + e + f + g + h;
+}
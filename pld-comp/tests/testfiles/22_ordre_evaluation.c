@@ -0,0 +1,13 @@
+int trace(int c) {
+    putchar(c);
+    return c;
+}
+
+int main() {
+    int a = 3, b = 5, c = 7, d = 11, e = 13;
+    int x = a - (b * (c - (d * (e - (a * (b - c))))));
+    int y = ((a + b) * (c + d)) - ((e - a) * (b + c * (d - e)));
+    int z = trace(65) - trace(66) * (a + b * c);
+    putchar(10);
+    return x + y + z;
+}
@@ -0,0 +1,14 @@
+int poids(int a, int b, int c, int d, int e, int f, int g, int h) {
+    return ((((((a * 3 + b) * 3 + c) * 3 + d) * 3 + e) * 3 + f) * 3 + g) * 3 + h;
+}
+
+int echange(int a, int b, int c, int d, int e, int f, int g) {
+    return poids(b, a, d, c, f, e, g, a);
+}
+
+int main() {
+    int x = poids(1, 2, 3, 4, 5, 6, 7, 8);
+    int y = poids(8, 7, 6, 5, 4, 3, 2, 1);
+    int z = echange(1, 2, 3, 4, 5, 6, 7);
+    return (x ^ y ^ z) % 256;
+}
@@ -0,0 +1,34 @@
+#include <stdio.h>
+
+#define BASE 40
+#define CARRE(x) ((x) * (x))
+#define SOMME(a, b) ((a) + (b))
+#define VIDE
+
+#if defined(BASE) && BASE > 10
+#define CHIFFRE(n) ('0' + (n))
+#else
+#define CHIFFRE(n) ('?')
+#endif
+
+#ifdef INCONNU
+ceci n'est pas du C
+#elif SOMME(1, 2) == 3
+int choix() { return 1; }
+#else
+int choix() { return 2; }
+#endif
+
+#undef VIDE
+#ifndef VIDE
+#define VIDE
+#endif
+
+int main()
+{
+    int x = CARRE(SOMME(1, 2)) VIDE;
+    putchar(CHIFFRE(choix()));
+    putchar(CHIFFRE(x));
+    putchar(10);
+    return BASE + x - choix();
+}
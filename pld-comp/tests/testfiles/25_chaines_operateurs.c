@@ -0,0 +1,28 @@
+#include <stdio.h>
+
+int trace(int n)
+{
+    putchar('0' + n);
+    return n;
+}
+
+int main()
+{
+    int a = 7;
+    int b = 3;
+    int c = 2;
+
+    // Chaînes associatives mises à plat, avec des opérandes de tailles variées
+    int somme = a + b * c + (a - b) + c * (a + b * c) + 1;
+    int produit = a * (b + 1) * c * (c - 1);
+    int bits = (a | 8) | b | (c & 3) ^ (a ^ b ^ c);
+
+    // Les effets de bord gardent l'ordre du source
+    int ordre = trace(1) + trace(2) * 3 + trace(3);
+    putchar(10);
+
+    // Opérateurs non associatifs : l'ordre des opérandes est conservé
+    int diff = a - b - c - (a - (b - c));
+
+    return (somme + produit + bits + ordre + diff) & 255;
+}